@@ -24,9 +24,12 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <mutex>
+#include <set>
 #include <utility>
 #include <iterator>
 
@@ -47,11 +50,13 @@
 #include <glm/ext.hpp>
 
 #include "common.h"
+#include "parallel_for.h"
 #include "3d_cache.h"
 #include "3d_info.h"
 #include "sg/scenegraph.h"
 #include "filename_resolver.h"
 #include "3d_plugin_manager.h"
+#include "3d_model_file.h"
 #include "plugins/3dapi/ifsg_api.h"
 
 
@@ -59,6 +64,9 @@
 
 static wxCriticalSection lock3D_cache;
 
+// writing a cache file renumbers the node names of the whole library, one file at a time
+static std::mutex lock3D_cacheFiles;
+
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 {
@@ -70,14 +78,26 @@ static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 }
 
 
-static bool checkTag( const char* aTag, void* aPluginMgrPtr )
+// what checkTag() needs: the plugins, and the entry which keeps the tag of the cache file
+struct CACHE_TAG_CHECK
 {
-    if( NULL == aTag || NULL == aPluginMgrPtr )
+    S3D_PLUGIN_MANAGER* plugins;
+    std::string*        pluginInfo;
+};
+
+
+static bool checkTag( const char* aTag, void* aTagCheckPtr )
+{
+    if( NULL == aTag || NULL == aTagCheckPtr )
         return false;
 
-    S3D_PLUGIN_MANAGER *pp = (S3D_PLUGIN_MANAGER*) aPluginMgrPtr;
+    CACHE_TAG_CHECK* tc = (CACHE_TAG_CHECK*) aTagCheckPtr;
+
+    if( !tc->plugins->CheckTag( aTag ) )
+        return false;
 
-    return pp->CheckTag( aTag );
+    *tc->pluginInfo = aTag;
+    return true;
 }
 
 
@@ -131,11 +151,15 @@ public:
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName( void );
 
+    // free the render data, whether it was built or mapped from a model file
+    void FreeRenderData( void );
+
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    S3D_MODEL_FILE* modelFile;  // the file renderData is mapped from, if any
 };
 
 
@@ -143,6 +167,7 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = NULL;
     renderData = NULL;
+    modelFile = NULL;
     memset( sha1sum, 0, 20 );
 }
 
@@ -152,8 +177,22 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
     if( NULL != sceneData )
         delete sceneData;
 
-    if( NULL != renderData )
+    FreeRenderData();
+}
+
+
+void S3D_CACHE_ENTRY::FreeRenderData( void )
+{
+    if( NULL != modelFile )
+    {
+        delete modelFile;
+        modelFile = NULL;
+        renderData = NULL;
+    }
+    else if( NULL != renderData )
+    {
         S3D::Destroy3DModel( &renderData );
+    }
 }
 
 
@@ -205,7 +244,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aNeedScene )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -255,13 +295,16 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
                     mi->second->sceneData = NULL;
                 }
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+                mi->second->FreeRenderData();
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+                loadEntry( full3Dpath, mi->second, aNeedScene );
             }
         }
 
+        // the entry may only have the render data, mapped from its model file
+        if( aNeedScene && NULL == mi->second->sceneData && NULL != mi->second->modelFile )
+            loadEntry( full3Dpath, mi->second, true );
+
         if( NULL != aCachePtr )
             *aCachePtr = mi->second;
 
@@ -269,7 +312,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
     }
 
     // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return checkCache( full3Dpath, aCachePtr, aNeedScene );
 }
 
 
@@ -279,7 +322,8 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr,
+                                   bool aNeedScene )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -336,18 +380,124 @@ SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY**
 
     ep->SetSHA1( sha1sum );
 
-    wxString bname = ep->GetCacheBaseName();
+    return loadEntry( aFileName, ep, aNeedScene );
+}
+
+
+SCENEGRAPH* S3D_CACHE::loadEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                                  bool aNeedScene )
+{
+    // the renderers only need the meshes, used in place from the model file
+    if( !aNeedScene && loadModelData( aCacheItem ) )
+        return NULL;
+
+    wxString bname = aCacheItem->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return aCacheItem->sceneData;
+
+    aCacheItem->sceneData = m_Plugins->Load3DModel( aFileName, aCacheItem->pluginInfo );
+
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
+
+    return aCacheItem->sceneData;
+}
+
+
+void S3D_CACHE::Preload( const std::vector< wxString >& aModelFiles )
+{
+    if( m_CacheDir.empty() )
+        return;     // nothing to share between the loads; Load() will do
+
+    // the files not loaded yet, each listed once
+    std::vector< wxString > files;
+    std::set< wxString > seen;
+
+    for( const wxString& modelFile : aModelFiles )
+    {
+        wxString full3Dpath = m_FNResolver->ResolvePath( modelFile );
+
+        if( full3Dpath.empty() || !seen.insert( full3Dpath ).second )
+            continue;
+
+        wxCriticalSectionLocker lock( lock3D_cache );
+
+        if( m_CacheMap.find( full3Dpath ) == m_CacheMap.end() )
+            files.push_back( full3Dpath );
+    }
+
+    if( files.empty() )
+        return;
+
+    // the hashes are the slow part for big models found in the disk cache
+    struct PRELOAD_ITEM
+    {
+        unsigned char    sha1sum[20];
+        bool             hashed;
+        wxDateTime       modTime;
+        S3D_CACHE_ENTRY* entry;
+    };
+
+    std::vector< PRELOAD_ITEM > items( files.size() );
+
+    ParallelFor( files.size(), [&]( size_t aIdx )
+    {
+        items[aIdx].hashed = getSHA1( files[aIdx], items[aIdx].sha1sum );
+        items[aIdx].modTime = wxFileName( files[aIdx] ).GetModificationTime();
+        items[aIdx].entry = NULL;
+    } );
+
+    wxCriticalSectionLocker lock( lock3D_cache );
+
+    // files with the same contents are only loaded once, by the first of them (the
+    // leader); the others then read the cache file the leader wrote
+    std::vector< size_t > leaders;
+    std::vector< size_t > followers;
+    std::map< wxString, size_t > firstOfHash;
+
+    for( size_t ii = 0; ii < files.size(); ++ii )
+    {
+        // unreadable files are left to Load(), which records them as not loadable
+        if( !items[ii].hashed || m_CacheMap.find( files[ii] ) != m_CacheMap.end() )
+            continue;
+
+        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
+        ep->modTime = items[ii].modTime;
+        ep->SetSHA1( items[ii].sha1sum );
+
+        m_CacheList.push_back( ep );
+        m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( files[ii], ep ) );
+        items[ii].entry = ep;
+
+        if( firstOfHash.insert( std::make_pair( ep->GetCacheBaseName(), ii ) ).second )
+            leaders.push_back( ii );
+        else
+            followers.push_back( ii );
+    }
+
+    auto loadItems = [&]( const std::vector< size_t >& aItems )
+    {
+        ParallelFor( aItems.size(), [&]( size_t aIdx )
+        {
+            size_t ii = aItems[aIdx];
+            S3D_CACHE_ENTRY* ep = items[ii].entry;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+            loadEntry( files[ii], ep, false );
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+            if( ep->sceneData && !ep->renderData )
+            {
+                ep->renderData = S3D::GetModel( ep->sceneData );
 
-    return ep->sceneData;
+                if( ep->renderData )
+                    saveModelData( ep );
+            }
+        } );
+    };
+
+    loadItems( leaders );
+    loadItems( followers );
 }
 
 
@@ -439,7 +589,10 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( NULL != aCacheItem->sceneData )
         S3D::DestroyNode( (SGNODE*) aCacheItem->sceneData );
 
-    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), m_Plugins, checkTag );
+    // keep the tag, the model file written from this scene needs it
+    CACHE_TAG_CHECK tagCheck = { m_Plugins, &aCacheItem->pluginInfo };
+
+    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), &tagCheck, checkTag );
 
     if( NULL == aCacheItem->sceneData )
         return false;
@@ -497,11 +650,69 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         }
     }
 
+    std::lock_guard<std::mutex> lock( lock3D_cacheFiles );
+
     return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData,
         aCacheItem->pluginInfo.c_str() );
 }
 
 
+bool S3D_CACHE::loadModelData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dm" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    S3D_MODEL_FILE* modelFile = new S3D_MODEL_FILE;
+
+    // a file written by another version of the plugin is rebuilt from the model
+    if( !modelFile->Open( fname ) || !m_Plugins->CheckTag( modelFile->GetPluginInfo().c_str() ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] stale model file '%s'", fname );
+        delete modelFile;
+        return false;
+    }
+
+    aCacheItem->FreeRenderData();
+    aCacheItem->modelFile = modelFile;
+    aCacheItem->renderData = modelFile->GetModel();
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveModelData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( NULL == aCacheItem->renderData || aCacheItem->pluginInfo.empty() || bname.empty()
+            || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dm" );
+
+    // copies of a model share their model file
+    std::lock_guard<std::mutex> lock( lock3D_cacheFiles );
+
+    // a stale file is replaced
+    if( wxFileName::FileExists( fname ) )
+    {
+        S3D_MODEL_FILE modelFile;
+
+        if( modelFile.Open( fname ) && m_Plugins->CheckTag( modelFile.GetPluginInfo().c_str() ) )
+            return true;
+    }
+
+    return S3D_MODEL_FILE::Write( fname, *aCacheItem->renderData, aCacheItem->pluginInfo );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -725,7 +936,11 @@ void S3D_CACHE::ClosePlugins( void )
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
+    SCENEGRAPH* sp = load( aModelFileName, &cp, false );
+
+    // mapped from the model file, or built before
+    if( cp && cp->renderData )
+        return cp->renderData;
 
     if( !sp )
         return NULL;
@@ -739,12 +954,12 @@ S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
         return NULL;
     }
 
-    if( cp->renderData )
-        return cp->renderData;
-
     S3DMODEL* mp = S3D::GetModel( sp );
     cp->renderData = mp;
 
+    if( mp )
+        saveModelData( cp );
+
     return mp;
 }
 
@@ -765,7 +980,7 @@ wxString S3D_CACHE::GetModelHash( const wxString& aModelFileName )
 
     // a cache item does not exist; search the Filename->Cachename map
     S3D_CACHE_ENTRY* cp = NULL;
-    checkCache( full3Dpath, &cp );
+    checkCache( full3Dpath, &cp, false );
 
     if( NULL != cp )
         return cp->GetCacheBaseName();
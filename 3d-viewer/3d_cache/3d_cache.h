@@ -31,6 +31,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <wx/string.h>
 #include "kicad_string.h"
 #include "filename_resolver.h"
@@ -81,10 +82,12 @@ private:
      *
      * @param[in]   aFileName   file name (full or partial path)
      * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aNeedScene  false if only the render data is needed (see loadEntry)
      * @return      SCENEGRAPH object associated with file name
      * @retval      NULL    on error
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                            bool aNeedScene = true );
 
     /**
      * Function getSHA1
@@ -97,14 +100,37 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    /**
+     * Function loadEntry
+     * loads the scene data of a new cache entry, from its cache file if there is one,
+     * otherwise with the plugins (and then writes the cache file).  It does not use the
+     * cache list, so it can run for several entries at the same time.
+     *
+     * @param aFileName is the full path of the model
+     * @param aCacheItem is the entry of the model, with its SHA1 set
+     * @param aNeedScene is false if only the render data is needed; it is then mapped
+     * from the model file when there is one, and no scene data is loaded
+     * @return the scene data of the entry, NULL if the model could not be loaded or
+     * only its render data was
+     */
+    SCENEGRAPH* loadEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                           bool aNeedScene = true );
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
+    // map the render data from a model file (the flattened meshes, see S3D_MODEL_FILE)
+    bool loadModelData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save the render data to a model file
+    bool saveModelData( S3D_CACHE_ENTRY* aCacheItem );
+
     // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aNeedScene = true );
 
 public:
     S3D_CACHE();
@@ -167,6 +193,17 @@ public:
      */
     SCENEGRAPH* Load( const wxString& aModelFile );
 
+    /**
+     * Function Preload
+     * loads the models not in the cache yet, all at the same time, so the following
+     * calls to Load() or GetModel() find them in the cache.  Files with the same contents
+     * are only read by a plugin once.
+     *
+     * @param aModelFiles [in] are the partial or full paths to the models, e.g. those of
+     * all the footprints of a board; duplicates are ignored
+     */
+    void Preload( const std::vector< wxString >& aModelFiles );
+
     FILENAME_RESOLVER* GetResolver( void );
 
     /**
@@ -0,0 +1,398 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <wx/filefn.h>
+#include <wx/log.h>
+
+#include "3d_model_file.h"
+
+
+#define MASK_3D_CACHE "3D_CACHE"
+
+/*
+ * The file is the S3DMODEL arrays as they are in memory, so it can be used in place:
+ *
+ *   MODEL_FILE_HEADER, with the tag of the plugin which read the model
+ *   MODEL_FILE_MESH[meshesSize]
+ *   SMATERIAL[materialsSize]
+ *   for each mesh: positions, normals, texcoords, colors and face indexes
+ *
+ * All the offsets are from the start of the file, and aligned on 8 bytes.  The file is
+ * only read by the machine that wrote it (it lives in the user's cache directory), so the
+ * byte order is only checked, not converted.
+ */
+
+static const char     MODEL_FILE_MAGIC[8] = { 'K', 'I', 'C', 'A', 'D', '3', 'D', 'M' };
+static const uint32_t MODEL_FILE_VERSION = 2;
+static const uint32_t MODEL_FILE_BYTE_ORDER = 0x01020304;
+
+struct MODEL_FILE_HEADER
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint32_t meshesSize;
+    uint32_t materialsSize;
+    uint64_t materials;
+    char     pluginInfo[128];   // PluginName:Version of the plugin which read the model
+};
+
+struct MODEL_FILE_MESH
+{
+    uint32_t vertexSize;
+    uint32_t faceIdxSize;
+    uint32_t materialIdx;
+    uint32_t reserved;
+    uint64_t positions;     // the offsets are 0 for the missing arrays
+    uint64_t normals;
+    uint64_t texcoords;
+    uint64_t colors;
+    uint64_t faceIdx;
+};
+
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ) && sizeof( SFVEC2F ) == 2 * sizeof( float ),
+               "the model file arrays are written as they are in memory" );
+
+
+static uint64_t align8( uint64_t aOffset )
+{
+    return ( aOffset + 7 ) & ~(uint64_t) 7;
+}
+
+
+/**
+ * Check that an array of the mapped file is inside the file
+ */
+static bool isInFile( uint64_t aOffset, uint64_t aCount, uint64_t aItemSize, uint64_t aFileSize )
+{
+    return aOffset % 4 == 0 && aOffset <= aFileSize && aCount * aItemSize <= aFileSize - aOffset;
+}
+
+
+S3D_MODEL_FILE::S3D_MODEL_FILE()
+{
+    m_data = NULL;
+    m_size = 0;
+    m_model = {};
+}
+
+
+S3D_MODEL_FILE::~S3D_MODEL_FILE()
+{
+    close();
+}
+
+
+void S3D_MODEL_FILE::close( void )
+{
+    if( m_data )
+    {
+#ifdef _WIN32
+        UnmapViewOfFile( m_data );
+#else
+        munmap( m_data, m_size );
+#endif
+    }
+
+    m_data = NULL;
+    m_size = 0;
+    m_model = {};
+    m_meshes.clear();
+    m_pluginInfo.clear();
+}
+
+
+bool S3D_MODEL_FILE::Open( const wxString& aFileName )
+{
+    close();
+
+    // the pages are mapped copy on write, so a renderer changing the model cannot
+    // change the file
+#ifdef _WIN32
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+
+    if( file == INVALID_HANDLE_VALUE )
+        return false;
+
+    LARGE_INTEGER fileSize;
+    HANDLE        mapping = NULL;
+
+    if( GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart > 0 )
+        mapping = CreateFileMappingW( file, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+
+    CloseHandle( file );
+
+    if( mapping == NULL )
+        return false;
+
+    // the view keeps the mapping open
+    m_data = (char*) MapViewOfFile( mapping, FILE_MAP_COPY, 0, 0, 0 );
+    m_size = (size_t) fileSize.QuadPart;
+    CloseHandle( mapping );
+
+    if( m_data == NULL )
+    {
+        m_size = 0;
+        return false;
+    }
+#else
+    int fd = open( aFileName.ToUTF8(), O_RDONLY );
+
+    if( fd < 0 )
+        return false;
+
+    struct stat fileStat;
+    void*       data = MAP_FAILED;
+
+    if( fstat( fd, &fileStat ) == 0 && fileStat.st_size > 0 )
+    {
+        data = mmap( NULL, fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    }
+
+    ::close( fd );
+
+    if( data == MAP_FAILED )
+        return false;
+
+    m_data = (char*) data;
+    m_size = fileStat.st_size;
+#endif
+
+    // check everything the renderers rely on, the file may be truncated or from
+    // another version
+    MODEL_FILE_HEADER header;
+
+    if( m_size < sizeof( header ) )
+    {
+        close();
+        return false;
+    }
+
+    memcpy( &header, m_data, sizeof( header ) );
+
+    if( memcmp( header.magic, MODEL_FILE_MAGIC, sizeof( header.magic ) ) != 0
+            || header.version != MODEL_FILE_VERSION
+            || header.byteOrder != MODEL_FILE_BYTE_ORDER
+            || header.fileSize != m_size
+            || !isInFile( sizeof( header ), header.meshesSize, sizeof( MODEL_FILE_MESH ), m_size )
+            || !isInFile( header.materials, header.materialsSize, sizeof( SMATERIAL ), m_size )
+            || !memchr( header.pluginInfo, 0, sizeof( header.pluginInfo ) ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid model file '%s'", aFileName );
+        close();
+        return false;
+    }
+
+    m_meshes.resize( header.meshesSize );
+
+    for( unsigned int i = 0; i < header.meshesSize; ++i )
+    {
+        MODEL_FILE_MESH fileMesh;
+        memcpy( &fileMesh, m_data + sizeof( header ) + i * sizeof( fileMesh ), sizeof( fileMesh ) );
+
+        const uint64_t nv = fileMesh.vertexSize;
+
+        bool valid = fileMesh.materialIdx < header.materialsSize
+                     && fileMesh.faceIdxSize % 3 == 0
+                     && fileMesh.positions && fileMesh.normals && fileMesh.faceIdx
+                     && isInFile( fileMesh.positions, nv, sizeof( SFVEC3F ), m_size )
+                     && isInFile( fileMesh.normals, nv, sizeof( SFVEC3F ), m_size )
+                     && isInFile( fileMesh.texcoords, nv, sizeof( SFVEC2F ), m_size )
+                     && isInFile( fileMesh.colors, nv, sizeof( SFVEC3F ), m_size )
+                     && isInFile( fileMesh.faceIdx, fileMesh.faceIdxSize, sizeof( unsigned int ),
+                                  m_size );
+
+        SMESH& mesh = m_meshes[i];
+
+        mesh.m_VertexSize = fileMesh.vertexSize;
+        mesh.m_Positions = (SFVEC3F*) ( m_data + fileMesh.positions );
+        mesh.m_Normals = (SFVEC3F*) ( m_data + fileMesh.normals );
+        mesh.m_Texcoords = fileMesh.texcoords ? (SFVEC2F*) ( m_data + fileMesh.texcoords ) : NULL;
+        mesh.m_Color = fileMesh.colors ? (SFVEC3F*) ( m_data + fileMesh.colors ) : NULL;
+        mesh.m_FaceIdxSize = fileMesh.faceIdxSize;
+        mesh.m_FaceIdx = (unsigned int*) ( m_data + fileMesh.faceIdx );
+        mesh.m_MaterialIdx = fileMesh.materialIdx;
+
+        for( unsigned int j = 0; valid && j < mesh.m_FaceIdxSize; ++j )
+            valid = mesh.m_FaceIdx[j] < mesh.m_VertexSize;
+
+        if( !valid )
+        {
+            wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid mesh in model file '%s'",
+                        aFileName );
+            close();
+            return false;
+        }
+    }
+
+    m_model.m_MeshesSize = header.meshesSize;
+    m_model.m_Meshes = m_meshes.empty() ? NULL : m_meshes.data();
+    m_model.m_MaterialsSize = header.materialsSize;
+    m_model.m_Materials = (SMATERIAL*) ( m_data + header.materials );
+    m_pluginInfo = header.pluginInfo;
+
+    return true;
+}
+
+
+bool S3D_MODEL_FILE::Write( const wxString& aFileName, const S3DMODEL& aModel,
+                            const std::string& aPluginInfo )
+{
+    // lay out the file
+    MODEL_FILE_HEADER header = {};
+    std::vector< MODEL_FILE_MESH > fileMeshes( aModel.m_MeshesSize );
+
+    // the tag is kept with its terminating NUL
+    if( aPluginInfo.empty() || aPluginInfo.size() >= sizeof( header.pluginInfo ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid plugin tag, not writing '%s'",
+                    aFileName );
+        return false;
+    }
+
+    memcpy( header.magic, MODEL_FILE_MAGIC, sizeof( header.magic ) );
+    memcpy( header.pluginInfo, aPluginInfo.c_str(), aPluginInfo.size() + 1 );
+    header.version = MODEL_FILE_VERSION;
+    header.byteOrder = MODEL_FILE_BYTE_ORDER;
+    header.meshesSize = aModel.m_MeshesSize;
+    header.materialsSize = aModel.m_MaterialsSize;
+
+    uint64_t offset = sizeof( header ) + fileMeshes.size() * sizeof( MODEL_FILE_MESH );
+    header.materials = align8( offset );
+    offset = header.materials + (uint64_t) aModel.m_MaterialsSize * sizeof( SMATERIAL );
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH&     mesh = aModel.m_Meshes[i];
+        MODEL_FILE_MESH& fileMesh = fileMeshes[i];
+        const uint64_t   nv = mesh.m_VertexSize;
+
+        if( NULL == mesh.m_Positions || NULL == mesh.m_Normals || NULL == mesh.m_FaceIdx )
+        {
+            wxLogTrace( MASK_3D_CACHE, " * [3D model] incomplete mesh, not writing '%s'",
+                        aFileName );
+            return false;
+        }
+
+        fileMesh = {};
+        fileMesh.vertexSize = mesh.m_VertexSize;
+        fileMesh.faceIdxSize = mesh.m_FaceIdxSize;
+        fileMesh.materialIdx = mesh.m_MaterialIdx;
+
+        fileMesh.positions = align8( offset );
+        offset = fileMesh.positions + nv * sizeof( SFVEC3F );
+        fileMesh.normals = align8( offset );
+        offset = fileMesh.normals + nv * sizeof( SFVEC3F );
+
+        if( mesh.m_Texcoords )
+        {
+            fileMesh.texcoords = align8( offset );
+            offset = fileMesh.texcoords + nv * sizeof( SFVEC2F );
+        }
+
+        if( mesh.m_Color )
+        {
+            fileMesh.colors = align8( offset );
+            offset = fileMesh.colors + nv * sizeof( SFVEC3F );
+        }
+
+        fileMesh.faceIdx = align8( offset );
+        offset = fileMesh.faceIdx + (uint64_t) mesh.m_FaceIdxSize * sizeof( unsigned int );
+    }
+
+    header.fileSize = offset;
+
+    std::vector< char > buffer( offset, 0 );
+
+    auto put = [&buffer]( uint64_t aOffset, const void* aData, uint64_t aSize )
+    {
+        if( aSize )
+            memcpy( buffer.data() + aOffset, aData, aSize );
+    };
+
+    put( 0, &header, sizeof( header ) );
+    put( sizeof( header ), fileMeshes.data(), fileMeshes.size() * sizeof( MODEL_FILE_MESH ) );
+    put( header.materials, aModel.m_Materials,
+         (uint64_t) aModel.m_MaterialsSize * sizeof( SMATERIAL ) );
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH&           mesh = aModel.m_Meshes[i];
+        const MODEL_FILE_MESH& fileMesh = fileMeshes[i];
+        const uint64_t         nv = mesh.m_VertexSize;
+
+        put( fileMesh.positions, mesh.m_Positions, nv * sizeof( SFVEC3F ) );
+        put( fileMesh.normals, mesh.m_Normals, nv * sizeof( SFVEC3F ) );
+
+        if( mesh.m_Texcoords )
+            put( fileMesh.texcoords, mesh.m_Texcoords, nv * sizeof( SFVEC2F ) );
+
+        if( mesh.m_Color )
+            put( fileMesh.colors, mesh.m_Color, nv * sizeof( SFVEC3F ) );
+
+        put( fileMesh.faceIdx, mesh.m_FaceIdx,
+             (uint64_t) mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    // write a temporary file and rename it, so that no reader ever maps a partial file
+    wxString tmpName = aFileName + wxT( ".tmp" );
+
+    #ifdef _WIN32
+    FILE* fp = _wfopen( tmpName.wc_str(), L"wb" );
+    #else
+    FILE* fp = fopen( tmpName.ToUTF8(), "wb" );
+    #endif
+
+    if( NULL == fp )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write model file '%s'", tmpName );
+        return false;
+    }
+
+    bool written = fwrite( buffer.data(), 1, buffer.size(), fp ) == buffer.size();
+    written = ( fclose( fp ) == 0 ) && written;
+
+    if( !written || !wxRenameFile( tmpName, aFileName, true ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write model file '%s'", aFileName );
+        wxRemoveFile( tmpName );
+        return false;
+    }
+
+    return true;
+}
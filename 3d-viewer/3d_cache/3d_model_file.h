@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_model_file.h
+ * reads and writes the render data of a 3D model as a flat binary file, which is
+ * mapped in memory and used in place
+ */
+
+#ifndef MODEL_FILE_3D_H
+#define MODEL_FILE_3D_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <wx/string.h>
+#include "plugins/3dapi/c3dmodel.h"
+
+
+class S3D_MODEL_FILE
+{
+private:
+    // prohibit assignment and default copy constructor
+    S3D_MODEL_FILE( const S3D_MODEL_FILE& source );
+    S3D_MODEL_FILE& operator=( const S3D_MODEL_FILE& source );
+
+    /// the mapped file
+    char* m_data;
+    size_t m_size;
+
+    /// the model, its arrays point in the mapped file
+    S3DMODEL m_model;
+    std::vector< SMESH > m_meshes;
+
+    /// the tag of the plugin which read the model
+    std::string m_pluginInfo;
+
+    void close( void );
+
+public:
+    S3D_MODEL_FILE();
+    ~S3D_MODEL_FILE();
+
+    /**
+     * Function Open
+     * maps a model file in memory and checks it
+     *
+     * @param aFileName is the full path of the model file
+     * @return true if the file is a valid model file of this version
+     */
+    bool Open( const wxString& aFileName );
+
+    /**
+     * Function GetModel
+     * returns the model of the file, valid until the object is deleted; its arrays
+     * are copied on write, so they must not be freed with S3D::Destroy3DModel()
+     */
+    S3DMODEL* GetModel( void ) { return m_data ? &m_model : NULL; }
+
+    /**
+     * Function GetPluginInfo
+     * returns the PluginName:Version tag of the plugin which read the model, to be
+     * checked against the loaded plugins before the model is used
+     */
+    const std::string& GetPluginInfo( void ) const { return m_pluginInfo; }
+
+    /**
+     * Function Write
+     * writes a model to a file readable by Open()
+     *
+     * @param aFileName is the full path of the model file
+     * @param aModel is the model to write
+     * @param aPluginInfo is the PluginName:Version tag of the plugin which read the model
+     * @return true on success
+     */
+    static bool Write( const wxString& aFileName, const S3DMODEL& aModel,
+                       const std::string& aPluginInfo );
+};
+
+#endif  // MODEL_FILE_3D_H
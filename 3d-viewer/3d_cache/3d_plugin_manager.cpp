@@ -110,6 +110,7 @@ S3D_PLUGIN_MANAGER::~S3D_PLUGIN_MANAGER()
     }
 
     m_Plugins.clear();
+    m_PluginLocks.clear();
     return;
 }
 
@@ -233,6 +234,7 @@ void S3D_PLUGIN_MANAGER::loadPlugins( void )
             } while( 0 );
 #endif
             m_Plugins.push_back( pp );
+            m_PluginLocks[pp];      // creates the lock of the plugin
             int nf = pp->GetNFilters();
 
             #ifdef DEBUG
@@ -500,6 +502,8 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
 
     while( sL != items.second )
     {
+        std::lock_guard<std::mutex> lock( m_PluginLocks.at( sL->second ) );
+
         if( sL->second->CanRender() )
         {
             SCENEGRAPH* sp = sL->second->Load( aFileName.ToUTF8() );
@@ -565,7 +569,11 @@ bool S3D_PLUGIN_MANAGER::CheckTag( const char* aTag )
     while( pS != pE )
     {
         ptag.clear();
-        (*pS)->GetPluginInfo( ptag );
+
+        {
+            std::lock_guard<std::mutex> lock( m_PluginLocks.at( *pS ) );
+            (*pS)->GetPluginInfo( ptag );
+        }
 
         // if the plugin name matches then the version
         // must also match
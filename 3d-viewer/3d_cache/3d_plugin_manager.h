@@ -31,6 +31,7 @@
 
 #include <map>
 #include <list>
+#include <mutex>
 #include <string>
 #include <wx/string.h>
 
@@ -50,6 +51,10 @@ private:
     /// list of file filters
     std::list< wxString > m_FileFilters;
 
+    /// one lock per plugin: the plugins are not required to be thread-safe, so
+    /// each plugin loads one model at a time, while different plugins run in parallel
+    std::map< KICAD_PLUGIN_LDR_3D*, std::mutex > m_PluginLocks;
+
     /// load plugins
     void loadPlugins( void );
 
@@ -82,6 +87,11 @@ public:
      */
     std::list< wxString > const* GetFileFilters( void ) const;
 
+    /**
+     * Function Load3DModel
+     * loads a model with the first plugin supporting its extension which succeeds.
+     * It can be called from several threads.
+     */
     SCENEGRAPH* Load3DModel( const wxString& aFileName, std::string& aPluginInfo );
 
     /**
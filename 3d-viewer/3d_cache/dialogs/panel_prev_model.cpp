@@ -68,6 +68,7 @@ PANEL_PREV_3D::PANEL_PREV_3D( wxWindow* aParent, PCB_BASE_FRAME* aFrame, MODULE*
 PANEL_PREV_3D::~PANEL_PREV_3D()
 {
     delete m_settings3Dviewer;
+    CINFO3D_VISU::ReleaseParkedLayers( m_dummyBoard );
     delete m_dummyBoard;
     delete m_previewPane;
 }
@@ -44,6 +44,20 @@
 const wxChar *CINFO3D_VISU::m_logTrace = wxT( "KI_TRACE_EDA_CINFO3D_VISU" );
 
 
+/**
+ * Holds the layers of the last closed viewer, until the next viewer uses them (when it
+ * shows the same board revision, see InitSettings), other layers are closed or their
+ * board is modified or deleted (see ReleaseParkedLayers).
+ */
+static struct PARKED_LAYERS
+{
+    CINFO3D_VISU* m_visu = nullptr;
+    const BOARD*  m_board = nullptr;    ///< the board the layers were built from
+
+    ~PARKED_LAYERS() { delete m_visu; }
+} s_parkedLayers;
+
+
 CINFO3D_VISU G_null_CINFO3D_VISU;
 
 
@@ -88,6 +102,10 @@ CINFO3D_VISU::CINFO3D_VISU() :
     m_calc_seg_min_factor3DU = 0.0f;
     m_calc_seg_max_factor3DU = 0.0f;
 
+    m_layersKey.m_boardRevision = 0;
+    m_layersKey.m_zones = false;
+    m_layersKey.m_copperPolys = false;
+
 
     memset( m_layerZcoordTop, 0, sizeof( m_layerZcoordTop ) );
     memset( m_layerZcoordBottom, 0, sizeof( m_layerZcoordBottom ) );
@@ -115,6 +133,18 @@ CINFO3D_VISU::CINFO3D_VISU() :
 
 CINFO3D_VISU::~CINFO3D_VISU()
 {
+    // Keep the layers, the viewer may be opened again on the same board
+    if( m_layersKey.m_boardRevision && this != s_parkedLayers.m_visu )
+    {
+        CINFO3D_VISU* parked = new CINFO3D_VISU;
+        parked->swapLayers( *this );
+
+        ReleaseParkedLayers( s_parkedLayers.m_board );
+
+        s_parkedLayers.m_visu = parked;
+        s_parkedLayers.m_board = m_board;
+    }
+
     destroyLayers();
 }
 
@@ -417,6 +447,25 @@ void CINFO3D_VISU::InitSettings( REPORTER *aStatusTextReporter )
 
     m_boardBoundingBox = CBBOX( boardMin, boardMax );
 
+    // The board body and the layers are kept while the board and the settings they use
+    // do not change, e.g. when only the render engine or the colors are changed
+    const LAYERS_KEY layersKey = makeLayersKey();
+
+    if( s_parkedLayers.m_visu && !layersMatch( m_layersKey, layersKey ) )
+    {
+        if( layersMatch( s_parkedLayers.m_visu->m_layersKey, layersKey ) )
+            swapLayers( *s_parkedLayers.m_visu );
+
+        // The parked layers are used now, or outdated
+        ReleaseParkedLayers( s_parkedLayers.m_board );
+    }
+
+    if( layersMatch( m_layersKey, layersKey ) )
+    {
+        wxLogTrace( m_logTrace, wxT( "CINFO3D_VISU::InitSettings: the layers are up to date" ) );
+        return;
+    }
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_startCreateBoardPolyTime = GetRunningMicroSecs();
 #endif
@@ -436,6 +485,8 @@ void CINFO3D_VISU::InitSettings( REPORTER *aStatusTextReporter )
 
     createLayers( aStatusTextReporter );
 
+    m_layersKey = layersKey;
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_stopCreateLayersTime = GetRunningMicroSecs();
 
@@ -449,6 +500,58 @@ void CINFO3D_VISU::InitSettings( REPORTER *aStatusTextReporter )
 }
 
 
+void CINFO3D_VISU::InvalidateLayers()
+{
+    m_layersKey.m_boardRevision = 0;
+}
+
+
+void CINFO3D_VISU::ReleaseParkedLayers( const BOARD *aBoard )
+{
+    if( !s_parkedLayers.m_visu || s_parkedLayers.m_board != aBoard )
+        return;
+
+    // Not built anymore, so its destructor does not park them again
+    s_parkedLayers.m_visu->m_layersKey.m_boardRevision = 0;
+    delete s_parkedLayers.m_visu;
+
+    s_parkedLayers.m_visu = nullptr;
+    s_parkedLayers.m_board = nullptr;
+}
+
+
+CINFO3D_VISU::LAYERS_KEY CINFO3D_VISU::makeLayersKey() const
+{
+    LAYERS_KEY key;
+
+    key.m_boardRevision = m_board->GetRevision();
+    key.m_enabledLayers.resize( PCB_LAYER_ID_COUNT );
+
+    for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+        key.m_enabledLayers[layer] = Is3DLayerEnabled( ToLAYER_ID( layer ) );
+
+    key.m_zones = GetFlag( FL_ZONE );
+    key.m_copperPolys = GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
+                        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY);
+
+    return key;
+}
+
+
+bool CINFO3D_VISU::layersMatch( const LAYERS_KEY &aBuilt, const LAYERS_KEY &aWanted ) const
+{
+    if( !aBuilt.m_boardRevision || aBuilt.m_boardRevision != aWanted.m_boardRevision )
+        return false;
+
+    if( aBuilt.m_enabledLayers != aWanted.m_enabledLayers || aBuilt.m_zones != aWanted.m_zones )
+        return false;
+
+    // Only the OpenGL render uses the copper polygons, and it draws them when they are built
+    return aBuilt.m_copperPolys == aWanted.m_copperPolys ||
+           m_render_engine != RENDER_ENGINE_OPENGL_LEGACY;
+}
+
+
 void CINFO3D_VISU::createBoardPolygon()
 {
     m_board_poly.RemoveAllContours();
@@ -130,10 +130,27 @@ class CINFO3D_VISU
     /**
      * @brief InitSettings - Function to be called by the render when it need to
      * reload the settings for the board.
+     * The layers are only built again if the board was modified (see BOARD::GetRevision)
+     * or a setting they depend on changed since the last call. If this viewer has no layers
+     * yet, the ones of the last closed viewer are used when they match.
      * @param aStatusTextReporter: the pointer for the status reporter
      */
     void InitSettings( REPORTER *aStatusTextReporter );
 
+    /**
+     * @brief InvalidateLayers - Drop the layers built for the current board, so the next
+     * InitSettings builds them again (e.g. on a user requested reload)
+     */
+    void InvalidateLayers();
+
+    /**
+     * @brief ReleaseParkedLayers - Free the layers kept from the last closed viewer if they
+     * were built from aBoard. To be called when the board is modified or deleted, as the
+     * layers cannot be used again then
+     * @param aBoard: the board
+     */
+    static void ReleaseParkedLayers( const BOARD *aBoard );
+
     /**
      * @brief BiuTo3Dunits - Board integer units To 3D units
      * @return the conversion factor to transform a position from the board to 3d units
@@ -422,6 +439,35 @@ class CINFO3D_VISU
     void createLayers( REPORTER *aStatusTextReporter );
     void destroyLayers();
 
+    void createCopperLayer( PCB_LAYER_ID aLayerId,
+                            const std::vector< const TRACK *> &aTrackList,
+                            CBVHCONTAINER2D *aDstContainer,
+                            SHAPE_POLY_SET *aDstPoly );
+
+    void createTechLayer( PCB_LAYER_ID aLayerId,
+                          CBVHCONTAINER2D *aDstContainer,
+                          SHAPE_POLY_SET *aDstPoly );
+
+    /// Identifies the board revision and the settings the layers were built with
+    struct LAYERS_KEY
+    {
+        unsigned long long  m_boardRevision;    ///< 0 if the layers are not built
+        std::vector< bool > m_enabledLayers;
+        bool                m_zones;
+        bool                m_copperPolys;      ///< the copper layers have thickness polys
+    };
+
+    LAYERS_KEY makeLayersKey() const;
+
+    /**
+     * @brief layersMatch - Test if layers built with aBuilt can be used with the current
+     * settings, of which aWanted is the key
+     */
+    bool layersMatch( const LAYERS_KEY &aBuilt, const LAYERS_KEY &aWanted ) const;
+
+    /// Exchange the board polygon, layers, holes and statistics with aOther
+    void swapLayers( CINFO3D_VISU &aOther );
+
     // Helper functions to create the board
     COBJECT2D *createNewTrack( const TRACK* aTrack , int aClearanceValue ) const;
 
@@ -655,6 +701,9 @@ private:
     /// Computed medium diameter of the holes in 3D units
     float        m_stats_hole_med_diameter;
 
+    /// What the current layers were built for
+    LAYERS_KEY   m_layersKey;
+
     /**
      *  Trace mask used to enable or disable the trace output of this class.
      *  The debug output can be turned on by setting the WXTRACE environment variable to
@@ -56,31 +56,29 @@
 
 
 
-// These variables are parameters used in addTextSegmToContainer.
-// But addTextSegmToContainer is a call-back function,
-// so we cannot send them as arguments.
-static int s_textWidth;
-static CGENERICCONTAINER2D *s_dstcontainer = NULL;
-static float s_biuTo3Dunits;
-static const BOARD_ITEM *s_boardItem = NULL;
-
-// This is a call back function, used by GRText to draw the 3D text shape:
-void addTextSegmToContainer( int x0, int y0, int xf, int yf, void* aData )
+// Add the strokes of a text shape to aDstContainer, as segments of width aTextWidth
+static void addTextShapeToContainer( CGENERICCONTAINER2D* aDstContainer, const TEXT_SHAPE& aShape,
+                                     int aTextWidth, float aBiuTo3Dunits,
+                                     const BOARD_ITEM& aBoardItem )
 {
-    wxASSERT( s_dstcontainer != NULL );
-
-    const SFVEC2F start3DU( x0 * s_biuTo3Dunits, -y0 * s_biuTo3Dunits );
-    const SFVEC2F end3DU  ( xf * s_biuTo3Dunits, -yf * s_biuTo3Dunits );
-
-    if( Is_segment_a_circle( start3DU, end3DU ) )
-        s_dstcontainer->Add( new CFILLEDCIRCLE2D( start3DU,
-                                                  ( s_textWidth / 2 ) * s_biuTo3Dunits,
-                                                  *s_boardItem) );
-    else
-        s_dstcontainer->Add( new CROUNDSEGMENT2D( start3DU,
-                                                  end3DU,
-                                                  s_textWidth * s_biuTo3Dunits,
-                                                  *s_boardItem ) );
+    const std::vector<wxPoint>& segments = aShape.m_Segments;
+
+    for( size_t ii = 0; ii + 1 < segments.size(); ii += 2 )
+    {
+        const SFVEC2F start3DU( segments[ii].x * aBiuTo3Dunits, -segments[ii].y * aBiuTo3Dunits );
+        const SFVEC2F end3DU  ( segments[ii+1].x * aBiuTo3Dunits,
+                                -segments[ii+1].y * aBiuTo3Dunits );
+
+        if( Is_segment_a_circle( start3DU, end3DU ) )
+            aDstContainer->Add( new CFILLEDCIRCLE2D( start3DU,
+                                                     ( aTextWidth / 2 ) * aBiuTo3Dunits,
+                                                     aBoardItem ) );
+        else
+            aDstContainer->Add( new CROUNDSEGMENT2D( start3DU,
+                                                     end3DU,
+                                                     aTextWidth * aBiuTo3Dunits,
+                                                     aBoardItem ) );
+    }
 }
 
 
@@ -92,42 +90,9 @@ void CINFO3D_VISU::AddShapeWithClearanceToContainer( const TEXTE_PCB* aText,
                                                      PCB_LAYER_ID aLayerId,
                                                      int aClearanceValue )
 {
-    wxSize size = aText->GetTextSize();
-
-    if( aText->IsMirrored() )
-        size.x = -size.x;
-
-    s_boardItem    = (const BOARD_ITEM *) &aText;
-    s_dstcontainer = aDstContainer;
-    s_textWidth    = aText->GetThickness() + ( 2 * aClearanceValue );
-    s_biuTo3Dunits = m_biuTo3Dunits;
-
-    // not actually used, but needed by GRText
-    const COLOR4D dummy_color = COLOR4D::BLACK;
-
-    if( aText->IsMultilineAllowed() )
-    {
-        wxArrayString strings_list;
-        wxStringSplit( aText->GetShownText(), strings_list, '\n' );
-        std::vector<wxPoint> positions;
-        positions.reserve( strings_list.Count() );
-        aText->GetPositionsOfLinesOfMultilineText( positions, strings_list.Count() );
-
-        for( unsigned ii = 0; ii < strings_list.Count(); ++ii )
-        {
-            wxString txt = strings_list.Item( ii );
-
-            GRText( NULL, positions[ii], dummy_color, txt, aText->GetTextAngle(), size,
-                    aText->GetHorizJustify(), aText->GetVertJustify(), aText->GetThickness(),
-                    aText->IsItalic(), true, addTextSegmToContainer );
-        }
-    }
-    else
-    {
-        GRText( NULL, aText->GetTextPos(), dummy_color, aText->GetShownText(),
-                aText->GetTextAngle(), size, aText->GetHorizJustify(), aText->GetVertJustify(),
-                aText->GetThickness(), aText->IsItalic(), true, addTextSegmToContainer );
-    }
+    addTextShapeToContainer( aDstContainer, *aText->GetTextShape(),
+                             aText->GetThickness() + ( 2 * aClearanceValue ), m_biuTo3Dunits,
+                             *aText );
 }
 
 
@@ -215,21 +180,11 @@ void CINFO3D_VISU::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMod
     if( aModule->Value().GetLayer() == aLayerId && aModule->Value().IsVisible() )
         texts.push_back( &aModule->Value() );
 
-    s_boardItem    = (const BOARD_ITEM *)&aModule->Value();
-    s_dstcontainer = aDstContainer;
-    s_biuTo3Dunits = m_biuTo3Dunits;
-
     for( TEXTE_MODULE* text : texts )
     {
-        s_textWidth = text->GetThickness() + ( 2 * aInflateValue );
-        wxSize size = text->GetTextSize();
-
-        if( text->IsMirrored() )
-            size.x = -size.x;
-
-        GRText( NULL, text->GetTextPos(), BLACK, text->GetShownText(), text->GetDrawRotation(),
-                size, text->GetHorizJustify(), text->GetVertJustify(), text->GetThickness(),
-                text->IsItalic(), true, addTextSegmToContainer );
+        addTextShapeToContainer( aDstContainer, *text->GetTextShape( text->GetDrawRotation() ),
+                                 text->GetThickness() + ( 2 * aInflateValue ), m_biuTo3Dunits,
+                                 aModule->Value() );
     }
 }
 
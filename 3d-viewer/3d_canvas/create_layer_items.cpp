@@ -52,10 +52,9 @@
 #include <trigo.h>
 #include <utility>
 #include <vector>
-#include <thread>
 #include <algorithm>
-#include <atomic>
 
+#include <parallel_for.h>
 #include <profile.h>
 
 void CINFO3D_VISU::destroyLayers()
@@ -138,6 +137,320 @@ void CINFO3D_VISU::destroyLayers()
 }
 
 
+void CINFO3D_VISU::swapLayers( CINFO3D_VISU &aOther )
+{
+    std::swap( m_board_poly, aOther.m_board_poly );
+
+    m_layers_poly.swap( aOther.m_layers_poly );
+    m_layers_outer_holes_poly.swap( aOther.m_layers_outer_holes_poly );
+    m_layers_inner_holes_poly.swap( aOther.m_layers_inner_holes_poly );
+    m_layers_container2D.swap( aOther.m_layers_container2D );
+    m_layers_holes2D.swap( aOther.m_layers_holes2D );
+
+    m_through_holes_inner.Swap( aOther.m_through_holes_inner );
+    m_through_holes_outer.Swap( aOther.m_through_holes_outer );
+    m_through_holes_vias_outer.Swap( aOther.m_through_holes_vias_outer );
+    m_through_holes_vias_inner.Swap( aOther.m_through_holes_vias_inner );
+    std::swap( m_through_outer_holes_poly_NPTH, aOther.m_through_outer_holes_poly_NPTH );
+    std::swap( m_through_outer_holes_poly, aOther.m_through_outer_holes_poly );
+    std::swap( m_through_inner_holes_poly, aOther.m_through_inner_holes_poly );
+    std::swap( m_through_outer_holes_vias_poly, aOther.m_through_outer_holes_vias_poly );
+    std::swap( m_through_inner_holes_vias_poly, aOther.m_through_inner_holes_vias_poly );
+
+    std::swap( m_stats_nr_tracks, aOther.m_stats_nr_tracks );
+    std::swap( m_stats_track_med_width, aOther.m_stats_track_med_width );
+    std::swap( m_stats_nr_vias, aOther.m_stats_nr_vias );
+    std::swap( m_stats_via_med_hole_diameter, aOther.m_stats_via_med_hole_diameter );
+    std::swap( m_stats_nr_holes, aOther.m_stats_nr_holes );
+    std::swap( m_stats_hole_med_diameter, aOther.m_stats_hole_med_diameter );
+
+    std::swap( m_layersKey, aOther.m_layersKey );
+}
+
+
+void CINFO3D_VISU::createCopperLayer( PCB_LAYER_ID aLayerId,
+                                      const std::vector< const TRACK *> &aTrackList,
+                                      CBVHCONTAINER2D *aDstContainer,
+                                      SHAPE_POLY_SET *aDstPoly )
+{
+    // Create tracks as objects and add it to container
+    // /////////////////////////////////////////////////////////////////////////
+    for( const TRACK *track : aTrackList )
+    {
+        // NOTE: Vias can be on multiple layers
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
+
+        // Add object item to layer container
+        aDstContainer->Add( createNewTrack( track, 0.0f ) );
+    }
+
+    // Add modules PADs objects to containers
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto module : m_board->Modules() )
+    {
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        AddPadsShapesWithClearanceToContainer( module, aDstContainer, aLayerId, 0, true );
+
+        // Micro-wave modules may have items on copper layers
+        AddGraphicsShapesWithClearanceToContainer( module, aDstContainer, aLayerId, 0 );
+    }
+
+    // Add graphic item on copper layers to object containers
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*) item, aDstContainer, aLayerId, 0 );
+            break;
+
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item, aDstContainer, aLayerId, 0 );
+            break;
+
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item, aDstContainer, aLayerId, 0 );
+            break;
+
+        default:
+            wxLogTrace( m_logTrace,
+                        wxT( "createLayers: item type: %d not implemented" ),
+                        item->Type() );
+            break;
+        }
+    }
+
+    // The contours are only used by the OpenGL render, to draw the copper thickness
+    if( !aDstPoly )
+        return;
+
+    // Creates outline contours of the tracks and add it to the poly of the layer
+    // /////////////////////////////////////////////////////////////////////////
+    for( const TRACK *track : aTrackList )
+    {
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
+
+        // Add the track contour
+        track->TransformShapeWithClearanceToPolygon( *aDstPoly, 0 );
+    }
+
+    // Add modules PADs poly contourns
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto module : m_board->Modules() )
+    {
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        transformPadsShapesWithClearanceToPolygon( module->Pads(), aLayerId, *aDstPoly, 0, true );
+
+        // Micro-wave modules may have items on copper layers
+        module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId, *aDstPoly, 0 );
+
+        transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *aDstPoly );
+    }
+
+    // Add graphic item on copper layers to poly contourns
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *aDstPoly, 0 );
+            break;
+
+        case PCB_TEXT_T:
+            ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *aDstPoly, 0 );
+            break;
+
+        default:
+            wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
+                    item->Type() );
+            break;
+        }
+    }
+
+    // Add copper zones contours
+    // /////////////////////////////////////////////////////////////////////////
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+        {
+            const ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+            if( zone == nullptr )
+                break;
+
+            if( zone->GetLayer() == aLayerId )
+                zone->TransformSolidAreasShapesToPolygonSet( *aDstPoly );
+        }
+    }
+
+    // This will make a union of all added contours
+    aDstPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+}
+
+
+void CINFO3D_VISU::createTechLayer( PCB_LAYER_ID aLayerId,
+                                    CBVHCONTAINER2D *aDstContainer,
+                                    SHAPE_POLY_SET *aDstPoly )
+{
+    // Add drawing objects
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
+            break;
+
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
+            break;
+
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              aDstContainer,
+                                              aLayerId,
+                                              0 );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+
+    // Add drawing contours
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *aDstPoly, 0 );
+            break;
+
+        case PCB_TEXT_T:
+            ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *aDstPoly, 0 );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+
+    // Add modules tech layers - objects
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto module : m_board->Modules() )
+    {
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
+        {
+            int     linewidth = g_DrawDefaultLineThickness;
+
+            for( auto pad : module->Pads() )
+            {
+                if( !pad->IsOnLayer( aLayerId ) )
+                    continue;
+
+                buildPadShapeThickOutlineAsSegments( pad, aDstContainer, linewidth );
+            }
+        }
+        else
+        {
+            AddPadsShapesWithClearanceToContainer(
+                    module, aDstContainer, aLayerId, 0, false );
+        }
+
+        AddGraphicsShapesWithClearanceToContainer( module, aDstContainer, aLayerId, 0 );
+    }
+
+
+    // Add modules tech layers - contours
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto module : m_board->Modules() )
+    {
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
+        {
+            const int linewidth = g_DrawDefaultLineThickness;
+
+            for( auto pad : module->Pads() )
+            {
+                if( !pad->IsOnLayer( aLayerId ) )
+                    continue;
+
+                buildPadShapeThickOutlineAsPolygon( pad, *aDstPoly, linewidth );
+            }
+        }
+        else
+        {
+            transformPadsShapesWithClearanceToPolygon(
+                    module->Pads(), aLayerId, *aDstPoly, 0, false );
+        }
+
+        // On tech layers, use a poor circle approximation, only for texts (stroke font)
+        module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId, *aDstPoly, 0 );
+
+        // Add the remaining things with dynamic seg count for circles
+        transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *aDstPoly );
+    }
+
+
+    // Draw non copper zones
+    // /////////////////////////////////////////////////////////////////////////
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+        {
+            ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
+
+            AddSolidAreasShapesToContainer( zone,
+                                            aDstContainer,
+                                            aLayerId );
+        }
+
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+        {
+            ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
+
+            zone->TransformSolidAreasShapesToPolygonSet( *aDstPoly );
+        }
+    }
+
+    // This will make a union of all added contours
+    aDstPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+}
+
+
 void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 {
     destroyLayers();
@@ -239,37 +552,6 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Create tracks and vias" ) );
 
-    // Create tracks as objects and add it to container
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
-
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            // Add object item to layer container
-            layerContainer->Add( createNewTrack( track, 0.0f ) );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Create VIAS and THTs objects and add it to holes containers
     // /////////////////////////////////////////////////////////////////////////
     for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
@@ -452,40 +734,6 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Creates outline contours of the tracks and add it to the poly of the layer
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
-
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
-
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                // Add the track contour
-                track->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T06: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Add holes of modules
     // /////////////////////////////////////////////////////////////////////////
     for( auto module : m_board->Modules() )
@@ -551,176 +799,25 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Add modules PADs objects to containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD PADS
-        for( auto module : m_board->Modules() )
-        {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true );
-
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add modules PADs poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD PADS
-            for( auto module : m_board->Modules() )
-            {
-                // Construct polys
-                // /////////////////////////////////////////////////////////////
-
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                transformPadsShapesWithClearanceToPolygon( module->Pads(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           true );
-
-                // Micro-wave modules may have items on copper layers
-                module->TransformGraphicTextWithClearanceToPolygonSet(
-                        curr_layer_id, *layerPoly, 0 );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T10: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Create copper layers" ) );
 
-    // Add graphic item on copper layers to object containers
+    // Add tracks, pads and graphic items to the copper layers, and their contours.
+    // Each layer has its own container and poly, so the layers are built in parallel.
     // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    ParallelFor( layer_id.size(), [&]( size_t lIdx )
     {
         const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+        auto layerPoly = m_layers_poly.find( curr_layer_id );
 
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-            {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
-            break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
-
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T11: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add graphic item on copper layers to poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-            for( auto item : m_board->Drawings() )
-            {
-                if( !item->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                switch( item->Type() )
-                {
-                case PCB_LINE_T:
-                    ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-                    break;
-
-                case PCB_TEXT_T:
-                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                    break;
-
-                default:
-                    wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-                    break;
-                }
-            }
-        }
-    }
+        createCopperLayer( curr_layer_id,
+                           trackList,
+                           m_layers_container2D.at( curr_layer_id ),
+                           layerPoly != m_layers_poly.end() ? layerPoly->second : nullptr );
+    } );
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T12: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
@@ -731,39 +828,15 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 
         // Add zones objects
         // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        ParallelFor( m_board->GetAreaCount(), [&]( size_t areaId )
         {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < static_cast<size_t>( m_board->GetAreaCount() );
-                            areaId = nextZone.fetch_add( 1 ) )
-                {
-                    const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
-
-                    if( zone == nullptr )
-                        break;
+            const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
 
-                    auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
-
-                    if( layerContainer != m_layers_container2D.end() )
-                        AddSolidAreasShapesToContainer( zone, layerContainer->second,
-                                                        zone->GetLayer() );
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
 
+            if( layerContainer != m_layers_container2D.end() )
+                AddSolidAreasShapesToContainer( zone, layerContainer->second, zone->GetLayer() );
+        } );
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -771,80 +844,13 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
-    if( GetFlag( FL_ZONE ) &&
-        GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        // ADD COPPER ZONES
-        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-        {
-            const ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-            if( zone == nullptr )
-                break;
-
-            auto layerContainer = m_layers_poly.find( zone->GetLayer() );
-
-            if( layerContainer != m_layers_poly.end() )
-                zone->TransformSolidAreasShapesToPolygonSet( *layerContainer->second );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T14: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Simplify layer polygons
-    // /////////////////////////////////////////////////////////////////////////
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
-
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        std::atomic<size_t> nextItem( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::min<size_t>(
-                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                layer_id.size() );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id, this]()
-            {
-                for( size_t i = nextItem.fetch_add( 1 );
-                            i < layer_id.size();
-                            i = nextItem.fetch_add( 1 ) )
-                {
-                    auto layerPoly = m_layers_poly.find( layer_id[i] );
-
-                    if( layerPoly != m_layers_poly.end() )
-                        // This will make a union of all added contours
-                        layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T15: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Simplify holes polygon contours
     // /////////////////////////////////////////////////////////////////////////
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Simplify holes contours" ) );
 
+    std::vector< SHAPE_POLY_SET *> holesPolys;
+
     for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
     {
         const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
@@ -853,30 +859,33 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
             m_layers_outer_holes_poly.end() )
         {
             // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+            holesPolys.push_back( m_layers_outer_holes_poly[curr_layer_id] );
 
             wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
                       m_layers_inner_holes_poly.end() );
 
-            polyLayer = m_layers_inner_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+            holesPolys.push_back( m_layers_inner_holes_poly[curr_layer_id] );
         }
     }
 
+    holesPolys.push_back( &m_through_inner_holes_poly );
+    holesPolys.push_back( &m_through_outer_holes_poly );
+    holesPolys.push_back( &m_through_outer_holes_poly_NPTH );
+    holesPolys.push_back( &m_through_outer_holes_vias_poly );
+    //m_through_inner_holes_vias_poly is not in use
+
+    // This will make a union of all added contourns
+    ParallelFor( holesPolys.size(), [&holesPolys]( size_t ii )
+    {
+        holesPolys[ii]->Simplify( SHAPE_POLY_SET::PM_FAST );
+    } );
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     printf( "T16: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
 #endif
     // End Build Copper layers
 
 
-    // This will make a union of all added contourns
-    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
-
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
 #endif
@@ -913,6 +922,8 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 
     // User layers are not drawn here, only technical layers
 
+    std::vector< PCB_LAYER_ID > tech_layer_id;
+
     for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
          seq;
          ++seq )
@@ -922,157 +933,21 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         if( !Is3DLayerEnabled( curr_layer_id ) )
                     continue;
 
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
-
-        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-        m_layers_poly[curr_layer_id] = layerPoly;
-
-        // Add drawing objects
-        // /////////////////////////////////////////////////////////////////////
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            default:
-                break;
-            }
-        }
-
-
-        // Add drawing contours
-        // /////////////////////////////////////////////////////////////////////
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-                break;
-
-            case PCB_TEXT_T:
-                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                break;
+        tech_layer_id.push_back( curr_layer_id );
 
-            default:
-                break;
-            }
-        }
-
-
-        // Add modules tech layers - objects
-        // /////////////////////////////////////////////////////////////////////
-        for( auto module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                int     linewidth = g_DrawDefaultLineThickness;
-
-                for( auto pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
-                }
-            }
-            else
-            {
-                AddPadsShapesWithClearanceToContainer(
-                        module, layerContainer, curr_layer_id, 0, false );
-            }
-
-            AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0 );
-        }
-
-
-        // Add modules tech layers - contours
-        // /////////////////////////////////////////////////////////////////////
-        for( auto module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                const int linewidth = g_DrawDefaultLineThickness;
-
-                for( auto pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                transformPadsShapesWithClearanceToPolygon(
-                        module->Pads(), curr_layer_id, *layerPoly, 0, false );
-            }
-
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id, *layerPoly, 0 );
-
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-        }
-
-
-        // Draw non copper zones
-        // /////////////////////////////////////////////////////////////////////
-        if( GetFlag( FL_ZONE ) )
-        {
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                AddSolidAreasShapesToContainer( zone,
-                                                layerContainer,
-                                                curr_layer_id );
-            }
-
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
+        m_layers_container2D[curr_layer_id] = new CBVHCONTAINER2D;
+        m_layers_poly[curr_layer_id] = new SHAPE_POLY_SET;
+    }
 
-                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
-            }
-        }
+    // The tech layers do not share anything, they are built in parallel
+    ParallelFor( tech_layer_id.size(), [&]( size_t lIdx )
+    {
+        const PCB_LAYER_ID curr_layer_id = tech_layer_id[lIdx];
 
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
-    }
+        createTechLayer( curr_layer_id,
+                         m_layers_container2D.at( curr_layer_id ),
+                         m_layers_poly.at( curr_layer_id ) );
+    } );
     // End Build Tech layers
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
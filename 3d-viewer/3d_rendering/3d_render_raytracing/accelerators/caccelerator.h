@@ -47,7 +47,7 @@ public:
 
     virtual bool Intersect( const RAY &aRay,
                             HITINFO &aHitInfo,
-                            unsigned int aAccNodeInfo ) const = 0;
+                            uint64_t aAccNodeInfo ) const = 0;
 
     virtual bool Intersect( const RAYPACKET &aRayPacket,
                             HITINFO_PACKET *aHitInfoPacket ) const = 0;
@@ -28,6 +28,8 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "../raypacket_simd.h"
+#include "../shapes3D/ctriangle.h"
 #include <wx/debug.h>
 
 
@@ -103,6 +105,9 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
     if( (&m_nodes[0]) == NULL )
         return false;
 
+    if( RAYPACKET_GetSimdLevel() != RAYPACKET_SIMD_NONE )
+        return intersectPacketSimd( aRayPacket, aHitInfoPacket );
+
     bool anyHitted = false;
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
@@ -147,7 +152,8 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                             {
                                 anyHitted |= hitted;
                                 aHitInfoPacket[i].m_hitresult |= hitted;
-                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info =
+                                        hitNodeInfo( nodeNum, j, obj, aHitInfoPacket[i].m_HitInfo );
                             }
                         }
                     }
@@ -221,6 +227,9 @@ static inline unsigned int partRays( const RAYPACKET &aRayPacket,
 bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                            HITINFO_PACKET *aHitInfoPacket ) const
 {
+    if( RAYPACKET_GetSimdLevel() != RAYPACKET_SIMD_NONE )
+        return intersectPacketSimd( aRayPacket, aHitInfoPacket );
+
     bool anyHitted = false;
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
@@ -273,7 +282,9 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                             {
                                 anyHitted |= hitted;
                                 aHitInfoPacket[idx].m_hitresult |= hitted;
-                                aHitInfoPacket[idx].m_HitInfo.m_acc_node_info = nodeNum;
+                                aHitInfoPacket[idx].m_HitInfo.m_acc_node_info =
+                                        hitNodeInfo( nodeNum, j, obj,
+                                                     aHitInfoPacket[idx].m_HitInfo );
                             }
                         }
                     }
@@ -293,3 +304,95 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
     return anyHitted;
 }// Partition Traversal
 #endif
+
+
+// Ranged traversal, testing the node boxes and the triangles against all the rays of
+// the packet at once, with the SIMD instructions
+bool CBVH_PBRT::intersectPacketSimd( const RAYPACKET &aRayPacket,
+                                     HITINFO_PACKET *aHitInfoPacket ) const
+{
+    if( m_nodes == NULL )
+        return false;
+
+    RAYPACKET_SOA packet;
+
+    packet.Init( aRayPacket, aHitInfoPacket );
+
+    bool anyHitted = false;
+    int todoOffset = 0, nodeNum = 0;
+    StackNode todo[MAX_TODOS];
+
+    unsigned int ia = 0;
+
+    while( true )
+    {
+        const LinearBVHNode *curCell = &m_nodes[nodeNum];
+
+        const RAYPACKET_MASK_T nodeHits = RAYPACKET_IntersectBBox( packet, curCell->bounds, ia );
+
+        if( nodeHits )
+        {
+            ia = RAYPACKET_FirstRay( nodeHits );
+
+            if( curCell->nPrimitives == 0 )
+            {
+                StackNode &node = todo[todoOffset++];
+                node.cell = curCell->secondChildOffset;
+                node.ia = ia;
+                nodeNum = nodeNum + 1;
+                continue;
+            }
+
+            const unsigned int ie = RAYPACKET_LastRay( nodeHits ) + 1;
+
+            for( int j = 0; j < curCell->nPrimitives; ++j )
+            {
+                const COBJECT *obj = m_primitives[curCell->primitivesOffset + j];
+
+                if( !aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                    continue;
+
+                RAYPACKET_MASK_T hits = 0;
+
+                if( obj->GetObjectType() == OBJ3D_TRIANGLE )
+                {
+                    hits = static_cast<const CTRIANGLE *>( obj )->IntersectPacket(
+                            packet, aRayPacket.m_ray, ia, ie, aHitInfoPacket );
+                }
+                else
+                {
+                    for( unsigned int i = ia; i < ie; ++i )
+                    {
+                        if( obj->Intersect( aRayPacket.m_ray[i], aHitInfoPacket[i].m_HitInfo ) )
+                            hits |= (RAYPACKET_MASK_T) 1 << i;
+                    }
+                }
+
+                while( hits )
+                {
+                    const unsigned int i = RAYPACKET_FirstRay( hits );
+
+                    hits &= hits - 1;
+
+                    anyHitted = true;
+                    aHitInfoPacket[i].m_hitresult = true;
+                    aHitInfoPacket[i].m_HitInfo.m_acc_node_info =
+                            hitNodeInfo( nodeNum, j, obj, aHitInfoPacket[i].m_HitInfo );
+
+                    // The next boxes and triangles are tested against the new hit
+                    packet.m_tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+                }
+            }
+        }
+
+        if( todoOffset == 0 )
+            break;
+
+        const StackNode &node = todo[--todoOffset];
+
+        nodeNum = node.cell;
+        ia = node.ia;
+    }
+
+    return anyHitted;
+}
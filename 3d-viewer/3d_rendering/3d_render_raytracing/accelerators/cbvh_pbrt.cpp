@@ -67,10 +67,15 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "../cworker_pool.h"
+#include "../mortoncodes.h"
+#include "../shapes3D/cinstance.h"
 #include "../../../3d_fastmath.h"
 #include <boost/range/algorithm/nth_element.hpp>
 #include <boost/range/algorithm/partition.hpp>
+#include <atomic>
 #include <cstdlib>
+#include <utility>
 #include <vector>
 
 #include <stack>
@@ -128,13 +133,6 @@ struct BVHBuildNode
 };
 
 
-struct MortonPrimitive
-{
-    int primitiveIndex;
-    uint32_t mortonCode;
-};
-
-
 struct LBVHTreelet
 {
     int startIndex, numPrimitives;
@@ -173,68 +171,13 @@ inline uint32_t EncodeMorton3( const SFVEC3F &v )
 }
 
 
-static void RadixSort( std::vector<MortonPrimitive> *v )
-{
-    std::vector<MortonPrimitive> tempVector( v->size() );
-
-    const int bitsPerPass = 6;
-    const int nBits = 30;
-
-    wxASSERT( (nBits % bitsPerPass) == 0 );
-
-    const int nPasses = nBits / bitsPerPass;
-
-    for( int pass = 0; pass < nPasses; ++pass )
-    {
-        // Perform one pass of radix sort, sorting _bitsPerPass_ bits
-        const int lowBit = pass * bitsPerPass;
-
-        // Set in and out vector pointers for radix sort pass
-        std::vector<MortonPrimitive> &in  = (pass & 1) ? tempVector : *v;
-        std::vector<MortonPrimitive> &out = (pass & 1) ? *v : tempVector;
-
-        // Count number of zero bits in array for current radix sort bit
-        const int nBuckets = 1 << bitsPerPass;
-        int bucketCount[nBuckets] = {0};
-        const int bitMask = (1 << bitsPerPass) - 1;
-
-        for( uint32_t i = 0; i < in.size(); ++i )
-        {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
-
-            wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
-
-            ++bucketCount[bucket];
-        }
-
-        // Compute starting index in output array for each bucket
-        int startIndex[nBuckets];
-        startIndex[0] = 0;
-
-        for( int i = 1; i < nBuckets; ++i )
-            startIndex[i] = startIndex[i - 1] + bucketCount[i - 1];
-
-        // Store sorted values in output array
-        for( uint32_t i = 0; i < in.size(); ++i )
-        {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
-            out[startIndex[bucket]++] = mp;
-        }
-    }
-
-    // Copy final result from _tempVector_, if needed
-    if( nPasses & 1 )
-        std::swap( *v, tempVector );
-}
-
-
 CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
                       int aMaxPrimsInNode,
-                      SPLITMETHOD aSplitMethod ) :
+                      SPLITMETHOD aSplitMethod,
+                      size_t aThreadCount ) :
     m_maxPrimsInNode( std::min( 255, aMaxPrimsInNode ) ),
-    m_splitMethod( aSplitMethod )
+    m_splitMethod( aSplitMethod ),
+    m_threadCount( aThreadCount )
 {
     if( aObjectContainer.GetList().empty() )
     {
@@ -269,17 +212,15 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     // Build BVH tree for primitives using _primitiveInfo_
     int totalNodes = 0;
 
-    CONST_VECTOR_OBJECT orderedPrims;
-    orderedPrims.clear();
-    orderedPrims.reserve( m_primitives.size() );
+    // The builds place the primitives of each leaf at their own offset
+    CONST_VECTOR_OBJECT orderedPrims( m_primitives.size() );
 
     BVHBuildNode *root;
 
     if( m_splitMethod == SPLIT_HLBVH )
         root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims);
     else
-        root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
-                               &totalNodes, orderedPrims);
+        root = buildTopDown( primitiveInfo, &totalNodes, orderedPrims );
 
     wxASSERT( m_primitives.size() == orderedPrims.size() );
 
@@ -442,11 +383,75 @@ struct BucketInfo
 };
 
 
+// A subtree of the SAH build, left by the top levels to a thread of the pool
+struct BVHBuildJob
+{
+    BVHBuildNode      *node;        ///< The root of the subtree, its bounds already set
+    int               start, end;
+    int               totalNodes;   ///< Nodes created by the job, the root excluded
+    std::list<void *> addresses;    ///< Nodes allocated by the job
+};
+
+
+BVHBuildNode *CBVH_PBRT::buildTopDown( std::vector<BVHPrimitiveInfo> &primitiveInfo,
+                                       int *totalNodes,
+                                       CONST_VECTOR_OBJECT &orderedPrims )
+{
+    const int minJobPrimitives = 1024;
+    const int nPrimitives = primitiveInfo.size();
+
+    // Small trees, as the ones of most 3D models, are not worth starting the threads
+    if( ( nPrimitives <= 4 * minJobPrimitives ) || ( m_threadCount == 1 ) )
+        return recursiveBuild( primitiveInfo, 0, nPrimitives, totalNodes, orderedPrims,
+                               m_addresses_pointer_to_mm_free, NULL, 0 );
+
+    CWORKER_POOL pool( m_threadCount );
+
+    // The top levels are built here, until the subtrees are small enough to keep all the
+    // threads busy; each leaf then writes its primitives at its own place, so the tree is
+    // the same for any thread count
+    const int jobPrimitives = std::max<int>( minJobPrimitives,
+                                             nPrimitives / ( 8 * pool.GetThreadCount() ) );
+
+    std::vector<BVHBuildJob> jobs;
+
+    BVHBuildNode *root = recursiveBuild( primitiveInfo, 0, nPrimitives, totalNodes,
+                                         orderedPrims, m_addresses_pointer_to_mm_free,
+                                         &jobs, jobPrimitives );
+
+    std::atomic<size_t> nextJob( 0 );
+
+    pool.Run( [&]()
+    {
+        for( size_t i = nextJob.fetch_add( 1 ); i < jobs.size(); i = nextJob.fetch_add( 1 ) )
+        {
+            BVHBuildJob &job = jobs[i];
+
+            job.totalNodes = 0;
+            buildNode( primitiveInfo, job.node, job.start, job.end, &job.totalNodes,
+                       orderedPrims, job.addresses, NULL, 0 );
+        }
+    } );
+
+    for( BVHBuildJob &job : jobs )
+    {
+        *totalNodes += job.totalNodes;
+        m_addresses_pointer_to_mm_free.splice( m_addresses_pointer_to_mm_free.end(),
+                                               job.addresses );
+    }
+
+    return root;
+}
+
+
 BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                           int start,
                                           int end,
                                           int *totalNodes,
-                                          CONST_VECTOR_OBJECT &orderedPrims )
+                                          CONST_VECTOR_OBJECT &orderedPrims,
+                                          std::list<void *> &addresses,
+                                          std::vector<BVHBuildJob> *jobs,
+                                          int jobPrimitives )
 {
     wxASSERT( totalNodes != NULL );
     wxASSERT( start >= 0 );
@@ -460,7 +465,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
     // !TODO: implement an memory Arena
     BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_addresses_pointer_to_mm_free.push_back( node );
+    addresses.push_back( node );
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -469,6 +474,40 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     node->children[0] = NULL;
     node->children[1] = NULL;
 
+    if( jobs && ( end - start <= jobPrimitives ) )
+    {
+        // Leave the subtree to a job; its parent already needs the bounds
+        for( int i = start; i < end; ++i )
+            node->bounds.Union( primitiveInfo[i].bounds );
+
+        BVHBuildJob job;
+        job.node = node;
+        job.start = start;
+        job.end = end;
+        job.totalNodes = 0;
+
+        jobs->push_back( std::move( job ) );
+
+        return node;
+    }
+
+    buildNode( primitiveInfo, node, start, end, totalNodes, orderedPrims, addresses, jobs,
+               jobPrimitives );
+
+    return node;
+}
+
+
+void CBVH_PBRT::buildNode( std::vector<BVHPrimitiveInfo> &primitiveInfo,
+                           BVHBuildNode *node,
+                           int start,
+                           int end,
+                           int *totalNodes,
+                           CONST_VECTOR_OBJECT &orderedPrims,
+                           std::list<void *> &addresses,
+                           std::vector<BVHBuildJob> *jobs,
+                           int jobPrimitives )
+{
     // Compute bounds of all primitives in BVH node
     CBBOX bounds;
     bounds.Reset();
@@ -478,16 +517,18 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
     int nPrimitives = end - start;
 
+    // The primitives of a node are placed at its start in _orderedPrims_, whatever the
+    // order its subtrees are built in
     if( nPrimitives == 1 )
     {
         // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
+        int firstPrimOffset = start;
 
         for( int i = start; i < end; ++i )
         {
             int primitiveNr = primitiveInfo[i].primitiveNumber;
             wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+            orderedPrims[i] = m_primitives[ primitiveNr ];
         }
 
         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -510,7 +551,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                   centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
         {
             // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
+            const int firstPrimOffset = start;
 
             for( int i = start; i < end; ++i )
             {
@@ -523,7 +564,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                 wxASSERT( obj != NULL );
 
-                orderedPrims.push_back( obj );
+                orderedPrims[i] = obj;
             }
 
             node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -678,7 +719,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                     else
                     {
                         // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
+                        const int firstPrimOffset = start;
 
                         for( int i = start; i < end; ++i )
                         {
@@ -686,12 +727,12 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                             wxASSERT( primitiveNr < (int)m_primitives.size() );
 
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+                            orderedPrims[i] = m_primitives[ primitiveNr ];
                         }
 
                         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
 
-                        return node;
+                        return;
                     }
                 }
                 break;
@@ -703,16 +744,20 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                                                 start,
                                                 mid,
                                                 totalNodes,
-                                                orderedPrims ),
+                                                orderedPrims,
+                                                addresses,
+                                                jobs,
+                                                jobPrimitives ),
                                 recursiveBuild( primitiveInfo,
                                                 mid,
                                                 end,
                                                 totalNodes,
-                                                orderedPrims) );
+                                                orderedPrims,
+                                                addresses,
+                                                jobs,
+                                                jobPrimitives ) );
         }
     }
-
-    return node;
 }
 
 
@@ -720,38 +765,73 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
                                      int *totalNodes,
                                      CONST_VECTOR_OBJECT &orderedPrims )
 {
+    CWORKER_POOL pool( m_threadCount );
+
+    // Runs aFunc on the pool for each index below aCount
+    auto parallelFor = [&pool]( size_t aCount, const std::function<void( size_t )> &aFunc )
+    {
+        std::atomic<size_t> nextItem( 0 );
+
+        pool.Run( [&]()
+        {
+            for( size_t i = nextItem.fetch_add( 1 ); i < aCount; i = nextItem.fetch_add( 1 ) )
+                aFunc( i );
+        } );
+    };
+
+    // The primitives are split in chunks, so the threads do not fight for the counter
+    const size_t chunkSize = 4096;
+    const size_t nChunks = ( primitiveInfo.size() + chunkSize - 1 ) / chunkSize;
+
     // Compute bounding box of all primitive centroids
+    std::vector<CBBOX> chunkBounds( nChunks );
+
+    parallelFor( nChunks, [&]( size_t aChunk )
+    {
+        const size_t end = std::min( ( aChunk + 1 ) * chunkSize, primitiveInfo.size() );
+
+        chunkBounds[aChunk].Reset();
+
+        for( size_t i = aChunk * chunkSize; i < end; ++i )
+            chunkBounds[aChunk].Union( primitiveInfo[i].centroid );
+    } );
+
     CBBOX bounds;
     bounds.Reset();
 
-    for( unsigned int i = 0; i < primitiveInfo.size(); ++i )
-        bounds.Union( primitiveInfo[i].centroid );
+    for( const CBBOX &chunkBBox : chunkBounds )
+        bounds.Union( chunkBBox );
 
     // Compute Morton indices of primitives
     std::vector<MortonPrimitive> mortonPrims( primitiveInfo.size() );
 
-    for( int i = 0; i < (int)primitiveInfo.size(); ++i )
+    parallelFor( nChunks, [&]( size_t aChunk )
     {
-        // Initialize _mortonPrims[i]_ for _i_th primitive
-        const int mortonBits  = 10;
-        const int mortonScale = 1 << mortonBits;
+        const size_t end = std::min( ( aChunk + 1 ) * chunkSize, primitiveInfo.size() );
 
-        wxASSERT( primitiveInfo[i].primitiveNumber < (int)primitiveInfo.size() );
+        for( size_t i = aChunk * chunkSize; i < end; ++i )
+        {
+            // Initialize _mortonPrims[i]_ for _i_th primitive
+            const int mortonBits  = 10;
+            const int mortonScale = 1 << mortonBits;
 
-        mortonPrims[i].primitiveIndex = primitiveInfo[i].primitiveNumber;
+            wxASSERT( primitiveInfo[i].primitiveNumber < (int)primitiveInfo.size() );
 
-        const SFVEC3F centroidOffset = bounds.Offset( primitiveInfo[i].centroid );
+            mortonPrims[i].primitiveIndex = primitiveInfo[i].primitiveNumber;
 
-        wxASSERT( (centroidOffset.x >= 0.0f) && (centroidOffset.x <= 1.0f) );
-        wxASSERT( (centroidOffset.y >= 0.0f) && (centroidOffset.y <= 1.0f) );
-        wxASSERT( (centroidOffset.z >= 0.0f) && (centroidOffset.z <= 1.0f) );
+            const SFVEC3F centroidOffset = bounds.Offset( primitiveInfo[i].centroid );
 
-        mortonPrims[i].mortonCode = EncodeMorton3( centroidOffset *
-                                                   SFVEC3F( (float)mortonScale ) );
-    }
+            wxASSERT( (centroidOffset.x >= 0.0f) && (centroidOffset.x <= 1.0f) );
+            wxASSERT( (centroidOffset.y >= 0.0f) && (centroidOffset.y <= 1.0f) );
+            wxASSERT( (centroidOffset.z >= 0.0f) && (centroidOffset.z <= 1.0f) );
+
+            mortonPrims[i].mortonCode = EncodeMorton3( centroidOffset *
+                                                       SFVEC3F( (float)mortonScale ) );
+        }
+    } );
 
     // Radix sort primitive Morton indices
-    RadixSort( &mortonPrims );
+    RadixSortMorton( mortonPrims, pool );
 
     // Create LBVH treelets at bottom of BVH
 
@@ -776,16 +856,6 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
 
             m_addresses_pointer_to_mm_free.push_back( nodes );
 
-            for( int i = 0; i < maxBVHNodes; ++i )
-            {
-                nodes[i].bounds.Reset();
-                nodes[i].firstPrimOffset = 0;
-                nodes[i].nPrimitives = 0;
-                nodes[i].splitAxis = 0;
-                nodes[i].children[0] = NULL;
-                nodes[i].children[1] = NULL;
-            }
-
             LBVHTreelet tmpTreelet;
 
             tmpTreelet.startIndex = start;
@@ -799,34 +869,47 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     }
 
     // Create LBVHs for treelets in parallel
-    int atomicTotal = 0;
-    int orderedPrimsOffset = 0;
+    std::vector<int> treeletNodes( treeletsToBuild.size(), 0 );
 
-    orderedPrims.resize( m_primitives.size() );
-
-    for( int index = 0; index < (int)treeletsToBuild.size(); ++index )
+    parallelFor( treeletsToBuild.size(), [&]( size_t aIndex )
     {
         // Generate _index_th LBVH treelet
-        int nodesCreated = 0;
         const int firstBit = 29 - 12;
 
-        LBVHTreelet &tr = treeletsToBuild[index];
+        LBVHTreelet &tr = treeletsToBuild[aIndex];
 
         wxASSERT( tr.startIndex < (int)mortonPrims.size() );
 
+        for( int i = 0; i < 2 * tr.numPrimitives; ++i )
+        {
+            tr.buildNodes[i].bounds.Reset();
+            tr.buildNodes[i].firstPrimOffset = 0;
+            tr.buildNodes[i].nPrimitives = 0;
+            tr.buildNodes[i].splitAxis = 0;
+            tr.buildNodes[i].children[0] = NULL;
+            tr.buildNodes[i].children[1] = NULL;
+        }
+
+        // The treelets cover consecutive sorted primitives, so each one knows where its
+        // primitives go, whatever the order they are built in
+        int orderedPrimsOffset = tr.startIndex;
+
         tr.buildNodes = emitLBVH( tr.buildNodes,
                                   primitiveInfo,
                                   &mortonPrims[tr.startIndex],
                                   tr.numPrimitives,
-                                  &nodesCreated,
+                                  &treeletNodes[aIndex],
                                   orderedPrims,
                                   &orderedPrimsOffset,
                                   firstBit );
 
-        atomicTotal += nodesCreated;
-    }
+        wxASSERT( orderedPrimsOffset == tr.startIndex + tr.numPrimitives );
+    } );
 
-    *totalNodes = atomicTotal;
+    *totalNodes = 0;
+
+    for( int nodesCreated : treeletNodes )
+        *totalNodes += nodesCreated;
 
     // Initialize _finishedTreelets_ with treelet root node pointers
     std::vector<BVHBuildNode *> finishedTreelets;
@@ -1124,6 +1207,33 @@ int CBVH_PBRT::flattenBVHTree( BVHBuildNode *node, uint32_t *offset )
 }
 
 
+// The node info of a hit in an instance has the leaf in its low 32 bits, then 8 bits for the
+// primitive of the leaf and 24 bits for the node of the mesh plus one.  The mesh part is 0
+// when the hit is not in an instance, or the numbers do not fit.
+#define NODE_INFO_LEAF_MASK  0xFFFFFFFFull
+#define NODE_INFO_PRIM_SHIFT 32
+#define NODE_INFO_PRIM_MASK  0xFFull
+#define NODE_INFO_MESH_SHIFT 40
+#define NODE_INFO_MESH_MAX   0xFFFFFEull
+
+
+uint64_t CBVH_PBRT::hitNodeInfo( int aNodeNum, int aPrimInLeaf, const COBJECT *aObject,
+                                 const HITINFO &aHitInfo )
+{
+    if( aObject->GetObjectType() != OBJ3D_INSTANCE )
+        return aNodeNum;
+
+    // the mesh stored its own node, see CINSTANCE::Intersect()
+    const uint64_t meshNode = aHitInfo.m_acc_node_info & NODE_INFO_LEAF_MASK;
+
+    if( ( meshNode > NODE_INFO_MESH_MAX ) || ( (uint64_t) aPrimInLeaf > NODE_INFO_PRIM_MASK ) )
+        return aNodeNum;
+
+    return (uint64_t) aNodeNum | ( (uint64_t) aPrimInLeaf << NODE_INFO_PRIM_SHIFT )
+           | ( ( meshNode + 1 ) << NODE_INFO_MESH_SHIFT );
+}
+
+
 #define MAX_TODOS 64
 
 bool CBVH_PBRT::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
@@ -1155,10 +1265,11 @@ bool CBVH_PBRT::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                 // Intersect ray with primitives in leaf BVH node
                 for( int i = 0; i < node->nPrimitives; ++i )
                 {
-                    if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
-                                                                             aHitInfo ) )
+                    const COBJECT *obj = m_primitives[node->primitivesOffset + i];
+
+                    if( obj->Intersect( aRay, aHitInfo ) )
                     {
-                        aHitInfo.m_acc_node_info = nodeNum;
+                        aHitInfo.m_acc_node_info = hitNodeInfo( nodeNum, i, obj, aHitInfo );
                         hit = true;
                     }
                 }
@@ -1193,15 +1304,19 @@ bool CBVH_PBRT::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
 // !TODO: this may be optimized
 bool CBVH_PBRT::Intersect( const RAY &aRay,
                            HITINFO &aHitInfo,
-                           unsigned int aAccNodeInfo ) const
+                           uint64_t aAccNodeInfo ) const
 {
     if( !m_nodes )
         return false;
 
     bool hit = false;
 
+    // A hit in an instance goes back to the node of its mesh
+    const int primInLeaf = (int) ( ( aAccNodeInfo >> NODE_INFO_PRIM_SHIFT ) & NODE_INFO_PRIM_MASK );
+    const uint64_t meshNode = aAccNodeInfo >> NODE_INFO_MESH_SHIFT;
+
     // Follow ray through BVH nodes to find primitive intersections
-    int todoOffset = 0, nodeNum = aAccNodeInfo;
+    int todoOffset = 0, nodeNum = (int) ( aAccNodeInfo & NODE_INFO_LEAF_MASK );
     int todo[MAX_TODOS];
 
     while( true )
@@ -1222,8 +1337,18 @@ bool CBVH_PBRT::Intersect( const RAY &aRay,
                 // Intersect ray with primitives in leaf BVH node
                 for( int i = 0; i < node->nPrimitives; ++i )
                 {
-                    if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
-                                                                             aHitInfo ) )
+                    const COBJECT *obj = m_primitives[node->primitivesOffset + i];
+
+                    bool hitted;
+
+                    if( meshNode && ( i == primInLeaf )
+                            && ( obj->GetObjectType() == OBJ3D_INSTANCE ) )
+                        hitted = static_cast<const CINSTANCE *>( obj )->Intersect(
+                                aRay, aHitInfo, (unsigned int) ( meshNode - 1 ) );
+                    else
+                        hitted = obj->Intersect( aRay, aHitInfo );
+
+                    if( hitted )
                     {
                         //aHitInfo.m_acc_node_info = nodeNum;
                         hit = true;
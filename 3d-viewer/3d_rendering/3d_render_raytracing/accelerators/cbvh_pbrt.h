@@ -76,6 +76,7 @@
 
 // Forward Declarations
 struct BVHBuildNode;
+struct BVHBuildJob;
 struct BVHPrimitiveInfo;
 struct MortonPrimitive;
 
@@ -111,25 +112,65 @@ class  CBVH_PBRT : public CGENERICACCELERATOR
 {
 
 public:
+    /**
+     * @param aThreadCount: threads used by the build, 0 to use the number of cores; the
+     * resulting tree is the same for any count
+     */
     CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
                int aMaxPrimsInNode = 4,
-               SPLITMETHOD aSplitMethod = SPLIT_SAH );
+               SPLITMETHOD aSplitMethod = SPLIT_SAH,
+               size_t aThreadCount = 0 );
 
     ~CBVH_PBRT();
 
     // Imported from CGENERICACCELERATOR
     bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
-    bool Intersect( const RAY &aRay, HITINFO &aHitInfo, unsigned int aAccNodeInfo ) const override;
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo, uint64_t aAccNodeInfo ) const override;
     bool Intersect( const RAYPACKET &aRayPacket, HITINFO_PACKET *aHitInfoPacket ) const override;
     bool IntersectP( const RAY &aRay, float aMaxDistance ) const override;
 
 private:
 
+    /**
+     * @return the node info of a hit on the primitive aPrimInLeaf of the leaf aNodeNum; a
+     * hit in a CINSTANCE also keeps the node of its mesh, so that the hits on different
+     * parts of the mesh have different infos and the mesh can be entered again there
+     */
+    static uint64_t hitNodeInfo( int aNodeNum, int aPrimInLeaf, const COBJECT *aObject,
+                                 const HITINFO &aHitInfo );
+
+    /// Packet traversal with the SIMD tests of raypacket_simd.h
+    bool intersectPacketSimd( const RAYPACKET &aRayPacket,
+                              HITINFO_PACKET *aHitInfoPacket ) const;
+
+    /// Build with recursiveBuild(), the subtrees below the top levels on a CWORKER_POOL
+    BVHBuildNode *buildTopDown( std::vector<BVHPrimitiveInfo> &primitiveInfo,
+                                int *totalNodes,
+                                CONST_VECTOR_OBJECT &orderedPrims );
+
+    /**
+     * Create the node of the primitives from start to end, and build it; when jobs is not
+     * NULL, the nodes of at most jobPrimitives primitives are added to it to be built later
+     * @param addresses - keeps the allocated nodes
+     */
     BVHBuildNode *recursiveBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                   int start,
                                   int end,
                                   int *totalNodes,
-                                  CONST_VECTOR_OBJECT &orderedPrims );
+                                  CONST_VECTOR_OBJECT &orderedPrims,
+                                  std::list<void *> &addresses,
+                                  std::vector<BVHBuildJob> *jobs,
+                                  int jobPrimitives );
+
+    void buildNode( std::vector<BVHPrimitiveInfo> &primitiveInfo,
+                    BVHBuildNode *node,
+                    int start,
+                    int end,
+                    int *totalNodes,
+                    CONST_VECTOR_OBJECT &orderedPrims,
+                    std::list<void *> &addresses,
+                    std::vector<BVHBuildJob> *jobs,
+                    int jobPrimitives );
 
     BVHBuildNode *HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
                               int *totalNodes,
@@ -156,6 +197,7 @@ private:
     // BVH Private Data
     const int           m_maxPrimsInNode;
     SPLITMETHOD         m_splitMethod;
+    size_t              m_threadCount;
     CONST_VECTOR_OBJECT m_primitives;
     LinearBVHNode       *m_nodes;
 
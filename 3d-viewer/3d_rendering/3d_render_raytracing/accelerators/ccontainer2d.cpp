@@ -30,6 +30,7 @@
 #include "ccontainer2d.h"
 #include <vector>
 #include <mutex>
+#include <utility>
 #include <boost/range/algorithm/partition.hpp>
 #include <boost/range/algorithm/nth_element.hpp>
 #include <wx/debug.h>
@@ -262,6 +263,17 @@ CBVHCONTAINER2D::~CBVHCONTAINER2D()
 }
 
 
+void CBVHCONTAINER2D::Swap( CBVHCONTAINER2D &aOther )
+{
+    std::swap( m_bbox, aOther.m_bbox );
+    m_objects.swap( aOther.m_objects );
+
+    std::swap( m_isInitialized, aOther.m_isInitialized );
+    m_elements_to_delete.swap( aOther.m_elements_to_delete );
+    std::swap( m_Tree, aOther.m_Tree );
+}
+
+
 #define BVH_CONTAINER2D_MAX_OBJ_PER_LEAF 4
 
 
@@ -105,6 +105,11 @@ public:
 
     void BuildBVH();
 
+    /**
+     * @brief Swap - Exchange the objects and the BVH with aOther
+     */
+    void Swap( CBVHCONTAINER2D &aOther );
+
 private:
     bool m_isInitialized;
     std::list<BVH_CONTAINER_NODE_2D *> m_elements_to_delete;
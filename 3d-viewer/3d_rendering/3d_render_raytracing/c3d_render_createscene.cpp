@@ -34,6 +34,7 @@
 #include "shapes3D/clayeritem.h"
 #include "shapes3D/ccylinder.h"
 #include "shapes3D/ctriangle.h"
+#include "shapes3D/cinstance.h"
 #include "shapes2D/citemlayercsg2d.h"
 #include "shapes2D/cring2d.h"
 #include "shapes2D/cpolygon2d.h"
@@ -251,6 +252,7 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
     m_reloadRequested = false;
 
     m_model_materials.clear();
+    clear_3D_model_meshes();
 
     COBJECT2D_STATS::Instance().ResetStats();
     COBJECT3D_STATS::Instance().ResetStats();
@@ -1194,6 +1196,25 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Without a cache manager (e.g. rendering from the command line), only the board
+    // is rendered
+    if( !m_settings.Get3DCacheManager() )
+        return;
+
+    // Load all the models at once, in parallel, into the cache
+    std::vector< wxString > modelFiles;
+
+    for( auto module : m_settings.GetBoard()->Modules() )
+    {
+        if( m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
+        {
+            for( const MODULE_3D_SETTINGS& model : module->Models() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    m_settings.Get3DCacheManager()->Preload( modelFiles );
+
     // Go for all modules
     for( auto module : m_settings.GetBoard()->Modules() )
     {
@@ -1293,6 +1314,50 @@ void C3D_RENDER_RAYTRACING::load_3D_models()
 void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
                                            const glm::mat4 &aModelMatrix )
 {
+    wxASSERT( a3DModel != NULL );
+
+    if( a3DModel == NULL )
+        return;
+
+    // The triangles of a model are created once, and shared by all its placements.  They
+    // are kept in 3D units, so the procedural textures keep their scale.  A mirrored
+    // placement gets a mirrored copy: the instances must not mirror, as the triangles are
+    // only hit from their front side.
+    const float unitsFactor = m_settings.BiuTo3Dunits() * UNITS3D_TO_UNITSPCB;
+    const bool  mirrored = glm::determinant( glm::mat3( aModelMatrix ) ) < 0.0f;
+
+    const glm::mat4 meshMatrix = glm::scale( glm::mat4( 1.0f ),
+                                             SFVEC3F( mirrored ? -unitsFactor : unitsFactor,
+                                                      unitsFactor,
+                                                      unitsFactor ) );
+
+    CINSTANCEDMESH *&mesh = m_model_meshes[ std::make_pair( a3DModel, mirrored ) ];
+
+    if( mesh == NULL )
+    {
+        mesh = new CINSTANCEDMESH;
+        add_3D_model_triangles( mesh->Objects(), a3DModel, meshMatrix );
+        mesh->Build();
+    }
+
+    if( !mesh->IsEmpty() )
+        m_object_container.Add( new CINSTANCE( mesh, aModelMatrix * glm::inverse( meshMatrix ) ) );
+}
+
+
+void C3D_RENDER_RAYTRACING::clear_3D_model_meshes()
+{
+    for( auto& modelMesh : m_model_meshes )
+        delete modelMesh.second;
+
+    m_model_meshes.clear();
+}
+
+
+void C3D_RENDER_RAYTRACING::add_3D_model_triangles( CCONTAINER &aDstContainer,
+                                                    const S3DMODEL *a3DModel,
+                                                    const glm::mat4 &aModelMatrix )
+{
 
     // Validate a3DModel pointers
     wxASSERT( a3DModel != NULL );
@@ -1502,7 +1567,7 @@ void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
 
 
 
-                        m_object_container.Add( newTriangle );
+                        aDstContainer.Add( newTriangle );
                         newTriangle->SetMaterial( (const CMATERIAL *)&blinn_material );
 
                         if( mesh.m_Color == NULL )
@@ -37,9 +37,12 @@
 #include "clight.h"
 #include "../cpostshader_ssao.h"
 #include "cmaterial.h"
+#include "cworker_pool.h"
 #include <plugins/3dapi/c3dmodel.h>
 
 #include <map>
+#include <utility>
+#include <wx/image.h>
 
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
@@ -47,6 +50,11 @@ typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 /// Maps a S3DMODEL pointer with a created CBLINN_PHONG_MATERIAL vector
 typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 
+class CINSTANCEDMESH;
+
+/// Maps a S3DMODEL pointer, and whether it is mirrored, with its triangles
+typedef std::map< std::pair< const S3DMODEL *, bool >, CINSTANCEDMESH * > MAP_MODEL_MESHES;
+
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
@@ -69,6 +77,29 @@ public:
 
     int GetWaitForEditingTimeOut() override;
 
+    /**
+     * @brief PrepareScene - Build the scene now if a reload was requested, instead of
+     * on the next render
+     * @param aStatusTextReporter: a pointer to the status progress reporter
+     */
+    void PrepareScene( REPORTER *aStatusTextReporter = NULL );
+
+    /**
+     * @brief RenderImage - Raytrace the scene at full quality, without OpenGL, so it
+     * can run without any window (e.g. from the command line). The camera must be set to
+     * the same size.
+     * @param aSize: the image size, in pixels
+     * @param aStatusTextReporter: a pointer to the status progress reporter
+     * @return the rendered image, with the background around the traced area
+     */
+    wxImage RenderImage( const wxSize &aSize, REPORTER *aStatusTextReporter = NULL );
+
+    /**
+     * @brief GetTracedSize - Get the size of the area actually traced, for the current
+     * window size (it is a bit smaller, a multiple of the ray packets size)
+     */
+    SFVEC2UI GetTracedSize() const { return m_realBufferSize; }
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -135,6 +166,9 @@ private:
 
     CPOSTSHADER_SSAO m_postshader_ssao;
 
+    /// Threads that render the blocks and the post processing, kept between the passes
+    CWORKER_POOL m_workerPool;
+
     CLIGHTCONTAINER m_lights;
 
     CDIRECTIONALLIGHT *m_camera_light;
@@ -195,12 +229,23 @@ private:
     void insert3DViaHole( const VIA* aVia );
     void insert3DPadHole( const D_PAD* aPad );
     void load_3D_models();
+
+    /// Add a placement of a model, as an instance of its triangles
     void add_3D_models( const S3DMODEL *a3DModel,
                         const glm::mat4 &aModelMatrix );
 
+    void add_3D_model_triangles( CCONTAINER &aDstContainer,
+                                 const S3DMODEL *a3DModel,
+                                 const glm::mat4 &aModelMatrix );
+
+    void clear_3D_model_meshes();
+
     /// Stores materials of the 3D models
     MAP_MODEL_MATERIALS m_model_materials;
 
+    /// Stores the triangles of the 3D models, shared by all their placements
+    MAP_MODEL_MESHES m_model_meshes;
+
     void initialize_block_positions();
 
     void render( GLubyte *ptrPBO, REPORTER *aStatusTextReporter );
@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cworker_pool.cpp
+ * @brief implements a pool of threads kept between the render passes
+ */
+
+#include "cworker_pool.h"
+
+#include <algorithm>
+
+
+CWORKER_POOL::CWORKER_POOL( size_t aThreadCount ) :
+    m_job( nullptr ),
+    m_jobNumber( 0 ),
+    m_running( 0 ),
+    m_quit( false )
+{
+    if( aThreadCount == 0 )
+        aThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_threads.emplace_back( &CWORKER_POOL::workerLoop, this );
+}
+
+
+CWORKER_POOL::~CWORKER_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_quit = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for( std::thread &thread : m_threads )
+        thread.join();
+}
+
+
+void CWORKER_POOL::Run( const std::function<void()> &aJob )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    m_job = &aJob;
+    m_running = m_threads.size();
+    m_jobNumber++;
+
+    m_wakeUp.notify_all();
+    m_done.wait( lock, [this]() { return m_running == 0; } );
+
+    m_job = nullptr;
+}
+
+
+void CWORKER_POOL::workerLoop()
+{
+    unsigned long long lastJobNumber = 0;
+
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    while( true )
+    {
+        m_wakeUp.wait( lock, [&]() { return m_quit || ( m_jobNumber != lastJobNumber ); } );
+
+        if( m_quit )
+            return;
+
+        lastJobNumber = m_jobNumber;
+        const std::function<void()> *job = m_job;
+
+        lock.unlock();
+        ( *job )();
+        lock.lock();
+
+        if( --m_running == 0 )
+            m_done.notify_one();
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cworker_pool.h
+ * @brief implements a pool of threads kept between the render passes
+ */
+
+#ifndef _CWORKER_POOL_H_
+#define _CWORKER_POOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Class CWORKER_POOL
+ * keeps a set of threads waiting for jobs, so each render pass does not have to
+ * create (and wait for) new threads.
+ */
+class CWORKER_POOL
+{
+public:
+    /**
+     * @param aThreadCount: number of threads, 0 to use the number of cores (at least 2)
+     */
+    explicit CWORKER_POOL( size_t aThreadCount = 0 );
+
+    ~CWORKER_POOL();
+
+    size_t GetThreadCount() const { return m_threads.size(); }
+
+    /**
+     * @brief Run - Run aJob on every thread of the pool, and wait until all of them
+     * return. The calling thread sleeps until it is signaled by the last one.
+     * The job usually takes its work items from a shared atomic counter.
+     * It must not be called from a job.
+     * @param aJob: the job to run
+     */
+    void Run( const std::function<void()> &aJob );
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread>     m_threads;
+
+    std::mutex                   m_mutex;
+    std::condition_variable      m_wakeUp;      ///< Signals a new job, or the end
+    std::condition_variable      m_done;        ///< Signals the end of the job
+
+    const std::function<void()> *m_job;
+    unsigned long long           m_jobNumber;   ///< Incremented for each new job
+    size_t                       m_running;     ///< Threads still running the job
+    bool                         m_quit;
+};
+
+#endif // _CWORKER_POOL_H_
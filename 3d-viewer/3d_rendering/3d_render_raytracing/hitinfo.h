@@ -31,6 +31,7 @@
 #define _HITINFO_H_
 
 #include "raypacket.h"
+#include <cstdint>
 
 //#define RAYTRACING_RAY_STATISTICS
 
@@ -44,7 +45,7 @@ struct HITINFO
 
     const COBJECT *pHitObject;          ///< ( 4) Object that was hitted
     SFVEC2F m_UV;                       ///< ( 8) 2-D texture coordinates
-    unsigned int m_acc_node_info;       ///< ( 4) The acc stores here the node that it hits
+    uint64_t m_acc_node_info;           ///< ( 8) The acc stores here the node that it hits
 
     SFVEC3F m_HitPoint;                 ///< (12) hit position
     float m_ShadowFactor;               ///< ( 4) Shadow attenuation (1.0 no shadow, 0.0f darkness)
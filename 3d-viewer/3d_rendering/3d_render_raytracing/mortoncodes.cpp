@@ -29,6 +29,10 @@
  */
 
 #include "mortoncodes.h"
+#include "cworker_pool.h"
+
+#include <algorithm>
+#include <atomic>
 
 
 // "Insert" a 0 bit after each of the 16 low bits of x
@@ -123,3 +127,97 @@ uint32_t DecodeMorton3Z( uint32_t code )
 {
   return Compact1By2( code >> 2 );
 }
+
+
+void RadixSortMorton( std::vector<MortonPrimitive> &aPrimitives, CWORKER_POOL &aPool )
+{
+    const size_t nPrimitives = aPrimitives.size();
+
+    const int bitsPerPass = 6;
+    const int nBits = 30;
+    const int nPasses = nBits / bitsPerPass;
+    const int nBuckets = 1 << bitsPerPass;
+    const uint32_t bitMask = nBuckets - 1;
+
+    static_assert( ( nBits % bitsPerPass ) == 0, "radix passes must cover all the bits" );
+
+    // Below this, the threads would cost more than they save
+    const size_t minChunkSize = 16384;
+
+    const size_t nChunks = std::max<size_t>( 1, std::min( aPool.GetThreadCount(),
+                                                          nPrimitives / minChunkSize ) );
+
+    std::vector<MortonPrimitive> tempVector( nPrimitives );
+
+    // Per chunk bucket counts, then the output offsets of each chunk bucket
+    std::vector<size_t> chunkBuckets( nChunks * nBuckets );
+
+    for( int pass = 0; pass < nPasses; ++pass )
+    {
+        const int lowBit = pass * bitsPerPass;
+
+        const std::vector<MortonPrimitive> &in = ( pass & 1 ) ? tempVector : aPrimitives;
+        std::vector<MortonPrimitive> &out = ( pass & 1 ) ? aPrimitives : tempVector;
+
+        auto countChunk = [&]( size_t aChunk )
+        {
+            size_t *count = &chunkBuckets[aChunk * nBuckets];
+            const size_t end = ( aChunk + 1 ) * nPrimitives / nChunks;
+
+            std::fill( count, count + nBuckets, 0 );
+
+            for( size_t i = aChunk * nPrimitives / nChunks; i < end; ++i )
+                ++count[( in[i].mortonCode >> lowBit ) & bitMask];
+        };
+
+        auto scatterChunk = [&]( size_t aChunk )
+        {
+            size_t *offset = &chunkBuckets[aChunk * nBuckets];
+            const size_t end = ( aChunk + 1 ) * nPrimitives / nChunks;
+
+            for( size_t i = aChunk * nPrimitives / nChunks; i < end; ++i )
+                out[offset[( in[i].mortonCode >> lowBit ) & bitMask]++] = in[i];
+        };
+
+        auto runChunks = [&]( const std::function<void( size_t )> &aFunc )
+        {
+            if( nChunks == 1 )
+            {
+                aFunc( 0 );
+                return;
+            }
+
+            std::atomic<size_t> nextChunk( 0 );
+
+            aPool.Run( [&]()
+            {
+                for( size_t chunk = nextChunk.fetch_add( 1 ); chunk < nChunks;
+                     chunk = nextChunk.fetch_add( 1 ) )
+                    aFunc( chunk );
+            } );
+        };
+
+        runChunks( countChunk );
+
+        // A bucket of a chunk goes after the same bucket of the previous chunks, so the
+        // order of equal digits is kept
+        size_t startIndex = 0;
+
+        for( int bucket = 0; bucket < nBuckets; ++bucket )
+        {
+            for( size_t chunk = 0; chunk < nChunks; ++chunk )
+            {
+                const size_t count = chunkBuckets[chunk * nBuckets + bucket];
+
+                chunkBuckets[chunk * nBuckets + bucket] = startIndex;
+                startIndex += count;
+            }
+        }
+
+        runChunks( scatterChunk );
+    }
+
+    // Copy final result from _tempVector_, if needed
+    if( nPasses & 1 )
+        std::swap( aPrimitives, tempVector );
+}
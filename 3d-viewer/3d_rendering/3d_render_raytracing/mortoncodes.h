@@ -33,6 +33,16 @@
 #define _MORTONCODES_H_
 
 #include <cstdint>
+#include <vector>
+
+class CWORKER_POOL;
+
+/// A primitive, by its index, with the Morton code of its position
+struct MortonPrimitive
+{
+    int primitiveIndex;
+    uint32_t mortonCode;
+};
 
 uint32_t EncodeMorton2( uint32_t x, uint32_t y );
 uint32_t EncodeMorton3( uint32_t x, uint32_t y, uint32_t z );
@@ -44,4 +54,14 @@ uint32_t DecodeMorton3X( uint32_t code );
 uint32_t DecodeMorton3Y( uint32_t code );
 uint32_t DecodeMorton3Z( uint32_t code );
 
+/**
+ * @brief RadixSortMorton - Sort primitives by the 30 low bits of their Morton codes. The sort
+ * is stable, so the result does not depend on the number of threads.
+ * Each pass splits the primitives in one chunk per thread of the pool: the chunks count
+ * their buckets, then scatter to the offsets given by a prefix sum of all counts.
+ * @param aPrimitives: the primitives to sort
+ * @param aPool: the threads to use; small arrays are sorted on the calling thread
+ */
+void RadixSortMorton( std::vector<MortonPrimitive> &aPrimitives, CWORKER_POOL &aPool );
+
 #endif // _MORTONCODES_H_
@@ -0,0 +1,524 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.cpp
+ * @brief SSE2 / AVX tests of the rays of a packet against bounding boxes and triangles
+ */
+
+#include "raypacket_simd.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define RAYPACKET_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// The AVX functions are compiled for AVX on their own, and only called after checking
+// the processor, so the build does not need to target it
+#if defined( RAYPACKET_USE_SSE2 ) && ( defined( __clang__ ) || __GNUC__ >= 5 )
+#define RAYPACKET_USE_AVX
+#include <immintrin.h>
+#define RAYPACKET_TARGET_AVX __attribute__( ( target( "avx" ) ) )
+#endif
+
+
+static_assert( RAYPACKET_RAYS_PER_PACKET <= 64, "the packet rays must fit in a RAYPACKET_MASK_T" );
+static_assert( RAYPACKET_RAYS_PER_PACKET % 8 == 0, "the packet rays must fill the AVX registers" );
+
+
+// The far distance to a box is increased by a few ULPs, so the rays grazing its
+// faces are kept as the scalar test does
+static const float s_farScale = 1.0f + 4.0f * FLT_EPSILON;
+
+
+static RAYPACKET_MASK_T raysRange( unsigned int aFirst, unsigned int aLast )
+{
+    const RAYPACKET_MASK_T all = ~(RAYPACKET_MASK_T) 0;
+    const RAYPACKET_MASK_T last = ( aLast >= 64 ) ? all : ( ( (RAYPACKET_MASK_T) 1 << aLast ) - 1 );
+
+    return last & ( all << aFirst );
+}
+
+
+// An infinite inverse direction gives a NaN distance to the planes going through the
+// ray origin, the largest finite value gives 0 as expected
+static float finiteInvDir( float aInvDir )
+{
+    return std::isfinite( aInvDir ) ? aInvDir : std::copysign( FLT_MAX, aInvDir );
+}
+
+
+void RAYPACKET_SOA::Init( const RAYPACKET &aRayPacket, const HITINFO_PACKET *aHitInfoPacket )
+{
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        const RAY &ray = aRayPacket.m_ray[i];
+
+        m_orgX[i] = ray.m_Origin.x;
+        m_orgY[i] = ray.m_Origin.y;
+        m_orgZ[i] = ray.m_Origin.z;
+
+        m_dirX[i] = ray.m_Dir.x;
+        m_dirY[i] = ray.m_Dir.y;
+        m_dirZ[i] = ray.m_Dir.z;
+
+        m_invDirX[i] = finiteInvDir( ray.m_InvDir.x );
+        m_invDirY[i] = finiteInvDir( ray.m_InvDir.y );
+        m_invDirZ[i] = finiteInvDir( ray.m_InvDir.z );
+
+        m_tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+    }
+}
+
+
+// Scalar versions, for the processors without the instruction sets below
+// /////////////////////////////////////////////////////////////////////////////
+
+static RAYPACKET_MASK_T intersectBBoxScalar( const RAYPACKET_SOA &aPacket,
+                                             const CBBOX &aBBox,
+                                             unsigned int aFirst )
+{
+    const SFVEC3F &bmin = aBBox.Min();
+    const SFVEC3F &bmax = aBBox.Max();
+    RAYPACKET_MASK_T result = 0;
+
+    for( unsigned int i = aFirst; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        const float t0x = ( bmin.x - aPacket.m_orgX[i] ) * aPacket.m_invDirX[i];
+        const float t1x = ( bmax.x - aPacket.m_orgX[i] ) * aPacket.m_invDirX[i];
+        const float t0y = ( bmin.y - aPacket.m_orgY[i] ) * aPacket.m_invDirY[i];
+        const float t1y = ( bmax.y - aPacket.m_orgY[i] ) * aPacket.m_invDirY[i];
+        const float t0z = ( bmin.z - aPacket.m_orgZ[i] ) * aPacket.m_invDirZ[i];
+        const float t1z = ( bmax.z - aPacket.m_orgZ[i] ) * aPacket.m_invDirZ[i];
+
+        const float tNear = std::max( std::max( std::min( t0x, t1x ), std::min( t0y, t1y ) ),
+                                      std::min( t0z, t1z ) );
+        const float tFar = std::min( std::min( std::max( t0x, t1x ), std::max( t0y, t1y ) ),
+                                     std::max( t0z, t1z ) ) * s_farScale;
+
+        if( ( tNear <= tFar ) && ( tFar >= 0.0f ) && ( tNear < aPacket.m_tHit[i] ) )
+            result |= (RAYPACKET_MASK_T) 1 << i;
+    }
+
+    return result;
+}
+
+
+static RAYPACKET_MASK_T intersectTriangleScalar( const RAYPACKET_SOA &aPacket,
+                                                 const RAYPACKET_TRIANGLE &aTriangle,
+                                                 unsigned int aFirst,
+                                                 unsigned int aLast )
+{
+    const float *org[3] = { aPacket.m_orgX, aPacket.m_orgY, aPacket.m_orgZ };
+    const float *dir[3] = { aPacket.m_dirX, aPacket.m_dirY, aPacket.m_dirZ };
+    const RAYPACKET_TRIANGLE &tri = aTriangle;
+    RAYPACKET_MASK_T result = 0;
+
+    for( unsigned int i = aFirst; i < aLast; ++i )
+    {
+        const float lnd = 1.0f / ( dir[tri.m_k][i] + tri.m_nu * dir[tri.m_ku][i] +
+                                   tri.m_nv * dir[tri.m_kv][i] );
+        const float t = ( tri.m_nd - org[tri.m_k][i] - tri.m_nu * org[tri.m_ku][i] -
+                          tri.m_nv * org[tri.m_kv][i] ) * lnd;
+
+        if( !( ( aPacket.m_tHit[i] > t ) && ( t > 0.0f ) ) )
+            continue;
+
+        const float hu = org[tri.m_ku][i] + t * dir[tri.m_ku][i] - tri.m_au;
+        const float hv = org[tri.m_kv][i] + t * dir[tri.m_kv][i] - tri.m_av;
+        const float beta = hv * tri.m_bnu + hu * tri.m_bnv;
+        const float gamma = hu * tri.m_cnu + hv * tri.m_cnv;
+
+        if( ( beta < 0.0f ) || ( gamma < 0.0f ) || ( ( beta + gamma ) > 1.0f ) )
+            continue;
+
+        if( ( aPacket.m_dirX[i] * tri.m_n.x + aPacket.m_dirY[i] * tri.m_n.y +
+              aPacket.m_dirZ[i] * tri.m_n.z ) > 0.0f )
+            continue;
+
+        result |= (RAYPACKET_MASK_T) 1 << i;
+    }
+
+    return result;
+}
+
+
+#ifdef RAYPACKET_USE_SSE2
+
+// SSE2, 4 rays at a time
+// /////////////////////////////////////////////////////////////////////////////
+
+static RAYPACKET_MASK_T intersectBBoxSSE2( const RAYPACKET_SOA &aPacket,
+                                           const CBBOX &aBBox,
+                                           unsigned int aFirst )
+{
+    const __m128 minX = _mm_set1_ps( aBBox.Min().x );
+    const __m128 minY = _mm_set1_ps( aBBox.Min().y );
+    const __m128 minZ = _mm_set1_ps( aBBox.Min().z );
+    const __m128 maxX = _mm_set1_ps( aBBox.Max().x );
+    const __m128 maxY = _mm_set1_ps( aBBox.Max().y );
+    const __m128 maxZ = _mm_set1_ps( aBBox.Max().z );
+    const __m128 farScale = _mm_set1_ps( s_farScale );
+    const __m128 zero = _mm_setzero_ps();
+
+    RAYPACKET_MASK_T result = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < RAYPACKET_RAYS_PER_PACKET; i += 4 )
+    {
+        const __m128 orgX = _mm_load_ps( &aPacket.m_orgX[i] );
+        const __m128 orgY = _mm_load_ps( &aPacket.m_orgY[i] );
+        const __m128 orgZ = _mm_load_ps( &aPacket.m_orgZ[i] );
+        const __m128 invX = _mm_load_ps( &aPacket.m_invDirX[i] );
+        const __m128 invY = _mm_load_ps( &aPacket.m_invDirY[i] );
+        const __m128 invZ = _mm_load_ps( &aPacket.m_invDirZ[i] );
+
+        const __m128 t0x = _mm_mul_ps( _mm_sub_ps( minX, orgX ), invX );
+        const __m128 t1x = _mm_mul_ps( _mm_sub_ps( maxX, orgX ), invX );
+        const __m128 t0y = _mm_mul_ps( _mm_sub_ps( minY, orgY ), invY );
+        const __m128 t1y = _mm_mul_ps( _mm_sub_ps( maxY, orgY ), invY );
+        const __m128 t0z = _mm_mul_ps( _mm_sub_ps( minZ, orgZ ), invZ );
+        const __m128 t1z = _mm_mul_ps( _mm_sub_ps( maxZ, orgZ ), invZ );
+
+        const __m128 tNear = _mm_max_ps( _mm_max_ps( _mm_min_ps( t0x, t1x ),
+                                                     _mm_min_ps( t0y, t1y ) ),
+                                         _mm_min_ps( t0z, t1z ) );
+        const __m128 tFar = _mm_mul_ps( _mm_min_ps( _mm_min_ps( _mm_max_ps( t0x, t1x ),
+                                                                _mm_max_ps( t0y, t1y ) ),
+                                                    _mm_max_ps( t0z, t1z ) ),
+                                        farScale );
+
+        const __m128 hit = _mm_and_ps( _mm_and_ps( _mm_cmple_ps( tNear, tFar ),
+                                                   _mm_cmpge_ps( tFar, zero ) ),
+                                       _mm_cmplt_ps( tNear, _mm_load_ps( &aPacket.m_tHit[i] ) ) );
+
+        result |= (RAYPACKET_MASK_T) _mm_movemask_ps( hit ) << i;
+    }
+
+    return result & raysRange( aFirst, RAYPACKET_RAYS_PER_PACKET );
+}
+
+
+static RAYPACKET_MASK_T intersectTriangleSSE2( const RAYPACKET_SOA &aPacket,
+                                               const RAYPACKET_TRIANGLE &aTriangle,
+                                               unsigned int aFirst,
+                                               unsigned int aLast )
+{
+    const float *org[3] = { aPacket.m_orgX, aPacket.m_orgY, aPacket.m_orgZ };
+    const float *dir[3] = { aPacket.m_dirX, aPacket.m_dirY, aPacket.m_dirZ };
+
+    const float *orgK  = org[aTriangle.m_k];
+    const float *orgKu = org[aTriangle.m_ku];
+    const float *orgKv = org[aTriangle.m_kv];
+    const float *dirK  = dir[aTriangle.m_k];
+    const float *dirKu = dir[aTriangle.m_ku];
+    const float *dirKv = dir[aTriangle.m_kv];
+
+    const __m128 nu  = _mm_set1_ps( aTriangle.m_nu );
+    const __m128 nv  = _mm_set1_ps( aTriangle.m_nv );
+    const __m128 nd  = _mm_set1_ps( aTriangle.m_nd );
+    const __m128 au  = _mm_set1_ps( aTriangle.m_au );
+    const __m128 av  = _mm_set1_ps( aTriangle.m_av );
+    const __m128 bnu = _mm_set1_ps( aTriangle.m_bnu );
+    const __m128 bnv = _mm_set1_ps( aTriangle.m_bnv );
+    const __m128 cnu = _mm_set1_ps( aTriangle.m_cnu );
+    const __m128 cnv = _mm_set1_ps( aTriangle.m_cnv );
+    const __m128 nX  = _mm_set1_ps( aTriangle.m_n.x );
+    const __m128 nY  = _mm_set1_ps( aTriangle.m_n.y );
+    const __m128 nZ  = _mm_set1_ps( aTriangle.m_n.z );
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps( 1.0f );
+
+    RAYPACKET_MASK_T result = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < aLast; i += 4 )
+    {
+        const __m128 dKu = _mm_load_ps( &dirKu[i] );
+        const __m128 dKv = _mm_load_ps( &dirKv[i] );
+        const __m128 oKu = _mm_load_ps( &orgKu[i] );
+        const __m128 oKv = _mm_load_ps( &orgKv[i] );
+
+        // Same operations, in the same order, as CTRIANGLE::Intersect
+        const __m128 lnd = _mm_div_ps( one, _mm_add_ps( _mm_add_ps( _mm_load_ps( &dirK[i] ),
+                                                                    _mm_mul_ps( nu, dKu ) ),
+                                                        _mm_mul_ps( nv, dKv ) ) );
+        const __m128 t = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( nd,
+                                                                         _mm_load_ps( &orgK[i] ) ),
+                                                             _mm_mul_ps( nu, oKu ) ),
+                                                 _mm_mul_ps( nv, oKv ) ),
+                                     lnd );
+
+        __m128 hit = _mm_and_ps( _mm_cmpgt_ps( _mm_load_ps( &aPacket.m_tHit[i] ), t ),
+                                 _mm_cmpgt_ps( t, zero ) );
+
+        if( !_mm_movemask_ps( hit ) )
+            continue;
+
+        const __m128 hu = _mm_sub_ps( _mm_add_ps( oKu, _mm_mul_ps( t, dKu ) ), au );
+        const __m128 hv = _mm_sub_ps( _mm_add_ps( oKv, _mm_mul_ps( t, dKv ) ), av );
+        const __m128 beta = _mm_add_ps( _mm_mul_ps( hv, bnu ), _mm_mul_ps( hu, bnv ) );
+        const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, cnu ), _mm_mul_ps( hv, cnv ) );
+
+        const __m128 dX = _mm_load_ps( &aPacket.m_dirX[i] );
+        const __m128 dY = _mm_load_ps( &aPacket.m_dirY[i] );
+        const __m128 dZ = _mm_load_ps( &aPacket.m_dirZ[i] );
+        const __m128 dot = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dX, nX ), _mm_mul_ps( dY, nY ) ),
+                                       _mm_mul_ps( dZ, nZ ) );
+
+        // The "not" comparisons reject the same values as the scalar tests
+        hit = _mm_and_ps( hit, _mm_and_ps( _mm_cmpnlt_ps( beta, zero ),
+                                           _mm_cmpnlt_ps( gamma, zero ) ) );
+        hit = _mm_and_ps( hit, _mm_and_ps( _mm_cmpngt_ps( _mm_add_ps( beta, gamma ), one ),
+                                           _mm_cmpngt_ps( dot, zero ) ) );
+
+        result |= (RAYPACKET_MASK_T) _mm_movemask_ps( hit ) << i;
+    }
+
+    return result & raysRange( aFirst, aLast );
+}
+
+#endif // RAYPACKET_USE_SSE2
+
+
+#ifdef RAYPACKET_USE_AVX
+
+// AVX, 8 rays at a time
+// /////////////////////////////////////////////////////////////////////////////
+
+RAYPACKET_TARGET_AVX
+static RAYPACKET_MASK_T intersectBBoxAVX( const RAYPACKET_SOA &aPacket,
+                                          const CBBOX &aBBox,
+                                          unsigned int aFirst )
+{
+    const __m256 minX = _mm256_set1_ps( aBBox.Min().x );
+    const __m256 minY = _mm256_set1_ps( aBBox.Min().y );
+    const __m256 minZ = _mm256_set1_ps( aBBox.Min().z );
+    const __m256 maxX = _mm256_set1_ps( aBBox.Max().x );
+    const __m256 maxY = _mm256_set1_ps( aBBox.Max().y );
+    const __m256 maxZ = _mm256_set1_ps( aBBox.Max().z );
+    const __m256 farScale = _mm256_set1_ps( s_farScale );
+    const __m256 zero = _mm256_setzero_ps();
+
+    RAYPACKET_MASK_T result = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < RAYPACKET_RAYS_PER_PACKET; i += 8 )
+    {
+        const __m256 orgX = _mm256_load_ps( &aPacket.m_orgX[i] );
+        const __m256 orgY = _mm256_load_ps( &aPacket.m_orgY[i] );
+        const __m256 orgZ = _mm256_load_ps( &aPacket.m_orgZ[i] );
+        const __m256 invX = _mm256_load_ps( &aPacket.m_invDirX[i] );
+        const __m256 invY = _mm256_load_ps( &aPacket.m_invDirY[i] );
+        const __m256 invZ = _mm256_load_ps( &aPacket.m_invDirZ[i] );
+
+        const __m256 t0x = _mm256_mul_ps( _mm256_sub_ps( minX, orgX ), invX );
+        const __m256 t1x = _mm256_mul_ps( _mm256_sub_ps( maxX, orgX ), invX );
+        const __m256 t0y = _mm256_mul_ps( _mm256_sub_ps( minY, orgY ), invY );
+        const __m256 t1y = _mm256_mul_ps( _mm256_sub_ps( maxY, orgY ), invY );
+        const __m256 t0z = _mm256_mul_ps( _mm256_sub_ps( minZ, orgZ ), invZ );
+        const __m256 t1z = _mm256_mul_ps( _mm256_sub_ps( maxZ, orgZ ), invZ );
+
+        const __m256 tNear = _mm256_max_ps( _mm256_max_ps( _mm256_min_ps( t0x, t1x ),
+                                                           _mm256_min_ps( t0y, t1y ) ),
+                                            _mm256_min_ps( t0z, t1z ) );
+        const __m256 tFar = _mm256_mul_ps(
+                _mm256_min_ps( _mm256_min_ps( _mm256_max_ps( t0x, t1x ),
+                                              _mm256_max_ps( t0y, t1y ) ),
+                               _mm256_max_ps( t0z, t1z ) ),
+                farScale );
+
+        const __m256 hit = _mm256_and_ps(
+                _mm256_and_ps( _mm256_cmp_ps( tNear, tFar, _CMP_LE_OQ ),
+                               _mm256_cmp_ps( tFar, zero, _CMP_GE_OQ ) ),
+                _mm256_cmp_ps( tNear, _mm256_load_ps( &aPacket.m_tHit[i] ), _CMP_LT_OQ ) );
+
+        result |= (RAYPACKET_MASK_T) _mm256_movemask_ps( hit ) << i;
+    }
+
+    return result & raysRange( aFirst, RAYPACKET_RAYS_PER_PACKET );
+}
+
+
+RAYPACKET_TARGET_AVX
+static RAYPACKET_MASK_T intersectTriangleAVX( const RAYPACKET_SOA &aPacket,
+                                              const RAYPACKET_TRIANGLE &aTriangle,
+                                              unsigned int aFirst,
+                                              unsigned int aLast )
+{
+    const float *org[3] = { aPacket.m_orgX, aPacket.m_orgY, aPacket.m_orgZ };
+    const float *dir[3] = { aPacket.m_dirX, aPacket.m_dirY, aPacket.m_dirZ };
+
+    const float *orgK  = org[aTriangle.m_k];
+    const float *orgKu = org[aTriangle.m_ku];
+    const float *orgKv = org[aTriangle.m_kv];
+    const float *dirK  = dir[aTriangle.m_k];
+    const float *dirKu = dir[aTriangle.m_ku];
+    const float *dirKv = dir[aTriangle.m_kv];
+
+    const __m256 nu  = _mm256_set1_ps( aTriangle.m_nu );
+    const __m256 nv  = _mm256_set1_ps( aTriangle.m_nv );
+    const __m256 nd  = _mm256_set1_ps( aTriangle.m_nd );
+    const __m256 au  = _mm256_set1_ps( aTriangle.m_au );
+    const __m256 av  = _mm256_set1_ps( aTriangle.m_av );
+    const __m256 bnu = _mm256_set1_ps( aTriangle.m_bnu );
+    const __m256 bnv = _mm256_set1_ps( aTriangle.m_bnv );
+    const __m256 cnu = _mm256_set1_ps( aTriangle.m_cnu );
+    const __m256 cnv = _mm256_set1_ps( aTriangle.m_cnv );
+    const __m256 nX  = _mm256_set1_ps( aTriangle.m_n.x );
+    const __m256 nY  = _mm256_set1_ps( aTriangle.m_n.y );
+    const __m256 nZ  = _mm256_set1_ps( aTriangle.m_n.z );
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps( 1.0f );
+
+    RAYPACKET_MASK_T result = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < aLast; i += 8 )
+    {
+        const __m256 dKu = _mm256_load_ps( &dirKu[i] );
+        const __m256 dKv = _mm256_load_ps( &dirKv[i] );
+        const __m256 oKu = _mm256_load_ps( &orgKu[i] );
+        const __m256 oKv = _mm256_load_ps( &orgKv[i] );
+
+        // Same operations, in the same order, as CTRIANGLE::Intersect
+        const __m256 lnd = _mm256_div_ps(
+                one, _mm256_add_ps( _mm256_add_ps( _mm256_load_ps( &dirK[i] ),
+                                                   _mm256_mul_ps( nu, dKu ) ),
+                                    _mm256_mul_ps( nv, dKv ) ) );
+        const __m256 t = _mm256_mul_ps(
+                _mm256_sub_ps( _mm256_sub_ps( _mm256_sub_ps( nd, _mm256_load_ps( &orgK[i] ) ),
+                                              _mm256_mul_ps( nu, oKu ) ),
+                               _mm256_mul_ps( nv, oKv ) ),
+                lnd );
+
+        __m256 hit = _mm256_and_ps(
+                _mm256_cmp_ps( _mm256_load_ps( &aPacket.m_tHit[i] ), t, _CMP_GT_OQ ),
+                _mm256_cmp_ps( t, zero, _CMP_GT_OQ ) );
+
+        if( !_mm256_movemask_ps( hit ) )
+            continue;
+
+        const __m256 hu = _mm256_sub_ps( _mm256_add_ps( oKu, _mm256_mul_ps( t, dKu ) ), au );
+        const __m256 hv = _mm256_sub_ps( _mm256_add_ps( oKv, _mm256_mul_ps( t, dKv ) ), av );
+        const __m256 beta = _mm256_add_ps( _mm256_mul_ps( hv, bnu ), _mm256_mul_ps( hu, bnv ) );
+        const __m256 gamma = _mm256_add_ps( _mm256_mul_ps( hu, cnu ), _mm256_mul_ps( hv, cnv ) );
+
+        const __m256 dot = _mm256_add_ps(
+                _mm256_add_ps( _mm256_mul_ps( _mm256_load_ps( &aPacket.m_dirX[i] ), nX ),
+                               _mm256_mul_ps( _mm256_load_ps( &aPacket.m_dirY[i] ), nY ) ),
+                _mm256_mul_ps( _mm256_load_ps( &aPacket.m_dirZ[i] ), nZ ) );
+
+        // The unordered "not" comparisons reject the same values as the scalar tests
+        hit = _mm256_and_ps( hit, _mm256_and_ps( _mm256_cmp_ps( beta, zero, _CMP_NLT_UQ ),
+                                                 _mm256_cmp_ps( gamma, zero, _CMP_NLT_UQ ) ) );
+        hit = _mm256_and_ps( hit, _mm256_and_ps(
+                _mm256_cmp_ps( _mm256_add_ps( beta, gamma ), one, _CMP_NGT_UQ ),
+                _mm256_cmp_ps( dot, zero, _CMP_NGT_UQ ) ) );
+
+        result |= (RAYPACKET_MASK_T) _mm256_movemask_ps( hit ) << i;
+    }
+
+    return result & raysRange( aFirst, aLast );
+}
+
+#endif // RAYPACKET_USE_AVX
+
+
+// Selection of the instruction set
+// /////////////////////////////////////////////////////////////////////////////
+
+RAYPACKET_SIMD_LEVEL RAYPACKET_GetSupportedSimdLevel()
+{
+#ifdef RAYPACKET_USE_AVX
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports( "avx" ) )
+        return RAYPACKET_SIMD_AVX;
+#endif
+
+#ifdef RAYPACKET_USE_SSE2
+    return RAYPACKET_SIMD_SSE2;
+#else
+    return RAYPACKET_SIMD_NONE;
+#endif
+}
+
+
+static std::atomic<RAYPACKET_SIMD_LEVEL> s_simdLevel( RAYPACKET_GetSupportedSimdLevel() );
+
+
+RAYPACKET_SIMD_LEVEL RAYPACKET_GetSimdLevel()
+{
+    return s_simdLevel;
+}
+
+
+RAYPACKET_SIMD_LEVEL RAYPACKET_SetSimdLevel( RAYPACKET_SIMD_LEVEL aLevel )
+{
+    s_simdLevel = std::min( aLevel, RAYPACKET_GetSupportedSimdLevel() );
+
+    return s_simdLevel;
+}
+
+
+RAYPACKET_MASK_T RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aPacket,
+                                          const CBBOX &aBBox,
+                                          unsigned int aFirst )
+{
+    switch( s_simdLevel.load( std::memory_order_relaxed ) )
+    {
+#ifdef RAYPACKET_USE_AVX
+    case RAYPACKET_SIMD_AVX:
+        return intersectBBoxAVX( aPacket, aBBox, aFirst );
+#endif
+#ifdef RAYPACKET_USE_SSE2
+    case RAYPACKET_SIMD_SSE2:
+        return intersectBBoxSSE2( aPacket, aBBox, aFirst );
+#endif
+    default:
+        return intersectBBoxScalar( aPacket, aBBox, aFirst );
+    }
+}
+
+
+RAYPACKET_MASK_T RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aPacket,
+                                              const RAYPACKET_TRIANGLE &aTriangle,
+                                              unsigned int aFirst,
+                                              unsigned int aLast )
+{
+    switch( s_simdLevel.load( std::memory_order_relaxed ) )
+    {
+#ifdef RAYPACKET_USE_AVX
+    case RAYPACKET_SIMD_AVX:
+        return intersectTriangleAVX( aPacket, aTriangle, aFirst, aLast );
+#endif
+#ifdef RAYPACKET_USE_SSE2
+    case RAYPACKET_SIMD_SSE2:
+        return intersectTriangleSSE2( aPacket, aTriangle, aFirst, aLast );
+#endif
+    default:
+        return intersectTriangleScalar( aPacket, aTriangle, aFirst, aLast );
+    }
+}
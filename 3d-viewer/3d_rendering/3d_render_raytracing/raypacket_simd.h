@@ -0,0 +1,157 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.h
+ * @brief SSE2 / AVX tests of the rays of a packet against bounding boxes and triangles
+ */
+
+#ifndef _RAYPACKET_SIMD_H_
+#define _RAYPACKET_SIMD_H_
+
+#include "raypacket.h"
+#include "hitinfo.h"
+#include "shapes3D/cbbox.h"
+
+#include <cstdint>
+
+
+/// Instruction sets the packet tests can use, the scalar code being always available
+enum RAYPACKET_SIMD_LEVEL
+{
+    RAYPACKET_SIMD_NONE,    ///< The scalar code of the shapes, one ray at a time
+    RAYPACKET_SIMD_SSE2,    ///< 4 rays at a time
+    RAYPACKET_SIMD_AVX      ///< 8 rays at a time
+};
+
+
+/// A set of rays, one bit per ray of a packet
+typedef uint64_t RAYPACKET_MASK_T;
+
+
+/**
+ * The rays of a packet stored as arrays of each coordinate, as loaded by the SIMD tests
+ */
+struct RAYPACKET_SOA
+{
+    alignas( 32 ) float m_orgX[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_orgY[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_orgZ[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_dirX[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_dirY[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_dirZ[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDirX[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDirY[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDirZ[RAYPACKET_RAYS_PER_PACKET];
+
+    /// Distance of the current hit of each ray, it must follow the hit info of the packet
+    alignas( 32 ) float m_tHit[RAYPACKET_RAYS_PER_PACKET];
+
+    void Init( const RAYPACKET &aRayPacket, const HITINFO_PACKET *aHitInfoPacket );
+};
+
+
+/**
+ * The precalculated values of a triangle (see CTRIANGLE) used by its packet test
+ */
+struct RAYPACKET_TRIANGLE
+{
+    unsigned int m_k, m_ku, m_kv;       ///< Projection axis, and the two other axes
+    float m_nu, m_nv, m_nd;
+    float m_au, m_av;                   ///< First vertex, on the ku and kv axes
+    float m_bnu, m_bnv;
+    float m_cnu, m_cnv;
+    SFVEC3F m_n;                        ///< Face normal
+};
+
+
+/**
+ * @brief RAYPACKET_GetSimdLevel - Get the instruction set used by the packet tests.
+ * It is the best one supported by the processor, unless changed by RAYPACKET_SetSimdLevel.
+ */
+RAYPACKET_SIMD_LEVEL RAYPACKET_GetSimdLevel();
+
+/**
+ * @brief RAYPACKET_SetSimdLevel - Use another instruction set, e.g. to compare them
+ * @return the level set, lowered to the best one supported by the processor
+ */
+RAYPACKET_SIMD_LEVEL RAYPACKET_SetSimdLevel( RAYPACKET_SIMD_LEVEL aLevel );
+
+/**
+ * @brief RAYPACKET_GetSupportedSimdLevel - Get the best instruction set of the processor
+ */
+RAYPACKET_SIMD_LEVEL RAYPACKET_GetSupportedSimdLevel();
+
+/**
+ * @brief RAYPACKET_IntersectBBox - Test the rays of a packet against a bounding box
+ * @param aFirst: index of the first ray to test, the rays before it are not returned
+ * @return the rays that enter the box before their current hit (m_tHit)
+ */
+RAYPACKET_MASK_T RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aPacket,
+                                          const CBBOX &aBBox,
+                                          unsigned int aFirst );
+
+/**
+ * @brief RAYPACKET_IntersectTriangle - Test the rays aFirst to aLast - 1 of a packet
+ * against a triangle, with the same calculation as CTRIANGLE::Intersect.
+ * @return the rays that hit the triangle before their current hit (m_tHit)
+ */
+RAYPACKET_MASK_T RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aPacket,
+                                              const RAYPACKET_TRIANGLE &aTriangle,
+                                              unsigned int aFirst,
+                                              unsigned int aLast );
+
+/// Index of the first ray of a non empty mask
+inline unsigned int RAYPACKET_FirstRay( RAYPACKET_MASK_T aMask )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    return __builtin_ctzll( aMask );
+#else
+    unsigned int i = 0;
+
+    while( !( aMask & 1 ) )
+    {
+        aMask >>= 1;
+        ++i;
+    }
+
+    return i;
+#endif
+}
+
+/// Index of the last ray of a non empty mask
+inline unsigned int RAYPACKET_LastRay( RAYPACKET_MASK_T aMask )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    return 63 - __builtin_clzll( aMask );
+#else
+    unsigned int i = 63;
+
+    while( !( aMask >> i ) )
+        --i;
+
+    return i;
+#endif
+}
+
+#endif // _RAYPACKET_SIMD_H_
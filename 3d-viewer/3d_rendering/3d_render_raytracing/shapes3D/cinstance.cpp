@@ -0,0 +1,157 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cinstance.cpp
+ * @brief
+ */
+
+#include "cinstance.h"
+#include "../accelerators/cbvh_pbrt.h"
+
+
+CINSTANCEDMESH::CINSTANCEDMESH()
+{
+    m_accelerator = NULL;
+}
+
+
+CINSTANCEDMESH::~CINSTANCEDMESH()
+{
+    delete m_accelerator;
+    m_accelerator = NULL;
+}
+
+
+void CINSTANCEDMESH::Build()
+{
+    delete m_accelerator;
+    m_accelerator = new CBVH_PBRT( m_objects );
+}
+
+
+bool CINSTANCEDMESH::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
+{
+    return m_accelerator && m_accelerator->Intersect( aRay, aHitInfo );
+}
+
+
+bool CINSTANCEDMESH::Intersect( const RAY &aRay, HITINFO &aHitInfo, unsigned int aNode ) const
+{
+    return m_accelerator && m_accelerator->Intersect( aRay, aHitInfo, aNode );
+}
+
+
+bool CINSTANCEDMESH::IntersectP( const RAY &aRay, float aMaxDistance ) const
+{
+    return m_accelerator && m_accelerator->IntersectP( aRay, aMaxDistance );
+}
+
+
+CINSTANCE::CINSTANCE( const CINSTANCEDMESH *aMesh,
+                      const glm::mat4 &aTransform ) : COBJECT( OBJ3D_INSTANCE )
+{
+    m_mesh = aMesh;
+    m_toMesh = glm::inverse( aTransform );
+    m_normalMatrix = glm::transpose( glm::inverse( glm::mat3( aTransform ) ) );
+
+    m_bbox = aMesh->GetBBox();
+    m_bbox.ApplyTransformationAA( aTransform );
+    m_bbox.ScaleNextUp();
+    m_centroid = m_bbox.GetCenter();
+}
+
+
+void CINSTANCE::toMesh( const RAY &aRay, RAY &aMeshRay ) const
+{
+    aMeshRay.Init( SFVEC3F( m_toMesh * glm::vec4( aRay.m_Origin, 1.0f ) ),
+                   SFVEC3F( m_toMesh * glm::vec4( aRay.m_Dir, 0.0f ) ) );
+}
+
+
+void CINSTANCE::toScene( const RAY &aRay, const HITINFO &aMeshHitInfo, HITINFO &aHitInfo ) const
+{
+    // The object of the mesh and its UV are kept, the position and normal are
+    // brought back to the scene.  The node of the mesh is kept too: the accelerator
+    // of the scene combines it with its own, see CBVH_PBRT::hitNodeInfo()
+    aHitInfo = aMeshHitInfo;
+    aHitInfo.m_HitPoint = aRay.at( aMeshHitInfo.m_tHit );
+    aHitInfo.m_HitNormal = glm::normalize( m_normalMatrix * aMeshHitInfo.m_HitNormal );
+}
+
+
+bool CINSTANCE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
+{
+    RAY meshRay;
+    toMesh( aRay, meshRay );
+
+    HITINFO meshHitInfo = aHitInfo;
+
+    if( !m_mesh->Intersect( meshRay, meshHitInfo ) )
+        return false;
+
+    toScene( aRay, meshHitInfo, aHitInfo );
+
+    return true;
+}
+
+
+bool CINSTANCE::Intersect( const RAY &aRay, HITINFO &aHitInfo, unsigned int aMeshNode ) const
+{
+    RAY meshRay;
+    toMesh( aRay, meshRay );
+
+    HITINFO meshHitInfo = aHitInfo;
+
+    if( !m_mesh->Intersect( meshRay, meshHitInfo, aMeshNode ) )
+        return false;
+
+    toScene( aRay, meshHitInfo, aHitInfo );
+
+    return true;
+}
+
+
+bool CINSTANCE::IntersectP( const RAY &aRay, float aMaxDistance ) const
+{
+    RAY meshRay;
+    toMesh( aRay, meshRay );
+
+    return m_mesh->IntersectP( meshRay, aMaxDistance );
+}
+
+
+bool CINSTANCE::Intersects( const CBBOX &aBBox ) const
+{
+    return m_bbox.Intersects( aBBox );
+}
+
+
+SFVEC3F CINSTANCE::GetDiffuseColor( const HITINFO &aHitInfo ) const
+{
+    // The hits report the objects of the mesh, never the instance
+    if( aHitInfo.pHitObject && ( aHitInfo.pHitObject != this ) )
+        return aHitInfo.pHitObject->GetDiffuseColor( aHitInfo );
+
+    return SFVEC3F( 0.0f );
+}
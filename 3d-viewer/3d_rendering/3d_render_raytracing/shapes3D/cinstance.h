@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cinstance.h
+ * @brief Implements placements of a geometry shared by all of them, e.g. the 3D model of
+ * a footprint used many times on a board
+ */
+
+#ifndef _CINSTANCE_H_
+#define _CINSTANCE_H_
+
+#include "cobject.h"
+#include "../accelerators/ccontainer.h"
+#include "../accelerators/caccelerator.h"
+
+
+/**
+ * The objects of a geometry, in its own coordinates, with their own accelerator
+ */
+class CINSTANCEDMESH
+{
+public:
+    CINSTANCEDMESH();
+
+    ~CINSTANCEDMESH();
+
+    /// The objects to add the geometry to, before calling Build()
+    CCONTAINER &Objects() { return m_objects; }
+
+    /// Build the accelerator of the objects, once they are all added
+    void Build();
+
+    bool IsEmpty() const { return m_objects.GetList().empty(); }
+
+    const CBBOX &GetBBox() const { return m_objects.GetBBox(); }
+
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const;
+
+    /// Intersect only the node of the accelerator of a previous hit
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo, unsigned int aNode ) const;
+
+    bool IntersectP( const RAY &aRay, float aMaxDistance ) const;
+
+private:
+    CINSTANCEDMESH( const CINSTANCEDMESH &aOther );
+    const CINSTANCEDMESH &operator=( const CINSTANCEDMESH &aOther );
+
+    CCONTAINER           m_objects;
+    CGENERICACCELERATOR *m_accelerator;
+};
+
+
+/**
+ * A placement of a CINSTANCEDMESH
+ *
+ * The rays are transformed to the coordinates of the mesh (without normalizing their
+ * direction, so the hit distances are the same), and the hits back to the scene.  The hit
+ * object is the one of the mesh, so its material and colors are used.
+ */
+class CINSTANCE : public COBJECT
+{
+public:
+    /**
+     * @param aMesh - the shared geometry, that must outlive the instance
+     * @param aTransform - transforms the mesh coordinates to the scene ones; it must not
+     * mirror, as the triangles would then be culled from the wrong side
+     */
+    CINSTANCE( const CINSTANCEDMESH *aMesh, const glm::mat4 &aTransform );
+
+    // Imported from COBJECT
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
+    bool IntersectP( const RAY &aRay, float aMaxDistance ) const override;
+    bool Intersects( const CBBOX &aBBox ) const override;
+    SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
+
+    /**
+     * Intersect only a node of the mesh, used by the accelerators to trace again from a
+     * previous hit in this instance
+     * @param aMeshNode - the node of the mesh accelerator that was hit
+     */
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo, unsigned int aMeshNode ) const;
+
+private:
+    void toMesh( const RAY &aRay, RAY &aMeshRay ) const;
+
+    void toScene( const RAY &aRay, const HITINFO &aMeshHitInfo, HITINFO &aHitInfo ) const;
+
+    const CINSTANCEDMESH *m_mesh;
+    glm::mat4             m_toMesh;
+    glm::mat3             m_normalMatrix;
+};
+
+#endif // _CINSTANCE_H_
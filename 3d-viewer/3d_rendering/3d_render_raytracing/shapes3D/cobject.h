@@ -43,6 +43,7 @@ enum OBJECT3D_TYPE
     OBJ3D_XYPLANE,
     OBJ3D_ROUNDSEG,
     OBJ3D_TRIANGLE,
+    OBJ3D_INSTANCE,
     OBJ3D_MAX
 };
 
@@ -93,6 +94,8 @@ public:
 
     const CBBOX &GetBBox() const { return m_bbox; }
 
+    OBJECT3D_TYPE GetObjectType() const { return m_obj_type; }
+
     const SFVEC3F &GetCentroid() const { return m_centroid; }
 };
 
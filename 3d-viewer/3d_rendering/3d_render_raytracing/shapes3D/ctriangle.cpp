@@ -269,6 +269,47 @@ bool CTRIANGLE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
 }
 
 
+RAYPACKET_MASK_T CTRIANGLE::IntersectPacket( const RAYPACKET_SOA &aPacket,
+                                             const RAY *aRays,
+                                             unsigned int aFirst,
+                                             unsigned int aLast,
+                                             HITINFO_PACKET *aHitInfoPacket ) const
+{
+    RAYPACKET_TRIANGLE triangle;
+
+    triangle.m_k  = m_k;
+    triangle.m_ku = s_modulo[m_k + 1];
+    triangle.m_kv = s_modulo[m_k + 2];
+    triangle.m_nu = m_nu;
+    triangle.m_nv = m_nv;
+    triangle.m_nd = m_nd;
+    triangle.m_au = m_vertex[0][triangle.m_ku];
+    triangle.m_av = m_vertex[0][triangle.m_kv];
+    triangle.m_bnu = m_bnu;
+    triangle.m_bnv = m_bnv;
+    triangle.m_cnu = m_cnu;
+    triangle.m_cnv = m_cnv;
+    triangle.m_n = m_n;
+
+    RAYPACKET_MASK_T candidates = RAYPACKET_IntersectTriangle( aPacket, triangle,
+                                                               aFirst, aLast );
+    RAYPACKET_MASK_T hits = 0;
+
+    // Only the rays that hit run the scalar test, that fills their hit info
+    while( candidates )
+    {
+        const unsigned int i = RAYPACKET_FirstRay( candidates );
+
+        candidates &= candidates - 1;
+
+        if( Intersect( aRays[i], aHitInfoPacket[i].m_HitInfo ) )
+            hits |= (RAYPACKET_MASK_T) 1 << i;
+    }
+
+    return hits;
+}
+
+
 bool CTRIANGLE::IntersectP( const RAY &aRay,
                             float aMaxDistance ) const
 {
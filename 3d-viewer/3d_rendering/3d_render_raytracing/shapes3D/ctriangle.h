@@ -35,6 +35,7 @@
 #define _CTRIANGLE_H_
 
 #include "cobject.h"
+#include "../raypacket_simd.h"
 
 /**
  * A triangle object
@@ -69,6 +70,19 @@ public:
     bool Intersects( const CBBOX &aBBox ) const override;
     SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
 
+    /**
+     * Function IntersectPacket
+     * @brief Test the rays aFirst to aLast - 1 of a packet with the SIMD test, and update
+     * the hit info of the rays that hit the triangle.
+     * @param aPacket - the rays of aRays, with their current hit distance
+     * @return the rays that hit the triangle
+     */
+    RAYPACKET_MASK_T IntersectPacket( const RAYPACKET_SOA &aPacket,
+                                      const RAY *aRays,
+                                      unsigned int aFirst,
+                                      unsigned int aLast,
+                                      HITINFO_PACKET *aHitInfoPacket ) const;
+
 private:
     void pre_calc_const();
 
@@ -279,6 +279,7 @@ void EDA_3D_VIEWER::Process_Special_Functions( wxCommandEvent &event )
     switch( id )
     {
     case ID_RELOAD3D_BOARD:
+        m_settings.InvalidateLayers();
         NewDisplay( true );
         break;
 
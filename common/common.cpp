@@ -217,8 +217,12 @@ int ProcessExecute( const wxString& aCommandLine, int aFlags, wxProcess *callbac
 timestamp_t GetNewTimeStamp()
 {
     static timestamp_t oldTimeStamp;
+    static std::mutex  timeStampLock;
     timestamp_t newTimeStamp;
 
+    // Schematic sheets can be loaded by worker threads.
+    std::lock_guard<std::mutex> guard( timeStampLock );
+
     newTimeStamp = time( NULL );
 
     if( newTimeStamp <= oldTimeStamp )
@@ -37,6 +37,12 @@
 #include <base_units.h>
 #include <convert_to_biu.h>
 
+#include <atomic>
+
+// Statistics of the text shape cache, see EDA_TEXT::GetTextShape()
+static std::atomic<int64_t> s_shapeCacheHits( 0 );
+static std::atomic<int64_t> s_shapeCacheMisses( 0 );
+
 // Sadly we store the orientation of hierarchical and global labels using a different
 // int encoding than that for local labels:
 //                   Global      Local
@@ -112,7 +118,8 @@ EDA_TEXT::EDA_TEXT( const wxString& text ) :
 
 EDA_TEXT::EDA_TEXT( const EDA_TEXT& aText ) :
         m_text( aText.m_text ),
-        m_e( aText.m_e )
+        m_e( aText.m_e ),
+        m_shapeCache( std::atomic_load( &aText.m_shapeCache ) )
 {
     m_shown_text = UnescapeString( m_text );
 }
@@ -164,6 +171,8 @@ bool EDA_TEXT::Replace( wxFindReplaceData& aSearchData )
 
 int EDA_TEXT::LenSize( const wxString& aLine, int aThickness, int aMarkupFlags ) const
 {
+    std::lock_guard<std::mutex> lock( basic_gal_mutex );
+
     basic_gal.SetFontItalic( IsItalic() );
     basic_gal.SetFontBold( IsBold() );
     basic_gal.SetLineWidth( (float) aThickness );
@@ -558,6 +567,45 @@ static void addTextSegmToBuffer( int x0, int y0, int xf, int yf, void* aData )
 
 void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer ) const
 {
+    std::shared_ptr<const TEXT_SHAPE> shape = GetTextShape();
+
+    aCornerBuffer.insert( aCornerBuffer.end(), shape->m_Segments.begin(),
+                          shape->m_Segments.end() );
+}
+
+
+static bool sameEffects( const TEXT_EFFECTS& aFirst, const TEXT_EFFECTS& aSecond )
+{
+    return aFirst.bits == aSecond.bits
+            && aFirst.hjustify == aSecond.hjustify
+            && aFirst.vjustify == aSecond.vjustify
+            && aFirst.size == aSecond.size
+            && aFirst.penwidth == aSecond.penwidth
+            && aFirst.angle == aSecond.angle
+            && aFirst.pos == aSecond.pos;
+}
+
+
+std::shared_ptr<const TEXT_SHAPE> EDA_TEXT::GetTextShape( double aAngle ) const
+{
+    wxString text = GetShownText();
+    std::shared_ptr<const SHAPE_CACHE> cache = std::atomic_load( &m_shapeCache );
+
+    if( cache && cache->m_Angle == aAngle && sameEffects( cache->m_Effects, m_e )
+            && cache->m_Text == text )
+    {
+        s_shapeCacheHits++;
+        return std::shared_ptr<const TEXT_SHAPE>( cache, &cache->m_Shape );
+    }
+
+    s_shapeCacheMisses++;
+
+    auto newCache = std::make_shared<SHAPE_CACHE>();
+    newCache->m_Effects = m_e;
+    newCache->m_Text = text;
+    newCache->m_Angle = aAngle;
+
+    std::vector<wxPoint>& segments = newCache->m_Shape.m_Segments;
     wxSize size = GetTextSize();
 
     if( IsMirrored() )
@@ -568,7 +616,7 @@ void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuf
     if( IsMultilineAllowed() )
     {
         wxArrayString strings_list;
-        wxStringSplit( GetShownText(), strings_list, wxChar('\n') );
+        wxStringSplit( text, strings_list, wxChar('\n') );
         std::vector<wxPoint> positions;
         positions.reserve( strings_list.Count() );
         GetPositionsOfLinesOfMultilineText( positions,strings_list.Count() );
@@ -576,15 +624,62 @@ void EDA_TEXT::TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuf
         for( unsigned ii = 0; ii < strings_list.Count(); ii++ )
         {
             wxString txt = strings_list.Item( ii );
-            GRText( NULL, positions[ii], color, txt, GetTextAngle(), size, GetHorizJustify(),
+            GRText( NULL, positions[ii], color, txt, aAngle, size, GetHorizJustify(),
                     GetVertJustify(), GetThickness(), IsItalic(), true, addTextSegmToBuffer,
-                    &aCornerBuffer );
+                    &segments );
         }
     }
     else
     {
-        GRText( NULL, GetTextPos(), color, GetText(), GetTextAngle(), size, GetHorizJustify(),
+        GRText( NULL, GetTextPos(), color, text, aAngle, size, GetHorizJustify(),
                 GetVertJustify(), GetThickness(), IsItalic(), true, addTextSegmToBuffer,
-                &aCornerBuffer );
+                &segments );
+    }
+
+    EDA_RECT& bbox = newCache->m_Shape.m_BoundingBox;
+
+    if( segments.empty() )
+    {
+        bbox = EDA_RECT( GetTextPos(), wxSize( 0, 0 ) );
     }
+    else
+    {
+        wxPoint start = segments[0];
+        wxPoint end = segments[0];
+
+        for( const wxPoint& pt : segments )
+        {
+            start.x = std::min( start.x, pt.x );
+            start.y = std::min( start.y, pt.y );
+            end.x = std::max( end.x, pt.x );
+            end.y = std::max( end.y, pt.y );
+        }
+
+        bbox.SetOrigin( start );
+        bbox.SetEnd( end );
+        bbox.Inflate( ( GetThickness() + 1 ) / 2 );
+    }
+
+    std::atomic_store( &m_shapeCache, std::shared_ptr<const SHAPE_CACHE>( newCache ) );
+
+    return std::shared_ptr<const TEXT_SHAPE>( newCache, &newCache->m_Shape );
+}
+
+
+int64_t EDA_TEXT::GetShapeCacheHits()
+{
+    return s_shapeCacheHits;
+}
+
+
+int64_t EDA_TEXT::GetShapeCacheMisses()
+{
+    return s_shapeCacheMisses;
+}
+
+
+void EDA_TEXT::ResetShapeCacheStats()
+{
+    s_shapeCacheHits = 0;
+    s_shapeCacheMisses = 0;
 }
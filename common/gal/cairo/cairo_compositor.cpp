@@ -140,6 +140,41 @@ void CAIRO_COMPOSITOR::Begin()
 {
 }
 
+
+cairo_t* CAIRO_COMPOSITOR::CreateTileContext( const BOX2I& aRect )
+{
+    wxASSERT_MSG( m_current < usedBuffers(), wxT( "No buffer to draw tiles in" ) );
+
+    if( aRect.GetX() < 0 || aRect.GetY() < 0 || aRect.GetWidth() <= 0 || aRect.GetHeight() <= 0
+            || aRect.GetRight() > (int) m_width || aRect.GetBottom() > (int) m_height )
+        return nullptr;
+
+    const CAIRO_BUFFER& buffer = m_buffers[m_current];
+
+    // The pending drawings have to reach the pixel storage before it is shared
+    cairo_surface_flush( buffer.surface );
+
+    unsigned char* pixels = (unsigned char*) buffer.bitmap + aRect.GetY() * m_stride
+                            + aRect.GetX() * sizeof( uint32_t );
+
+    // The surface uses the buffer stride, so it covers only the pixels of the tile
+    cairo_surface_t* surface = cairo_image_surface_create_for_data( pixels, CAIRO_FORMAT_ARGB32,
+            aRect.GetWidth(), aRect.GetHeight(), m_stride );
+    cairo_t* context = cairo_create( surface );
+
+    // The context keeps a reference to the surface
+    cairo_surface_destroy( surface );
+
+#ifdef DEBUG
+    cairo_status_t status = cairo_status( context );
+    wxASSERT_MSG( status == CAIRO_STATUS_SUCCESS, wxT( "Cairo context creation error" ) );
+#endif /* DEBUG */
+
+    cairo_set_antialias( context, m_currentAntialiasingMode );
+
+    return context;
+}
+
 void CAIRO_COMPOSITOR::ClearBuffer( const COLOR4D& aColor )
 {
     // Clear the pixel storage
@@ -156,6 +191,9 @@ void CAIRO_COMPOSITOR::DrawBuffer( unsigned int aBufferHandle )
     cairo_get_matrix( m_mainContext, &m_matrix );
     cairo_identity_matrix( m_mainContext );
 
+    // Tile contexts may have drawn directly in the pixel storage
+    cairo_surface_mark_dirty( m_buffers[aBufferHandle - 1].surface );
+
     // Draw the selected buffer contents
     cairo_set_source_surface( m_mainContext, m_buffers[aBufferHandle - 1].surface, 0.0, 0.0 );
     cairo_paint( m_mainContext );
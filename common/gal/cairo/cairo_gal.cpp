@@ -1388,6 +1388,28 @@ void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 }
 
 
+GAL* CAIRO_GAL::CreateTileGAL( const BOX2I& aScreenRect )
+{
+    // The pixel storage is shared only while drawing
+    if( !validCompositor || !isInitialized )
+        return nullptr;
+
+    BOX2I rect = aScreenRect;
+    rect.Normalize();
+    rect = rect.Intersect( BOX2I( VECTOR2I( 0, 0 ), screenSize ) );
+
+    // Draw the pending path before tiles draw over it
+    storePath();
+
+    cairo_t* tileContext = compositor->CreateTileContext( rect );
+
+    if( !tileContext )
+        return nullptr;
+
+    return new CAIRO_TILE_GAL( options, *this, tileContext, rect.GetPosition() );
+}
+
+
 void CAIRO_GAL::initSurface()
 {
     if( isInitialized )
@@ -1496,6 +1518,177 @@ bool CAIRO_GAL::updatedGalDisplayOptions( const GAL_DISPLAY_OPTIONS& aOptions )
 }
 
 
+CAIRO_TILE_GAL::CAIRO_TILE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, const GAL& aParent,
+                                cairo_t* aContext, const VECTOR2I& aOrigin ) :
+    CAIRO_GAL_BASE( aDisplayOptions )
+{
+    copyWorldTransform( aParent );
+
+    context = aContext;
+    currentContext = aContext;
+
+    // Use the transformation of the parent, shifted to the tile origin.  Integer shifts
+    // keep the pixel alignment of the parent drawings.
+    resetContext();
+
+    cairoWorldScreenMatrix.x0 -= aOrigin.x;
+    cairoWorldScreenMatrix.y0 -= aOrigin.y;
+    updateWorldScreenMatrix();
+}
+
+
+CAIRO_IMAGE_GAL::CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth,
+                                  int aHeight ) :
+    CAIRO_GAL_BASE( aDisplayOptions ),
+    mainBuffer( 0 ),
+    overlayBuffer( 0 ),
+    currentTarget( TARGET_NONCACHED ),
+    stride( 0 )
+{
+    ResizeScreen( aWidth, aHeight );
+}
+
+
+CAIRO_IMAGE_GAL::~CAIRO_IMAGE_GAL()
+{
+    // The buffers have to be released before the main context
+    compositor.reset();
+}
+
+
+void CAIRO_IMAGE_GAL::ResizeScreen( int aWidth, int aHeight )
+{
+    CAIRO_GAL_BASE::ResizeScreen( aWidth, aHeight );
+
+    compositor.reset();
+
+    if( context )
+        cairo_destroy( context );
+
+    if( surface )
+        cairo_surface_destroy( surface );
+
+    // Unlike CAIRO_GAL, the surface is kept between the drawings, to read the image
+    stride = cairo_format_stride_for_width( GAL_FORMAT, screenSize.x );
+    bitmapBuffer.assign( stride * screenSize.y, 0 );
+
+    surface = cairo_image_surface_create_for_data( bitmapBuffer.data(), GAL_FORMAT,
+                                                   screenSize.x, screenSize.y, stride );
+    context = cairo_create( surface );
+    currentContext = context;
+
+    compositor.reset( new CAIRO_COMPOSITOR( &currentContext ) );
+    compositor->Resize( screenSize.x, screenSize.y );
+    compositor->SetAntialiasingMode( options.cairo_antialiasing_mode );
+
+    mainBuffer = compositor->CreateBuffer();
+    overlayBuffer = compositor->CreateBuffer();
+}
+
+
+void CAIRO_IMAGE_GAL::beginDrawing()
+{
+    currentContext = context;
+
+    CAIRO_GAL_BASE::beginDrawing();
+
+    compositor->SetMainContext( context );
+    compositor->SetBuffer( mainBuffer );
+    currentTarget = TARGET_NONCACHED;
+}
+
+
+void CAIRO_IMAGE_GAL::endDrawing()
+{
+    CAIRO_GAL_BASE::endDrawing();
+
+    // Merge buffers in the image
+    compositor->DrawBuffer( mainBuffer );
+    compositor->DrawBuffer( overlayBuffer );
+
+    cairo_surface_flush( surface );
+}
+
+
+void CAIRO_IMAGE_GAL::SetTarget( RENDER_TARGET aTarget )
+{
+    storePath();
+
+    switch( aTarget )
+    {
+    default:
+    case TARGET_CACHED:
+    case TARGET_NONCACHED:
+        compositor->SetBuffer( mainBuffer );
+        break;
+
+    case TARGET_OVERLAY:
+        compositor->SetBuffer( overlayBuffer );
+        break;
+    }
+
+    currentTarget = aTarget;
+}
+
+
+RENDER_TARGET CAIRO_IMAGE_GAL::GetTarget() const
+{
+    return currentTarget;
+}
+
+
+void CAIRO_IMAGE_GAL::ClearTarget( RENDER_TARGET aTarget )
+{
+    unsigned int currentBuffer = compositor->GetBuffer();
+
+    compositor->SetBuffer( aTarget == TARGET_OVERLAY ? overlayBuffer : mainBuffer );
+    compositor->ClearBuffer( COLOR4D::BLACK );
+    compositor->SetBuffer( currentBuffer );
+}
+
+
+GAL* CAIRO_IMAGE_GAL::CreateTileGAL( const BOX2I& aScreenRect )
+{
+    BOX2I rect = aScreenRect;
+    rect.Normalize();
+    rect = rect.Intersect( BOX2I( VECTOR2I( 0, 0 ), screenSize ) );
+
+    // Draw the pending path before tiles draw over it
+    storePath();
+
+    cairo_t* tileContext = compositor->CreateTileContext( rect );
+
+    if( !tileContext )
+        return nullptr;
+
+    return new CAIRO_TILE_GAL( options, *this, tileContext, rect.GetPosition() );
+}
+
+
+wxImage CAIRO_IMAGE_GAL::GetImage() const
+{
+    wxImage image( screenSize.x, screenSize.y, false );
+    unsigned char* rgb = image.GetData();
+
+    // The image is opaque, the premultiplied colors are the actual ones
+    for( int y = 0; y < screenSize.y; ++y )
+    {
+        const uint32_t* row = (const uint32_t*) ( bitmapBuffer.data() + y * stride );
+
+        for( int x = 0; x < screenSize.x; ++x )
+        {
+            uint32_t pixel = row[x];
+
+            *rgb++ = ( pixel >> 16 ) & 0xff;
+            *rgb++ = ( pixel >> 8 ) & 0xff;
+            *rgb++ = pixel & 0xff;
+        }
+    }
+
+    return image;
+}
+
+
 void CAIRO_GAL_BASE::DrawGrid()
 {
     SetTarget( TARGET_NONCACHED );
@@ -75,7 +75,7 @@ GAL::GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
     // Initialize text properties
     ResetTextAttributes();
 
-    strokeFont.LoadNewStrokeFont( newstroke_font, newstroke_font_bufsize );
+    strokeFont.LoadNewStrokeFont();
 
     // subscribe for settings updates
     observerLink = options.Subscribe( this );
@@ -205,6 +205,23 @@ void GAL::ComputeWorldScreenMatrix()
 }
 
 
+void GAL::copyWorldTransform( const GAL& aGal )
+{
+    screenSize        = aGal.screenSize;
+    worldUnitLength   = aGal.worldUnitLength;
+    screenDPI         = aGal.screenDPI;
+    lookAtPoint       = aGal.lookAtPoint;
+    zoomFactor        = aGal.zoomFactor;
+    rotation          = aGal.rotation;
+    globalFlipX       = aGal.globalFlipX;
+    globalFlipY       = aGal.globalFlipY;
+    depthRange        = aGal.depthRange;
+    worldScale        = aGal.worldScale;
+    worldScreenMatrix = aGal.worldScreenMatrix;
+    screenWorldMatrix = aGal.screenWorldMatrix;
+}
+
+
 double GAL::computeMinGridSpacing() const
 {
     // just return the current value. This could be cleverer and take
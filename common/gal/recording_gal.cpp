@@ -0,0 +1,527 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/recording_gal.h>
+#include <gal/gal_display_options.h>
+
+using namespace KIGFX;
+
+
+void GAL_DISPLAY_LIST::Clear()
+{
+    m_commands.clear();
+    m_args.clear();
+    m_points.clear();
+    m_chains.clear();
+    m_polySets.clear();
+    m_texts.clear();
+    m_bitmaps.clear();
+}
+
+
+void GAL_DISPLAY_LIST::Replay( GAL& aGal ) const
+{
+    const double* arg = m_args.data();
+    const VECTOR2D* points = m_points.data();
+    auto chain = m_chains.begin();
+    auto polySet = m_polySets.begin();
+    auto text = m_texts.begin();
+    auto bitmap = m_bitmaps.begin();
+
+    auto nextPoint = [&arg]() -> VECTOR2D
+    {
+        VECTOR2D pt( arg[0], arg[1] );
+        arg += 2;
+        return pt;
+    };
+
+    auto nextColor = [&arg]() -> COLOR4D
+    {
+        COLOR4D color( arg[0], arg[1], arg[2], arg[3] );
+        arg += 4;
+        return color;
+    };
+
+    for( COMMAND command : m_commands )
+    {
+        switch( command )
+        {
+        case CMD_LINE:
+        {
+            VECTOR2D start = nextPoint();
+            aGal.DrawLine( start, nextPoint() );
+            break;
+        }
+
+        case CMD_SEGMENT:
+        {
+            VECTOR2D start = nextPoint();
+            VECTOR2D end = nextPoint();
+            aGal.DrawSegment( start, end, *arg++ );
+            break;
+        }
+
+        case CMD_POLYLINE:
+        case CMD_POLYGON:
+        {
+            int count = (int) *arg++;
+
+            if( command == CMD_POLYLINE )
+                aGal.DrawPolyline( points, count );
+            else
+                aGal.DrawPolygon( points, count );
+
+            points += count;
+            break;
+        }
+
+        case CMD_POLYLINE_CHAIN:
+            aGal.DrawPolyline( *chain++ );
+            break;
+
+        case CMD_POLYGON_CHAIN:
+            aGal.DrawPolygon( *chain++ );
+            break;
+
+        case CMD_POLYGON_SET:
+            aGal.DrawPolygon( *polySet++ );
+            break;
+
+        case CMD_CIRCLE:
+        {
+            VECTOR2D center = nextPoint();
+            aGal.DrawCircle( center, *arg++ );
+            break;
+        }
+
+        case CMD_ARC:
+        {
+            VECTOR2D center = nextPoint();
+            aGal.DrawArc( center, arg[0], arg[1], arg[2] );
+            arg += 3;
+            break;
+        }
+
+        case CMD_ARC_SEGMENT:
+        {
+            VECTOR2D center = nextPoint();
+            aGal.DrawArcSegment( center, arg[0], arg[1], arg[2], arg[3] );
+            arg += 4;
+            break;
+        }
+
+        case CMD_RECTANGLE:
+        {
+            VECTOR2D start = nextPoint();
+            aGal.DrawRectangle( start, nextPoint() );
+            break;
+        }
+
+        case CMD_CURVE:
+        {
+            VECTOR2D start = nextPoint();
+            VECTOR2D controlA = nextPoint();
+            VECTOR2D controlB = nextPoint();
+            VECTOR2D end = nextPoint();
+            aGal.DrawCurve( start, controlA, controlB, end, *arg++ );
+            break;
+        }
+
+        case CMD_BITMAP:
+            aGal.DrawBitmap( **bitmap++ );
+            break;
+
+        case CMD_BITMAP_TEXT:
+        {
+            // The text attributes are not set through virtual methods: they are
+            // recorded with the text
+            VECTOR2D position = nextPoint();
+            double angle = *arg++;
+            aGal.SetGlyphSize( nextPoint() );
+            aGal.SetHorizontalJustify( (EDA_TEXT_HJUSTIFY_T) arg[0] );
+            aGal.SetVerticalJustify( (EDA_TEXT_VJUSTIFY_T) arg[1] );
+            aGal.SetFontBold( arg[2] != 0.0 );
+            aGal.SetFontItalic( arg[3] != 0.0 );
+            aGal.SetTextMirrored( arg[4] != 0.0 );
+            arg += 5;
+            aGal.BitmapText( *text++, position, angle );
+            break;
+        }
+
+        case CMD_IS_FILL:
+            aGal.SetIsFill( *arg++ != 0.0 );
+            break;
+
+        case CMD_IS_STROKE:
+            aGal.SetIsStroke( *arg++ != 0.0 );
+            break;
+
+        case CMD_FILL_COLOR:
+            aGal.SetFillColor( nextColor() );
+            break;
+
+        case CMD_STROKE_COLOR:
+            aGal.SetStrokeColor( nextColor() );
+            break;
+
+        case CMD_LINE_WIDTH:
+            aGal.SetLineWidth( (float) *arg++ );
+            break;
+
+        case CMD_LAYER_DEPTH:
+            aGal.SetLayerDepth( *arg++ );
+            break;
+
+        case CMD_NEGATIVE_DRAW_MODE:
+            aGal.SetNegativeDrawMode( *arg++ != 0.0 );
+            break;
+
+        case CMD_TRANSFORM:
+        {
+            MATRIX3x3D matrix;
+
+            for( int ii = 0; ii < 3; ++ii )
+            {
+                for( int jj = 0; jj < 3; ++jj )
+                    matrix.m_data[ii][jj] = *arg++;
+            }
+
+            aGal.Transform( matrix );
+            break;
+        }
+
+        case CMD_ROTATE:
+            aGal.Rotate( *arg++ );
+            break;
+
+        case CMD_TRANSLATE:
+            aGal.Translate( nextPoint() );
+            break;
+
+        case CMD_SCALE:
+            aGal.Scale( nextPoint() );
+            break;
+
+        case CMD_SAVE:
+            aGal.Save();
+            break;
+
+        case CMD_RESTORE:
+            aGal.Restore();
+            break;
+        }
+    }
+}
+
+
+// The recording GAL does not draw the grid nor the cursor: it does not
+// need its own display options
+static GAL_DISPLAY_OPTIONS& recordingGalOptions()
+{
+    static GAL_DISPLAY_OPTIONS options;
+    return options;
+}
+
+
+RECORDING_GAL::RECORDING_GAL( GAL* aTarget ) :
+    GAL( recordingGalOptions() ),
+    m_list( new GAL_DISPLAY_LIST )
+{
+    m_isCairo = aTarget->IsCairoEngine();
+    m_isOpenGl = aTarget->IsOpenGlEngine();
+
+    copyWorldTransform( *aTarget );
+}
+
+
+std::unique_ptr<GAL_DISPLAY_LIST> RECORDING_GAL::TakeDisplayList()
+{
+    std::unique_ptr<GAL_DISPLAY_LIST> list( new GAL_DISPLAY_LIST );
+    std::swap( list, m_list );
+    return list;
+}
+
+
+void RECORDING_GAL::addArg( const COLOR4D& aColor )
+{
+    addArg( aColor.r );
+    addArg( aColor.g );
+    addArg( aColor.b );
+    addArg( aColor.a );
+}
+
+
+void RECORDING_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_LINE );
+    addArg( aStartPoint );
+    addArg( aEndPoint );
+}
+
+
+void RECORDING_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                                 double aWidth )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_SEGMENT );
+    addArg( aStartPoint );
+    addArg( aEndPoint );
+    addArg( aWidth );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const std::deque<VECTOR2D>& aPointList )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_POLYLINE );
+    addArg( (double) aPointList.size() );
+    m_list->m_points.insert( m_list->m_points.end(), aPointList.begin(), aPointList.end() );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const VECTOR2D aPointList[], int aListSize )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_POLYLINE );
+    addArg( (double) aListSize );
+    m_list->m_points.insert( m_list->m_points.end(), aPointList, aPointList + aListSize );
+}
+
+
+void RECORDING_GAL::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_POLYLINE_CHAIN );
+    m_list->m_chains.push_back( aLineChain );
+}
+
+
+void RECORDING_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_CIRCLE );
+    addArg( aCenterPoint );
+    addArg( aRadius );
+}
+
+
+void RECORDING_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                             double aEndAngle )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_ARC );
+    addArg( aCenterPoint );
+    addArg( aRadius );
+    addArg( aStartAngle );
+    addArg( aEndAngle );
+}
+
+
+void RECORDING_GAL::DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                                    double aStartAngle, double aEndAngle, double aWidth )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_ARC_SEGMENT );
+    addArg( aCenterPoint );
+    addArg( aRadius );
+    addArg( aStartAngle );
+    addArg( aEndAngle );
+    addArg( aWidth );
+}
+
+
+void RECORDING_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_RECTANGLE );
+    addArg( aStartPoint );
+    addArg( aEndPoint );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_POLYGON );
+    addArg( (double) aPointList.size() );
+    m_list->m_points.insert( m_list->m_points.end(), aPointList.begin(), aPointList.end() );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_POLYGON );
+    addArg( (double) aListSize );
+    m_list->m_points.insert( m_list->m_points.end(), aPointList, aPointList + aListSize );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+{
+    // The copy keeps the triangulation of aPolySet, if any
+    addCommand( GAL_DISPLAY_LIST::CMD_POLYGON_SET );
+    m_list->m_polySets.push_back( aPolySet );
+}
+
+
+void RECORDING_GAL::DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_POLYGON_CHAIN );
+    m_list->m_chains.push_back( aPolySet );
+}
+
+
+void RECORDING_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                               const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                               double aFilterValue )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_CURVE );
+    addArg( aStartPoint );
+    addArg( aControlPointA );
+    addArg( aControlPointB );
+    addArg( aEndPoint );
+    addArg( aFilterValue );
+}
+
+
+void RECORDING_GAL::DrawBitmap( const BITMAP_BASE& aBitmap )
+{
+    // Bitmaps belong to the items, which outlive the display list
+    addCommand( GAL_DISPLAY_LIST::CMD_BITMAP );
+    m_list->m_bitmaps.push_back( &aBitmap );
+}
+
+
+void RECORDING_GAL::BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                                double aRotationAngle )
+{
+    // Only the OpenGL GAL has its own bitmap font.  For the other ones, the text is
+    // stroked here, like GAL::BitmapText() would do on the target.
+    if( !m_isOpenGl )
+    {
+        GAL::BitmapText( aText, aPosition, aRotationAngle );
+        return;
+    }
+
+    addCommand( GAL_DISPLAY_LIST::CMD_BITMAP_TEXT );
+    addArg( aPosition );
+    addArg( aRotationAngle );
+    addArg( GetGlyphSize() );
+    addArg( (double) GetHorizontalJustify() );
+    addArg( (double) GetVerticalJustify() );
+    addArg( IsFontBold() ? 1.0 : 0.0 );
+    addArg( IsFontItalic() ? 1.0 : 0.0 );
+    addArg( IsTextMirrored() ? 1.0 : 0.0 );
+    m_list->m_texts.push_back( aText );
+}
+
+
+void RECORDING_GAL::SetIsFill( bool aIsFillEnabled )
+{
+    GAL::SetIsFill( aIsFillEnabled );
+    addCommand( GAL_DISPLAY_LIST::CMD_IS_FILL );
+    addArg( aIsFillEnabled ? 1.0 : 0.0 );
+}
+
+
+void RECORDING_GAL::SetIsStroke( bool aIsStrokeEnabled )
+{
+    GAL::SetIsStroke( aIsStrokeEnabled );
+    addCommand( GAL_DISPLAY_LIST::CMD_IS_STROKE );
+    addArg( aIsStrokeEnabled ? 1.0 : 0.0 );
+}
+
+
+void RECORDING_GAL::SetFillColor( const COLOR4D& aColor )
+{
+    GAL::SetFillColor( aColor );
+    addCommand( GAL_DISPLAY_LIST::CMD_FILL_COLOR );
+    addArg( aColor );
+}
+
+
+void RECORDING_GAL::SetStrokeColor( const COLOR4D& aColor )
+{
+    GAL::SetStrokeColor( aColor );
+    addCommand( GAL_DISPLAY_LIST::CMD_STROKE_COLOR );
+    addArg( aColor );
+}
+
+
+void RECORDING_GAL::SetLineWidth( float aLineWidth )
+{
+    GAL::SetLineWidth( aLineWidth );
+    addCommand( GAL_DISPLAY_LIST::CMD_LINE_WIDTH );
+    addArg( aLineWidth );
+}
+
+
+void RECORDING_GAL::SetLayerDepth( double aLayerDepth )
+{
+    GAL::SetLayerDepth( aLayerDepth );
+    addCommand( GAL_DISPLAY_LIST::CMD_LAYER_DEPTH );
+    addArg( aLayerDepth );
+}
+
+
+void RECORDING_GAL::SetNegativeDrawMode( bool aSetting )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_NEGATIVE_DRAW_MODE );
+    addArg( aSetting ? 1.0 : 0.0 );
+}
+
+
+void RECORDING_GAL::Transform( const MATRIX3x3D& aTransformation )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_TRANSFORM );
+
+    for( int ii = 0; ii < 3; ++ii )
+    {
+        for( int jj = 0; jj < 3; ++jj )
+            addArg( aTransformation.m_data[ii][jj] );
+    }
+}
+
+
+void RECORDING_GAL::Rotate( double aAngle )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_ROTATE );
+    addArg( aAngle );
+}
+
+
+void RECORDING_GAL::Translate( const VECTOR2D& aTranslation )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_TRANSLATE );
+    addArg( aTranslation );
+}
+
+
+void RECORDING_GAL::Scale( const VECTOR2D& aScale )
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_SCALE );
+    addArg( aScale );
+}
+
+
+void RECORDING_GAL::Save()
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_SAVE );
+}
+
+
+void RECORDING_GAL::Restore()
+{
+    addCommand( GAL_DISPLAY_LIST::CMD_RESTORE );
+}
@@ -0,0 +1,241 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/polygon_lod.h>
+#include <geometry/seg.h>
+
+#include <utility>
+
+
+/**
+ * Simplify the closed chain aChain with the Douglas-Peucker algorithm: the kept vertices
+ * are a subset of the chain vertices, and the removed ones are at most aTolerance away
+ * from the result.
+ */
+static SHAPE_LINE_CHAIN simplifyChain( const SHAPE_LINE_CHAIN& aChain, int aTolerance )
+{
+    const int count = aChain.PointCount();
+    const SEG::ecoord maxDist = (SEG::ecoord) aTolerance * aTolerance;
+    std::vector<bool> keep( count, false );
+    SHAPE_LINE_CHAIN result;
+
+    result.SetClosed( true );
+
+    if( count < 4 )
+        return aChain;
+
+    // Split the chain at its first vertex and the vertex farthest from it
+    int farthest = 0;
+    SEG::ecoord farthestDist = 0;
+
+    for( int ii = 1; ii < count; ++ii )
+    {
+        SEG::ecoord dist = ( aChain.CPoint( ii ) - aChain.CPoint( 0 ) ).SquaredEuclideanNorm();
+
+        if( dist > farthestDist )
+        {
+            farthest = ii;
+            farthestDist = dist;
+        }
+    }
+
+    keep[0] = true;
+    keep[farthest] = true;
+
+    // Ranges of vertices still to simplify, the index count stands for the vertex 0
+    std::vector<std::pair<int, int>> ranges = { { 0, farthest }, { farthest, count } };
+
+    while( !ranges.empty() )
+    {
+        int first = ranges.back().first;
+        int last = ranges.back().second;
+        ranges.pop_back();
+
+        if( last - first < 2 )
+            continue;
+
+        SEG seg( aChain.CPoint( first ), aChain.CPoint( last % count ) );
+        int worst = -1;
+        SEG::ecoord worstDist = maxDist;
+
+        for( int ii = first + 1; ii < last; ++ii )
+        {
+            SEG::ecoord dist = seg.SquaredDistance( aChain.CPoint( ii ) );
+
+            if( dist > worstDist )
+            {
+                worst = ii;
+                worstDist = dist;
+            }
+        }
+
+        if( worst >= 0 )
+        {
+            keep[worst] = true;
+            ranges.emplace_back( first, worst );
+            ranges.emplace_back( worst, last );
+        }
+    }
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        if( keep[ii] )
+            result.Append( aChain.CPoint( ii ) );
+    }
+
+    return result;
+}
+
+
+int POLYGON_LOD::Level( double aPixelSize, int aBaseTolerance )
+{
+    int level = 0;
+    double tolerance = aBaseTolerance;
+
+    while( level + 1 < LEVEL_COUNT && tolerance <= aPixelSize / 2 )
+    {
+        level++;
+        tolerance *= 2;
+    }
+
+    return level;
+}
+
+
+const SHAPE_POLY_SET& POLYGON_LOD::Get( const SHAPE_POLY_SET& aSource, int aLevel,
+                                        VECTOR2I& aOffset )
+{
+    aOffset = VECTOR2I( 0, 0 );
+
+    if( aLevel <= 0 || aLevel >= LEVEL_COUNT || aSource.TotalVertices() < MIN_VERTEX_COUNT )
+        return aSource;
+
+    KEY key = makeKey( aSource );
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    if( key.m_vertexCount != m_key.m_vertexCount || key.m_hash != m_key.m_hash )
+    {
+        Clear();
+        m_key = key;
+    }
+
+    if( m_states[aLevel] == LS_NOT_BUILT )
+        build( aSource, aLevel );
+
+    if( m_states[aLevel] == LS_SOURCE )
+        return aSource;
+
+    aOffset = key.m_origin - m_key.m_origin;
+
+    return m_levels[aLevel];
+}
+
+
+void POLYGON_LOD::Clear()
+{
+    m_key.m_vertexCount = -1;
+    m_key.m_hash = 0;
+    m_states.assign( LEVEL_COUNT, LS_NOT_BUILT );
+    m_levels.assign( LEVEL_COUNT, SHAPE_POLY_SET() );
+}
+
+
+POLYGON_LOD::KEY POLYGON_LOD::makeKey( const SHAPE_POLY_SET& aSource )
+{
+    KEY key;
+
+    key.m_vertexCount = aSource.TotalVertices();
+    key.m_origin = key.m_vertexCount > 0 ? aSource.CVertex( 0 ) : VECTOR2I( 0, 0 );
+
+    // FNV-1a of the contour sizes and of the vertices relative to the first one
+    uint64_t hash = 14695981039346656037ULL;
+
+    auto mix = [&hash]( int64_t aValue )
+    {
+        hash ^= (uint64_t) aValue;
+        hash *= 1099511628211ULL;
+    };
+
+    for( int ii = 0; ii < aSource.OutlineCount(); ++ii )
+    {
+        for( const SHAPE_LINE_CHAIN& chain : aSource.CPolygon( ii ) )
+        {
+            mix( chain.PointCount() );
+
+            for( int jj = 0; jj < chain.PointCount(); ++jj )
+            {
+                VECTOR2I pt = chain.CPoint( jj ) - key.m_origin;
+                mix( ( (int64_t) pt.x << 32 ) ^ (uint32_t) pt.y );
+            }
+        }
+    }
+
+    key.m_hash = hash;
+
+    return key;
+}
+
+
+void POLYGON_LOD::build( const SHAPE_POLY_SET& aSource, int aLevel )
+{
+    int tolerance = m_baseTolerance << ( aLevel - 1 );
+    SHAPE_POLY_SET& simplified = m_levels[aLevel];
+
+    simplified.RemoveAllContours();
+
+    for( int ii = 0; ii < aSource.OutlineCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aSource.CPolygon( ii );
+        SHAPE_LINE_CHAIN outline = simplifyChain( poly[0], tolerance );
+
+        // Outlines (and holes) smaller than the tolerance vanish
+        if( outline.PointCount() < 3 )
+            continue;
+
+        int index = simplified.AddOutline( outline );
+
+        for( size_t jj = 1; jj < poly.size(); ++jj )
+        {
+            SHAPE_LINE_CHAIN hole = simplifyChain( poly[jj], tolerance );
+
+            if( hole.PointCount() >= 3 )
+                simplified.AddHole( hole, index );
+        }
+    }
+
+    // Keep the source when less than a quarter of the vertices would be removed
+    if( simplified.TotalVertices() * 4 > aSource.TotalVertices() * 3 )
+    {
+        simplified.RemoveAllContours();
+        m_states[aLevel] = LS_SOURCE;
+        return;
+    }
+
+    // Removing vertices can make outlines self-intersecting, especially around the
+    // bridges of fractured polygons: merge them again before triangulating
+    simplified.Fracture( SHAPE_POLY_SET::PM_FAST );
+    simplified.CacheTriangulation();
+
+    m_states[aLevel] = LS_BUILT;
+}
@@ -0,0 +1,213 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file newstroke_glyphs_compiler.cpp
+ * @brief Build tool decoding the newstroke font strings into the packed glyph tables
+ * used by STROKE_FONT.
+ *
+ * Usage: newstroke_glyphs_compiler <output header>
+ *
+ * In newstroke_font, each glyph is a string of coordinate pairs, coded as <value> + 'R'.
+ * The first pair gives the horizontal start and end of the glyph, and " R" raises
+ * the pen (starts a new stroke).  The generated tables contain, in font units:
+ * - newstroke_glyphs: for each glyph, its first stroke and first point, its stroke count
+ *   and its width.
+ * - newstroke_strokes: the point count of each stroke.
+ * - newstroke_points: the x,y coordinates of the stroke points.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <newstroke_font.h>
+
+
+// FONT_OFFSET is here for historical reasons, due to the way the stroke font
+// was built. It allows shapes coordinates like W M ... to be >= 0
+// Only shapes like j y have coordinates < 0
+#define FONT_OFFSET -10
+
+
+struct GLYPH_ENTRY
+{
+    int firstStroke;
+    int firstPoint;
+    int strokeCount;
+    int width;
+};
+
+
+static bool inRange( int aValue, int aMin, int aMax )
+{
+    return aValue >= aMin && aValue <= aMax;
+}
+
+
+/**
+ * Write the values of aTable as the initializer list of a C array.
+ */
+static void writeTable( FILE* aFile, const char* aType, const char* aName,
+                        const std::vector<int>& aTable )
+{
+    fprintf( aFile, "constexpr %s %s[] =\n{", aType, aName );
+
+    for( size_t ii = 0; ii < aTable.size(); ++ii )
+        fprintf( aFile, "%s%d,", ii % 24 ? "" : "\n    ", aTable[ii] );
+
+    fprintf( aFile, "\n};\n\n" );
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc != 2 )
+    {
+        fprintf( stderr, "usage: %s <output header>\n", argv[0] );
+        return 1;
+    }
+
+    std::vector<GLYPH_ENTRY> glyphs;
+    std::vector<int>         strokes;       // point count of each stroke
+    std::vector<int>         points;        // x, y pairs
+
+    glyphs.reserve( newstroke_font_bufsize );
+
+    for( int j = 0; j < newstroke_font_bufsize; j++ )
+    {
+        const char* def = newstroke_font[j];
+        GLYPH_ENTRY glyph = { (int) strokes.size(), (int) points.size() / 2, 0, 0 };
+        int         glyphStartX = 0;
+        bool        penDown = false;
+
+        for( int i = 0; def[i] && def[i + 1]; i += 2 )
+        {
+            if( i == 0 )
+            {
+                // The first two values contain the width of the char
+                glyphStartX = def[0] - 'R';
+                glyph.width = ( def[1] - 'R' ) - glyphStartX;
+            }
+            else if( def[i] == ' ' && def[i + 1] == 'R' )
+            {
+                // Raise pen
+                penDown = false;
+            }
+            else
+            {
+                if( !penDown )
+                {
+                    strokes.push_back( 0 );
+                    glyph.strokeCount++;
+                    penDown = true;
+                }
+
+                points.push_back( def[i] - 'R' - glyphStartX );
+                points.push_back( def[i + 1] - 'R' + FONT_OFFSET );
+                strokes.back()++;
+            }
+        }
+
+        glyphs.push_back( glyph );
+    }
+
+    // Check the values fit in the types of the tables
+    for( const GLYPH_ENTRY& glyph : glyphs )
+    {
+        if( !inRange( glyph.strokeCount, 0, 0xFFFF ) || !inRange( glyph.width, -128, 127 ) )
+        {
+            fprintf( stderr, "%s: glyph out of the table range\n", argv[0] );
+            return 1;
+        }
+    }
+
+    for( int count : strokes )
+    {
+        if( !inRange( count, 1, 0xFFFF ) )
+        {
+            fprintf( stderr, "%s: stroke out of the table range\n", argv[0] );
+            return 1;
+        }
+    }
+
+    for( int coord : points )
+    {
+        if( !inRange( coord, -128, 127 ) )
+        {
+            fprintf( stderr, "%s: coordinate out of the table range\n", argv[0] );
+            return 1;
+        }
+    }
+
+    FILE* file = fopen( argv[1], "wt" );
+
+    if( !file )
+    {
+        fprintf( stderr, "%s: cannot create %s\n", argv[0], argv[1] );
+        return 1;
+    }
+
+    fprintf( file,
+             "/*\n"
+             " * newstroke_glyphs.h - packed glyph tables of the newstroke font.\n"
+             " * Generated by newstroke_glyphs_compiler from newstroke_font.cpp: do not edit.\n"
+             " */\n\n"
+             "#ifndef NEWSTROKE_GLYPHS_H\n"
+             "#define NEWSTROKE_GLYPHS_H\n\n"
+             "#include <cstdint>\n\n"
+             "struct NEWSTROKE_GLYPH\n"
+             "{\n"
+             "    int32_t  m_FirstStroke;     ///< index of the first stroke in newstroke_strokes\n"
+             "    int32_t  m_FirstPoint;      ///< index of the first point in newstroke_points\n"
+             "    uint16_t m_StrokeCount;\n"
+             "    int8_t   m_Width;           ///< the glyph width (advance), in font units\n"
+             "};\n\n"
+             "constexpr int newstroke_glyph_count = %d;\n\n",
+             (int) glyphs.size() );
+
+    fprintf( file, "constexpr NEWSTROKE_GLYPH newstroke_glyphs[] =\n{" );
+
+    for( size_t ii = 0; ii < glyphs.size(); ++ii )
+    {
+        const GLYPH_ENTRY& glyph = glyphs[ii];
+
+        fprintf( file, "%s{%d,%d,%d,%d},", ii % 6 ? "" : "\n    ", glyph.firstStroke,
+                 glyph.firstPoint, glyph.strokeCount, glyph.width );
+    }
+
+    fprintf( file, "\n};\n\n" );
+
+    writeTable( file, "uint16_t", "newstroke_strokes", strokes );
+    writeTable( file, "int8_t", "newstroke_points", points );
+
+    fprintf( file, "#endif  // NEWSTROKE_GLYPHS_H\n" );
+
+    if( fclose( file ) != 0 )
+    {
+        fprintf( stderr, "%s: cannot write %s\n", argv[0], argv[1] );
+        return 1;
+    }
+
+    return 0;
+}
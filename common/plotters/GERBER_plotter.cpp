@@ -308,29 +308,26 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 int GERBER_PLOTTER::GetOrCreateAperture( const wxSize& aSize,
                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
-
     // Search an existing aperture
-    for( int idx = 0; idx < (int)m_apertures.size(); ++idx )
-    {
-        APERTURE* tool = &m_apertures[idx];
-        last_D_code = tool->m_DCode;
+    APERTURE_KEY key = { aType, aSize, aApertureAttribute };
+    auto it = m_apertureIndex.find( key );
 
-        if( (tool->m_Type == aType) && (tool->m_Size == aSize) &&
-            (tool->m_ApertureAttribute == aApertureAttribute) )
-            return idx;
-    }
+    if( it != m_apertureIndex.end() )
+        return it->second;
 
     // Allocate a new aperture
     APERTURE new_tool;
     new_tool.m_Size  = aSize;
     new_tool.m_Type  = aType;
-    new_tool.m_DCode = last_D_code + 1;
+    new_tool.m_DCode = m_apertures.empty() ? FIRST_DCODE_VALUE : m_apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
     m_apertures.push_back( new_tool );
 
-    return m_apertures.size() - 1;
+    int idx = m_apertures.size() - 1;
+    m_apertureIndex[key] = idx;
+
+    return idx;
 }
 
 
@@ -896,7 +893,9 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
         outline.Inflate( -GetCurrentLineWidth()/2, 16 );
     }
 
-    std::vector< wxPoint > cornerList;
+    std::vector< wxPoint >& cornerList = m_regionCorners;
+    cornerList.clear();
+
     // TransformRoundRectToPolygon creates only one convex polygon
     SHAPE_LINE_CHAIN& poly = outline.Outline( 0 );
     cornerList.reserve( poly.PointCount() + 1 );
@@ -925,21 +924,27 @@ void GERBER_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
     if( aData )
         gbr_metadata = *static_cast<GBR_METADATA*>( aData );
 
-    SHAPE_POLY_SET polyshape = *aPolygons;
+    // The polygons are only modified (inflated) in sketch mode: avoid copying them
+    // when they are plotted as filled regions, the most usual case.
+    SHAPE_POLY_SET inflated;
+    const SHAPE_POLY_SET* polyshape = aPolygons;
 
     if( aTraceMode != FILLED )
     {
         SetCurrentLineWidth( USE_DEFAULT_LINE_WIDTH, &gbr_metadata );
-        polyshape.Inflate( -GetCurrentLineWidth()/2, 16 );
+        inflated = *aPolygons;
+        inflated.Inflate( -GetCurrentLineWidth()/2, 16 );
+        polyshape = &inflated;
     }
 
-    std::vector< wxPoint > cornerList;
+    std::vector< wxPoint >& cornerList = m_regionCorners;
 
-    for( int cnt = 0; cnt < polyshape.OutlineCount(); ++cnt )
+    for( int cnt = 0; cnt < polyshape->OutlineCount(); ++cnt )
     {
-        SHAPE_LINE_CHAIN& poly = polyshape.Outline( cnt );
+        const SHAPE_LINE_CHAIN& poly = polyshape->COutline( cnt );
 
         cornerList.clear();
+        cornerList.reserve( poly.PointCount() + 1 );
 
         for( int ii = 0; ii < poly.PointCount(); ++ii )
             cornerList.emplace_back( poly.CPoint( ii ).x, poly.CPoint( ii ).y );
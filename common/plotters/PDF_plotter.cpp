@@ -36,9 +36,121 @@
 #include <plotter.h>
 #include <macros.h>
 #include <kicad_string.h>
+#include <richio.h>
 #include <wx/zstream.h>
 #include <wx/mstream.h>
 
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+
+
+/**
+ * Compress aContent in a zlib stream.  The PDF spec is misleading, it says it wants
+ * a DEFLATE stream but it really want a ZLIB stream! (a DEFLATE stream would be
+ * generated with -15 instead of 15)
+ */
+static std::string compressPdfStream( const std::string& aContent, int aLevel )
+{
+    // NULL means memos owns the memory, but provide a hint on optimum size needed.
+    wxMemoryOutputStream memos( NULL, std::max( (size_t) 2000, aContent.size() / 4 ) );
+
+    {
+        wxZlibOutputStream zos( memos, aLevel, wxZLIB_ZLIB );
+        zos.Write( aContent.data(), aContent.size() );
+    }   // flush the zip stream using zos destructor
+
+    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+
+    return std::string( (const char*) sb->GetBufferStart(), sb->Tell() );
+}
+
+
+/**
+ * The content stream of the page being plotted.  It is compressed while it is written,
+ * unless its compression is deferred to a worker thread: in this case the content is
+ * stored until the page is closed.
+ */
+class PDF_PAGE_STREAM : public OUTPUTFORMATTER
+{
+public:
+    PDF_PAGE_STREAM( int aCompressionLevel, bool aDeferCompression ) :
+        m_memStream( NULL, 16384 )
+    {
+        if( !aDeferCompression )
+            m_zStream.reset( new wxZlibOutputStream( m_memStream, aCompressionLevel,
+                                                     wxZLIB_ZLIB ) );
+    }
+
+    /// Write aCount bytes, which can be binary data
+    void WriteRaw( const char* aData, int aCount )
+    {
+        write( aData, aCount );
+    }
+
+    /// @return the compressed stream; nothing can be written after this call
+    std::string Finish()
+    {
+        wxASSERT( m_zStream );
+
+        m_zStream.reset();     // flush the zip stream
+
+        wxStreamBuffer* sb = m_memStream.GetOutputStreamBuffer();
+
+        return std::string( (const char*) sb->GetBufferStart(), sb->Tell() );
+    }
+
+    /// @return the uncompressed content, when the compression is deferred
+    std::string TakeContent()
+    {
+        wxASSERT( !m_zStream );
+
+        return std::move( m_content );
+    }
+
+protected:
+    void write( const char* aOutBuf, int aCount ) override
+    {
+        if( m_zStream )
+            m_zStream->Write( aOutBuf, aCount );
+        else
+            m_content.append( aOutBuf, aCount );
+    }
+
+private:
+    wxMemoryOutputStream                m_memStream;
+    std::unique_ptr<wxZlibOutputStream> m_zStream;
+    std::string                         m_content;
+};
+
+
+/**
+ * A page stream compressed by a worker thread, and waiting to be written.
+ */
+struct PDF_PENDING_STREAM
+{
+    int                      m_handle;
+    int                      m_lengthHandle;
+    std::future<std::string> m_data;
+};
+
+
+PDF_PLOTTER::PDF_PLOTTER() :
+    pageStreamHandle( 0 ),
+    m_compressionLevel( wxZ_BEST_COMPRESSION ),
+    m_threadedCompression( false )
+{
+    // Avoid non initialized variables:
+    pageStreamHandle = streamHandle = streamLengthHandle = fontResDictHandle = 0;
+    pageTreeHandle = 0;
+}
+
+
+PDF_PLOTTER::~PDF_PLOTTER()
+{
+}
+
 
 /*
  * Open or create the plot file aFullFilename
@@ -94,7 +206,7 @@ void PDF_PLOTTER::SetViewport( const wxPoint& aOffset, double aIusPerDecimil,
  */
 void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     int pen_width;
 
     if( width > 0 )
@@ -105,7 +217,7 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
         pen_width = defaultPenWidth;
 
     if( pen_width != currentPenWidth )
-        fprintf( workFile, "%g w\n",
+        workStream->Print( 0, "%g w\n",
                  userToDeviceSize( pen_width ) );
 
     currentPenWidth = pen_width;
@@ -123,8 +235,8 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
  */
 void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
 {
-    wxASSERT( workFile );
-    fprintf( workFile, "%g %g %g rg %g %g %g RG\n",
+    wxASSERT( workStream );
+    workStream->Print( 0, "%g %g %g rg %g %g %g RG\n",
              r, g, b, r, g, b );
 }
 
@@ -133,24 +245,24 @@ void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
  */
 void PDF_PLOTTER::SetDash( int dashed )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     switch( dashed )
     {
     case PLOTDASHTYPE_DASH:
-        fprintf( workFile, "[%d %d] 0 d\n",
+        workStream->Print( 0, "[%d %d] 0 d\n",
                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DOT:
-        fprintf( workFile, "[%d %d] 0 d\n",
+        workStream->Print( 0, "[%d %d] 0 d\n",
                 (int) GetDotMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DASHDOT:
-        fprintf( workFile, "[%d %d %d %d] 0 d\n",
+        workStream->Print( 0, "[%d %d %d %d] 0 d\n",
                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU(),
                 (int) GetDotMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     default:
-        fputs( "[] 0 d\n", workFile );
+        workStream->Print( 0, "[] 0 d\n" );
     }
 }
 
@@ -160,12 +272,12 @@ void PDF_PLOTTER::SetDash( int dashed )
  */
 void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     DPOINT p1_dev = userToDeviceCoordinates( p1 );
     DPOINT p2_dev = userToDeviceCoordinates( p2 );
 
     SetCurrentLineWidth( width );
-    fprintf( workFile, "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
+    workStream->Print( 0, "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
              p2_dev.x - p1_dev.x, p2_dev.y - p1_dev.y,
              fill == NO_FILL ? 'S' : 'B' );
 }
@@ -176,7 +288,7 @@ void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int w
  */
 void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     DPOINT pos_dev = userToDeviceCoordinates( pos );
     double radius = userToDeviceSize( diametre / 2.0 );
 
@@ -200,11 +312,11 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
     double magic = radius * 0.551784; // You don't want to know where this come from
 
     // This is the convex hull for the bezier approximated circle
-    fprintf( workFile, "%g %g m "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c %c\n",
+    workStream->Print( 0, "%g %g m "
+                          "%g %g %g %g %g %g c "
+                          "%g %g %g %g %g %g c "
+                          "%g %g %g %g %g %g c "
+                          "%g %g %g %g %g %g c %c\n",
              pos_dev.x - radius, pos_dev.y,
 
              pos_dev.x - radius, pos_dev.y + magic,
@@ -234,7 +346,7 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
 void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, int radius,
                       FILL_T fill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( radius <= 0 )
     {
         Circle( centre, width, FILLED_SHAPE, 0 );
@@ -255,30 +367,30 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
     start.x = centre.x + KiROUND( cosdecideg( radius, -StAngle ) );
     start.y = centre.y + KiROUND( sindecideg( radius, -StAngle ) );
     DPOINT pos_dev = userToDeviceCoordinates( start );
-    fprintf( workFile, "%g %g m ", pos_dev.x, pos_dev.y );
+    workStream->Print( 0, "%g %g m ", pos_dev.x, pos_dev.y );
     for( int ii = StAngle + delta; ii < EndAngle; ii += delta )
     {
         end.x = centre.x + KiROUND( cosdecideg( radius, -ii ) );
         end.y = centre.y + KiROUND( sindecideg( radius, -ii ) );
         pos_dev = userToDeviceCoordinates( end );
-        fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+        workStream->Print( 0, "%g %g l ", pos_dev.x, pos_dev.y );
     }
 
     end.x = centre.x + KiROUND( cosdecideg( radius, -EndAngle ) );
     end.y = centre.y + KiROUND( sindecideg( radius, -EndAngle ) );
     pos_dev = userToDeviceCoordinates( end );
-    fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+    workStream->Print( 0, "%g %g l ", pos_dev.x, pos_dev.y );
 
     // The arc is drawn... if not filled we stroke it, otherwise we finish
     // closing the pie at the center
     if( fill == NO_FILL )
     {
-        fputs( "S\n", workFile );
+        workStream->Print( 0, "S\n" );
     }
     else
     {
         pos_dev = userToDeviceCoordinates( centre );
-        fprintf( workFile, "%g %g l b\n", pos_dev.x, pos_dev.y );
+        workStream->Print( 0, "%g %g l b\n", pos_dev.x, pos_dev.y );
     }
 }
 
@@ -289,34 +401,34 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
 void PDF_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
                            FILL_T aFill, int aWidth, void * aData )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( aCornerList.size() <= 1 )
         return;
 
     SetCurrentLineWidth( aWidth );
 
     DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( workFile, "%g %g m\n", pos.x, pos.y );
+    workStream->Print( 0, "%g %g m\n", pos.x, pos.y );
 
     for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
     {
         pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( workFile, "%g %g l\n", pos.x, pos.y );
+        workStream->Print( 0, "%g %g l\n", pos.x, pos.y );
     }
 
     // Close path and stroke(/fill)
-    fprintf( workFile, "%c\n", aFill == NO_FILL ? 'S' : 'b' );
+    workStream->Print( 0, "%c\n", aFill == NO_FILL ? 'S' : 'b' );
 }
 
 
 void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( plume == 'Z' )
     {
         if( penState != 'Z' )
         {
-            fputs( "S\n", workFile );
+            workStream->Print( 0, "S\n" );
             penState     = 'Z';
             penLastpos.x = -1;
             penLastpos.y = -1;
@@ -327,7 +439,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
     if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( workFile, "%g %g %c\n",
+        workStream->Print( 0, "%g %g %c\n",
                  pos_dev.x, pos_dev.y,
                  ( plume=='D' ) ? 'l' : 'm' );
     }
@@ -341,7 +453,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
                             double aScaleFactor )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     wxSize pix_size( aImage.GetWidth(), aImage.GetHeight() );
 
     // Requested size (in IUs)
@@ -364,7 +476,7 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
        3) restore the CTM
        4) profit
      */
-    fprintf( workFile, "q %g 0 0 %g %g %g cm\n", // Step 1
+    workStream->Print( 0, "q %g 0 0 %g %g %g cm\n", // Step 1
             userToDeviceSize( drawsize.x ),
             userToDeviceSize( drawsize.y ),
             dev_start.x, dev_start.y );
@@ -373,7 +485,7 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
        A real ugly construct (compared with the elegance of the PDF
        format). Also it accepts some 'abbreviations', which is stupid
        since the content stream is usually compressed anyway... */
-    fprintf( workFile,
+    workStream->Print( 0,
              "BI\n"
              "  /BPC 8\n"
              "  /CS %s\n"
@@ -383,8 +495,13 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
 
     /* Here comes the stream (in binary!). I *could* have hex or ascii84
        encoded it, but who cares? I'll go through zlib anyway */
+    std::string row;
+    row.reserve( pix_size.x * 3 );
+
     for( int y = 0; y < pix_size.y; y++ )
     {
+        row.clear();
+
         for( int x = 0; x < pix_size.x; x++ )
         {
             unsigned char r = aImage.GetRed( x, y ) & 0xFF;
@@ -415,23 +532,24 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
                 }
             }
 
-            // As usual these days, stdio buffering has to suffeeeeerrrr
             if( colorMode )
             {
-                putc( r, workFile );
-                putc( g, workFile );
-                putc( b, workFile );
+                row += (char) r;
+                row += (char) g;
+                row += (char) b;
             }
             else
             {
                 // Greyscale conversion (CIE 1931)
                 unsigned char grey = KiROUND( r * 0.2126 + g * 0.7152 + b * 0.0722 );
-                putc( grey, workFile );
+                row += (char) grey;
             }
         }
+
+        workStream->WriteRaw( row.data(), row.size() );
     }
 
-    fputs( "EI Q\n", workFile ); // Finish step 2 and do step 3
+    workStream->Print( 0, "EI Q\n" ); // Finish step 2 and do step 3
 }
 
 
@@ -454,7 +572,7 @@ int PDF_PLOTTER::allocPdfObject()
 int PDF_PLOTTER::startPdfObject(int handle)
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
 
     if( handle < 0)
         handle = allocPdfObject();
@@ -471,7 +589,7 @@ int PDF_PLOTTER::startPdfObject(int handle)
 void PDF_PLOTTER::closePdfObject()
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
     fputs( "endobj\n", outputFile );
 }
 
@@ -481,24 +599,24 @@ void PDF_PLOTTER::closePdfObject()
  * Pass -1 (default) for a fresh object. Especially from PDF 1.5 streams
  * can contain a lot of things, but for the moment we only handle page
  * content.
+ * The stream object itself is written when the stream is closed, after its
+ * compression.
  */
 int PDF_PLOTTER::startPdfStream(int handle)
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
-    handle = startPdfObject( handle );
+    wxASSERT( !workStream );
 
-    // This is guaranteed to be handle+1 but needs to be allocated since
-    // you could allocate more object during stream preparation
+    if( handle < 0 )
+        handle = allocPdfObject();
+
+    streamHandle = handle;
     streamLengthHandle = allocPdfObject();
-    fprintf( outputFile,
-             "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
-             "stream\n", handle + 1 );
 
-    // Open a temporary file to accumulate the stream
-    workFilename = filename + wxT(".tmp");
-    workFile = wxFopen( workFilename, wxT( "w+b" ));
-    wxASSERT( workFile );
+    // The stream is built in memory: compressed while it is written, or later by
+    // a worker thread
+    workStream.reset( new PDF_PAGE_STREAM( m_compressionLevel, m_threadedCompression ) );
+
     return handle;
 }
 
@@ -508,70 +626,82 @@ int PDF_PLOTTER::startPdfStream(int handle)
  */
 void PDF_PLOTTER::closePdfStream()
 {
-    wxASSERT( workFile );
-
-    long stream_len = ftell( workFile );
+    wxASSERT( workStream );
 
-    if( stream_len < 0 )
+    if( m_threadedCompression )
     {
-        wxASSERT( false );
-        return;
-    }
+        // Do not run too many compressions at once: wait for the oldest one
+        unsigned maxPending = std::max( 1u, std::thread::hardware_concurrency() );
 
-    // Rewind the file, read in the page stream and DEFLATE it
-    fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
+        if( m_pendingStreams.size() >= maxPending )
+            m_pendingStreams.front()->m_data.wait();
 
-    int rc = fread( inbuf, 1, stream_len, workFile );
-    wxASSERT( rc == stream_len );
-    (void) rc;
+        std::unique_ptr<PDF_PENDING_STREAM> pending( new PDF_PENDING_STREAM );
+        pending->m_handle = streamHandle;
+        pending->m_lengthHandle = streamLengthHandle;
+        pending->m_data = std::async( std::launch::async, compressPdfStream,
+                                      workStream->TakeContent(), m_compressionLevel );
 
-    // We are done with the temporary file, junk it
-    fclose( workFile );
-    workFile = 0;
-    ::wxRemoveFile( workFilename );
-
-    // NULL means memos owns the memory, but provide a hint on optimum size needed.
-    wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
+        workStream.reset();
+        m_pendingStreams.push_back( std::move( pending ) );
 
+        writePendingStreams( false );
+    }
+    else
     {
-        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
-         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
-         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
-         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
-         *                    8, Z_DEFAULT_STRATEGY );
-         */
-
-        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
-
-        zos.Write( inbuf, stream_len );
+        std::string data = workStream->Finish();
+        workStream.reset();
 
-        delete[] inbuf;
+        writePdfStream( streamHandle, streamLengthHandle, data );
+    }
+}
 
-    }   // flush the zip stream using zos destructor
 
-    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+void PDF_PLOTTER::writePdfStream( int aHandle, int aLengthHandle, const std::string& aData )
+{
+    startPdfObject( aHandle );
 
-    unsigned out_count = sb->Tell();
+    fprintf( outputFile,
+             "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
+             "stream\n", aLengthHandle );
 
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
+    fwrite( aData.data(), 1, aData.size(), outputFile );
 
     fputs( "endstream\n", outputFile );
     closePdfObject();
 
     // Writing the deferred length as an indirect object
-    startPdfObject( streamLengthHandle );
-    fprintf( outputFile, "%u\n", out_count );
+    startPdfObject( aLengthHandle );
+    fprintf( outputFile, "%u\n", (unsigned) aData.size() );
     closePdfObject();
 }
 
+
+void PDF_PLOTTER::writePendingStreams( bool aWaitAll )
+{
+    size_t count = 0;
+
+    for( ; count < m_pendingStreams.size(); count++ )
+    {
+        PDF_PENDING_STREAM& pending = *m_pendingStreams[count];
+
+        if( !aWaitAll && pending.m_data.wait_for( std::chrono::seconds( 0 ) )
+                                != std::future_status::ready )
+            break;
+
+        writePdfStream( pending.m_handle, pending.m_lengthHandle, pending.m_data.get() );
+    }
+
+    m_pendingStreams.erase( m_pendingStreams.begin(), m_pendingStreams.begin() + count );
+}
+
 /**
  * Starts a new page in the PDF document
  */
 void PDF_PLOTTER::StartPage()
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
 
     // Compute the paper size in IUs
     paperSize = pageInfo.GetSizeMils();
@@ -581,11 +711,11 @@ void PDF_PLOTTER::StartPage()
     // Open the content stream; the page object will go later
     pageStreamHandle = startPdfStream();
 
-    /* Now, until ClosePage *everything* must be wrote in workFile, to be
-       compressed later in closePdfStream */
+    /* Now, until ClosePage *everything* must be wrote in workStream, to be
+       compressed by closePdfStream */
 
     // Default graphic settings (coordinate system, default color and line style)
-    fprintf( workFile,
+    workStream->Print( 0,
              "%g 0 0 %g 0 0 cm 1 J 1 j 0 0 0 rg 0 0 0 RG %g w\n",
              0.0072 * plotScaleAdjX, 0.0072 * plotScaleAdjY,
              userToDeviceSize( defaultPenWidth ) );
@@ -596,7 +726,7 @@ void PDF_PLOTTER::StartPage()
  */
 void PDF_PLOTTER::ClosePage()
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
 
     // Close the page stream (and compress it)
     closePdfStream();
@@ -675,6 +805,9 @@ bool PDF_PLOTTER::EndPlot()
     // Close the current page (often the only one)
     ClosePage();
 
+    // Wait for the page streams still compressed by worker threads
+    writePendingStreams( true );
+
     /* We need to declare the resources we're using (fonts in particular)
        The useful standard one is the Helvetica family. Adding external fonts
        is *very* involved! */
@@ -855,14 +988,15 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
        for the trig part of the matrix to avoid %g going in exponential
        format (which is not supported)
        render_mode 0 shows the text, render_mode 3 is invisible */
-    fprintf( workFile, "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
+    workStream->Print( 0, "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
             ctm_a, ctm_b, ctm_c, ctm_d, ctm_e, ctm_f,
             fontname, heightFactor, render_mode,
             wideningFactor * 100 );
 
     // The text must be escaped correctly
-    fputsPostscriptString( workFile, aText );
-    fputs( " Tj ET\n", workFile );
+    std::string escaped = encodePostscriptString( aText );
+    workStream->WriteRaw( escaped.data(), escaped.size() );
+    workStream->Print( 0, " Tj ET\n" );
 
     // We are in text coordinates, plot the overbars, if we're not doing phantom text
     if( use_native_font )
@@ -878,13 +1012,13 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
                is the right function to use here... */
             DPOINT dev_from = userToDeviceSize( wxSize( pos_pairs[i], overbar_y ) );
             DPOINT dev_to = userToDeviceSize( wxSize( pos_pairs[i + 1], overbar_y ) );
-            fprintf( workFile, "%g %g m %g %g l ",
+            workStream->Print( 0, "%g %g m %g %g l ",
                     dev_from.x, dev_from.y, dev_to.x, dev_to.y );
         }
     }
 
     // Stroke and restore the CTM
-    fputs( "S Q\n", workFile );
+    workStream->Print( 0, "S Q\n" );
 
     // Plot the stroked text (if requested)
     if( !use_native_font )
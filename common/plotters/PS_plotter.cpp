@@ -136,9 +136,9 @@ void PSLIKE_PLOTTER::FlashPadCircle( const wxPoint& aPadPos, int aDiameter,
 void PSLIKE_PLOTTER::FlashPadRect( const wxPoint& aPadPos, const wxSize& aSize,
                                    double aPadOrient, EDA_DRAW_MODE_T aTraceMode, void* aData )
 {
-    static std::vector< wxPoint > cornerList;
+    // Not static: layers are plotted by several threads at once.
+    std::vector< wxPoint > cornerList;
     wxSize size( aSize );
-    cornerList.clear();
 
     if( aTraceMode == FILLED )
         SetCurrentLineWidth( 0 );
@@ -255,8 +255,7 @@ void PSLIKE_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
 void PSLIKE_PLOTTER::FlashPadTrapez( const wxPoint& aPadPos, const wxPoint *aCorners,
                                      double aPadOrient, EDA_DRAW_MODE_T aTraceMode, void* aData )
 {
-    static std::vector< wxPoint > cornerList;
-    cornerList.clear();
+    std::vector< wxPoint > cornerList;
 
     for( int ii = 0; ii < 4; ii++ )
         cornerList.push_back( aCorners[ii] );
@@ -312,10 +311,24 @@ void PSLIKE_PLOTTER::FlashRegularPolygon( const wxPoint& aShapePos,
  */
 void PSLIKE_PLOTTER::fputsPostscriptString(FILE *fout, const wxString& txt)
 {
-    putc( '(', fout );
+    std::string escaped = encodePostscriptString( txt );
+
+    fwrite( escaped.data(), 1, escaped.size(), fout );
+}
+
+
+/**
+ * Build a string escaped for postscript/PDF
+ */
+std::string PSLIKE_PLOTTER::encodePostscriptString( const wxString& txt )
+{
+    std::string escaped;
+
+    escaped.reserve( txt.length() + 2 );
+    escaped += '(';
+
     for( unsigned i = 0; i < txt.length(); i++ )
     {
-        // Lazyness made me use stdio buffering yet another time...
         wchar_t ch = txt[i];
 
         if( ch < 256 )
@@ -329,17 +342,19 @@ void PSLIKE_PLOTTER::fputsPostscriptString(FILE *fout, const wxString& txt)
             case '(':
             case ')':
             case '\\':
-                putc( '\\', fout );
+                escaped += '\\';
 
                 // FALLTHRU
             default:
-                putc( ch, fout );
+                escaped += (char) ch;
                 break;
             }
         }
     }
 
-    putc( ')', fout );
+    escaped += ')';
+
+    return escaped;
 }
 
 
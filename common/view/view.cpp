@@ -35,8 +35,14 @@
 
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
+#include <gal/recording_gal.h>
 #include <painter.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
 #ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__  */
@@ -293,7 +299,9 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_updateThreadCount( 0 ),
+    m_tileParent( nullptr )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -1009,20 +1017,186 @@ struct VIEW::drawItem
 
 void VIEW::redrawRect( const BOX2I& aRect )
 {
+    LAYER_ORDER dirtyLayers;
+    LAYER_ORDER tiledLayers;
+    bool canTile = true;
+
     for( VIEW_LAYER* l : m_orderedLayers )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
-        {
-            drawItem drawFunc( this, l->id, m_useDrawPriority, m_reverseDrawOrder );
+            dirtyLayers.push_back( l );
+    }
+
+    // The overlay target is shown over the other ones, so the layers of the other targets
+    // can be drawn first, by screen tiles.  Cached layers are drawn from the GAL groups,
+    // tiles cannot use them.
+    for( VIEW_LAYER* l : dirtyLayers )
+    {
+        if( l->target == TARGET_CACHED )
+            canTile = false;
+        else if( l->target == TARGET_NONCACHED )
+            tiledLayers.push_back( l );
+    }
+
+    bool tiled = canTile && !tiledLayers.empty() && redrawTiles( aRect, tiledLayers );
+
+    for( VIEW_LAYER* l : dirtyLayers )
+    {
+        if( tiled && l->target == TARGET_NONCACHED )
+            continue;
+
+        drawItem drawFunc( this, l->id, m_useDrawPriority, m_reverseDrawOrder );
+
+        m_gal->SetTarget( l->target );
+        m_gal->SetLayerDepth( l->renderingOrder );
+        l->items->Query( aRect, drawFunc );
+
+        if( m_useDrawPriority )
+            drawFunc.deferredDraw();
+    }
+}
+
+
+// Below this screen height in pixels, tiles cost more than they save
+static const int TILE_MIN_HEIGHT = 32;
+
+// Tiles drawn by each worker thread, for the load balancing: items are rarely spread
+// evenly on the screen
+static const int TILES_PER_THREAD = 4;
+
+// Margin around the tiles in pixels, so the antialiasing of the items on the edges of
+// the tiles is drawn as on a full screen
+static const double TILE_MARGIN = 2.0;
+
+
+bool VIEW::redrawTiles( const BOX2I& aRect, const LAYER_ORDER& aLayers )
+{
+    int threadCount = std::thread::hardware_concurrency();
+    const VECTOR2I screenSize = m_gal->GetScreenPixelSize();
+    int tileCount = std::min( threadCount * TILES_PER_THREAD, screenSize.y / TILE_MIN_HEIGHT );
+
+    if( threadCount < 2 || tileCount < 2 || !m_painter )
+        return false;
+
+    m_gal->SetTarget( aLayers.front()->target );
+
+    // Horizontal bands, the items often being laid out along the screen width
+    std::vector<std::unique_ptr<GAL>> gals;
+    std::vector<BOX2I> rects;
+    double margin = TILE_MARGIN / m_gal->GetWorldScale();
+
+    for( int ii = 0; ii < tileCount; ++ii )
+    {
+        int top = screenSize.y * ii / tileCount;
+        int bottom = screenSize.y * ( ii + 1 ) / tileCount;
+        BOX2I screenRect( VECTOR2I( 0, top ), VECTOR2I( screenSize.x, bottom - top ) );
+        std::unique_ptr<GAL> gal( m_gal->CreateTileGAL( screenRect ) );
+
+        if( !gal )
+            return false;
 
-            m_gal->SetTarget( l->target );
-            m_gal->SetLayerDepth( l->renderingOrder );
-            l->items->Query( aRect, drawFunc );
+        VECTOR2D origin = ToWorld( VECTOR2D( screenRect.GetOrigin() ) );
+        BOX2D rect( origin, ToWorld( VECTOR2D( screenRect.GetEnd() ) ) - origin );
+        BOX2I recti = aRect;
 
-            if( m_useDrawPriority )
-                drawFunc.deferredDraw();
+        rect.Normalize();
+        rect.Inflate( margin, margin );
+
+        // As in Redraw(), the view rtree uses integer positions
+        if( rect.GetWidth() <= std::numeric_limits<int>::max()
+                && rect.GetHeight() <= std::numeric_limits<int>::max() )
+            recti = BOX2I( rect.GetPosition(), rect.GetSize() ).Intersect( aRect );
+
+        gals.push_back( std::move( gal ) );
+        rects.push_back( recti );
+    }
+
+    std::vector<std::unique_ptr<PAINTER>> painters;
+
+    for( int ii = 0; ii < std::min( threadCount, tileCount ); ++ii )
+    {
+        std::unique_ptr<PAINTER> painter( m_painter->Clone( gals[0].get() ) );
+
+        if( !painter )
+            break;
+
+        painters.push_back( std::move( painter ) );
+    }
+
+    if( painters.empty() )
+        return false;
+
+    // Each worker draws through a view of its own, to give the items drawing themselves
+    // (VIEW_ITEM::ViewDraw()) the GAL and the painter of the tile
+    while( m_tileViews.size() < painters.size() )
+        m_tileViews.emplace_back( new VIEW( m_dynamic ) );
+
+    for( size_t ii = 0; ii < painters.size(); ++ii )
+    {
+        VIEW* view = m_tileViews[ii].get();
+
+        view->m_tileParent = this;
+        view->m_painter = painters[ii].get();
+        view->m_center = m_center;
+        view->m_scale = m_scale;
+        view->m_mirrorX = m_mirrorX;
+        view->m_mirrorY = m_mirrorY;
+        view->m_printMode = m_printMode;
+
+        for( const auto& entry : m_layers )
+        {
+            view->AddLayer( entry.first );
+
+            VIEW_LAYER& layer = view->m_layers[entry.first];
+            layer.visible = entry.second.visible;
+            layer.displayOnly = entry.second.displayOnly;
+            layer.renderingOrder = entry.second.renderingOrder;
+            layer.target = entry.second.target;
         }
     }
+
+    std::atomic<int> nextTile( 0 );
+    std::vector<std::thread> workers;
+
+    for( size_t ii = 0; ii < painters.size(); ++ii )
+    {
+        workers.emplace_back( [&, ii]()
+        {
+            VIEW* view = m_tileViews[ii].get();
+
+            for( int tile = nextTile++; tile < tileCount; tile = nextTile++ )
+            {
+                GAL* gal = gals[tile].get();
+
+                view->m_gal = gal;
+                view->m_painter->SetGAL( gal );
+
+                for( VIEW_LAYER* l : aLayers )
+                {
+                    drawItem drawFunc( view, l->id, m_useDrawPriority, m_reverseDrawOrder );
+
+                    gal->SetLayerDepth( l->renderingOrder );
+                    l->items->Query( rects[tile], drawFunc );
+
+                    if( m_useDrawPriority )
+                        drawFunc.deferredDraw();
+                }
+
+                gal->Flush();
+            }
+        } );
+    }
+
+    for( std::thread& worker : workers )
+        worker.join();
+
+    for( auto& view : m_tileViews )
+    {
+        view->m_painter = nullptr;
+        view->m_gal = nullptr;
+    }
+
+    return true;
 }
 
 
@@ -1047,7 +1221,18 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     {
         // Immediate mode
         if( !m_painter->Draw( aItem, aLayer ) )
-            aItem->ViewDraw( aLayer, this );  // Alternative drawing method
+        {
+            // Alternative drawing method, not required to be thread safe
+            if( m_tileParent )
+            {
+                std::lock_guard<std::mutex> lock( m_tileParent->m_viewDrawMutex );
+                aItem->ViewDraw( aLayer, this );
+            }
+            else
+            {
+                aItem->ViewDraw( aLayer, this );
+            }
+        }
     }
 }
 
@@ -1213,7 +1398,7 @@ void VIEW::clearGroupCache()
 }
 
 
-void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
+void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags, ITEM_LAYER_LIST& aRedrawList )
 {
     if( aUpdateFlags & INITIAL_ADD )
     {
@@ -1245,7 +1430,7 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
         if( IsCached( layerId ) )
         {
             if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
-                updateItemGeometry( aItem, layerId );
+                aRedrawList.emplace_back( aItem, layerId );
             else if( aUpdateFlags & COLOR )
                 updateItemColor( aItem, layerId );
         }
@@ -1292,7 +1477,8 @@ void VIEW::updateItemColor( VIEW_ITEM* aItem, int aLayer )
 }
 
 
-void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
+void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer,
+                               const GAL_DISPLAY_LIST* aDisplayList )
 {
     auto viewData = aItem->viewPrivData();
     wxCHECK( (unsigned) aLayer < m_layers.size(), /*void*/ );
@@ -1315,13 +1501,134 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     group = m_gal->BeginGroup();
     viewData->setGroup( aLayer, group );
 
-    if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
+    if( aDisplayList )
+        aDisplayList->Replay( *m_gal );
+    else if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
         aItem->ViewDraw( aLayer, this ); // Alternative drawing method
 
     m_gal->EndGroup();
 }
 
 
+// Below this count of items to draw, worker threads cost more than they save
+static const size_t PARALLEL_UPDATE_MIN_ITEMS = 256;
+
+// The count of items recorded by the workers while the previous ones are cached
+static const size_t PARALLEL_UPDATE_BATCH_ITEMS = 2048;
+
+
+void VIEW::updateItemsGeometry( const ITEM_LAYER_LIST& aItems )
+{
+    // The entries of an item are handled by the same worker, painters may update
+    // caches of the items they draw (e.g. polygon triangulation)
+    std::vector<size_t> itemStarts;
+
+    for( size_t ii = 0; ii < aItems.size(); ++ii )
+    {
+        if( ii == 0 || aItems[ii].first != aItems[ii - 1].first )
+            itemStarts.push_back( ii );
+    }
+
+    size_t itemCount = itemStarts.size();
+    itemStarts.push_back( aItems.size() );
+
+    std::vector<std::unique_ptr<RECORDING_GAL>> gals;
+    std::vector<std::unique_ptr<PAINTER>> painters;
+
+    if( itemCount >= PARALLEL_UPDATE_MIN_ITEMS )
+    {
+        unsigned threadCount = m_updateThreadCount;
+
+        if( threadCount == 0 )
+            threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+
+        for( unsigned ii = 0; threadCount > 1 && ii < threadCount; ++ii )
+        {
+            std::unique_ptr<RECORDING_GAL> gal( new RECORDING_GAL( m_gal ) );
+            std::unique_ptr<PAINTER> painter( m_painter->Clone( gal.get() ) );
+
+            if( !painter )
+                break;
+
+            gals.push_back( std::move( gal ) );
+            painters.push_back( std::move( painter ) );
+        }
+    }
+
+    if( painters.empty() )
+    {
+        for( const auto& entry : aItems )
+            updateItemGeometry( entry.first, entry.second );
+
+        return;
+    }
+
+    typedef std::vector<std::unique_ptr<GAL_DISPLAY_LIST>> DISPLAY_LISTS;
+
+    // Record the drawings of the items aFirst to aLast - 1.  A null display list means
+    // the painter could not draw the item, it will be drawn by this thread.
+    auto recordItems = [&]( size_t aFirst, size_t aLast ) -> DISPLAY_LISTS
+    {
+        size_t firstEntry = itemStarts[aFirst];
+        DISPLAY_LISTS lists( itemStarts[aLast] - firstEntry );
+        std::atomic<size_t> nextItem( aFirst );
+        std::vector<std::thread> workers;
+
+        for( size_t ii = 0; ii < painters.size(); ++ii )
+        {
+            workers.emplace_back( [&, ii]()
+            {
+                PAINTER* painter = painters[ii].get();
+                RECORDING_GAL* gal = gals[ii].get();
+
+                for( size_t item = nextItem++; item < aLast; item = nextItem++ )
+                {
+                    for( size_t entry = itemStarts[item]; entry < itemStarts[item + 1]; ++entry )
+                    {
+                        const auto& itemLayer = aItems[entry];
+
+                        if( painter->Draw( static_cast<EDA_ITEM*>( itemLayer.first ),
+                                           itemLayer.second ) )
+                            lists[entry - firstEntry] = gal->TakeDisplayList();
+                        else
+                            gal->ClearDisplayList();
+                    }
+                }
+            } );
+        }
+
+        for( std::thread& worker : workers )
+            worker.join();
+
+        return lists;
+    };
+
+    // The GAL cache is only updated from this thread, while the next batch is recorded
+    size_t first = 0;
+    size_t last = std::min( PARALLEL_UPDATE_BATCH_ITEMS, itemCount );
+    std::future<DISPLAY_LISTS> recorded = std::async( std::launch::async, recordItems,
+                                                      first, last );
+
+    while( first < itemCount )
+    {
+        DISPLAY_LISTS lists = recorded.get();
+        size_t next = std::min( last + PARALLEL_UPDATE_BATCH_ITEMS, itemCount );
+
+        if( last < itemCount )
+            recorded = std::async( std::launch::async, recordItems, last, next );
+
+        for( size_t entry = itemStarts[first]; entry < itemStarts[last]; ++entry )
+        {
+            updateItemGeometry( aItems[entry].first, aItems[entry].second,
+                                lists[entry - itemStarts[first]].get() );
+        }
+
+        first = last;
+        last = next;
+    }
+}
+
+
 void VIEW::updateBbox( VIEW_ITEM* aItem )
 {
     int layers[VIEW_MAX_LAYERS], layers_count;
@@ -1423,6 +1730,7 @@ void VIEW::UpdateItems()
     if( m_gal->IsVisible() )
     {
         GAL_UPDATE_CONTEXT ctx( m_gal );
+        ITEM_LAYER_LIST redrawList;
 
         for( VIEW_ITEM* item : *m_allItems )
         {
@@ -1433,10 +1741,12 @@ void VIEW::UpdateItems()
 
             if( viewData->m_requiredUpdate != NONE )
             {
-                invalidateItem( item, viewData->m_requiredUpdate );
+                invalidateItem( item, viewData->m_requiredUpdate, redrawList );
                 viewData->m_requiredUpdate = NONE;
             }
         }
+
+        updateItemsGeometry( redrawList );
     }
 }
 
@@ -456,24 +456,14 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList, unsigned aNetItemRef, unsigned
                      * TODO test also if instances connected are connected to
                      * the same net
                      */
-                    for( unsigned duplicate = 0; duplicate < aList->size(); duplicate++ )
-                    {
-                        if( aList->GetItemType( duplicate ) != NET_PIN )
-                            continue;
+                    NETLIST_OBJECT* pin = aList->GetItem( aNetItemRef );
+                    wxString ref = ( (SCH_COMPONENT*) pin->m_Link )->GetRef( &pin->m_SheetPath );
 
+                    for( unsigned duplicate : aList->GetPinInstances( ref, pin->m_PinNum ) )
+                    {
                         if( duplicate == aNetItemRef )
                             continue;
 
-                        if( aList->GetItem( aNetItemRef )->m_PinNum !=
-                            aList->GetItem( duplicate )->m_PinNum )
-                            continue;
-
-                        if( ( (SCH_COMPONENT*) aList->GetItem( aNetItemRef )->
-                             m_Link )->GetRef( &aList->GetItem( aNetItemRef )-> m_SheetPath ) !=
-                            ( (SCH_COMPONENT*) aList->GetItem( duplicate )->m_Link )
-                           ->GetRef( &aList->GetItem( duplicate )->m_SheetPath ) )
-                            continue;
-
                         // Same component and same pin. Do dot create error for this pin
                         // if the other pin is connected (i.e. if duplicate net has another
                         // item)
@@ -681,16 +671,69 @@ struct compare_label_names
     }
 };
 
-struct compare_paths
+/**
+ * Helper class to count the labels identical to a given label: global labels having
+ * the same name, or labels having the same name in the same sheet path.
+ */
+class IDENTICAL_LABELS_COUNTER
 {
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 ) const
+public:
+    IDENTICAL_LABELS_COUNTER( const std::vector<NETLIST_OBJECT*>& aList )
     {
-        return lab1->m_SheetPath.Path().Cmp( lab2->m_SheetPath.Path() ) < 0;
+        for( NETLIST_OBJECT* label : aList )
+        {
+            if( label->IsLabelGlobal() )
+                m_globalCount[ label->m_Label ]++;
+
+            m_localCount[ std::make_pair( label->m_SheetPath.Path(), label->m_Label ) ]++;
+        }
     }
+
+    int Count( const NETLIST_OBJECT* aRef ) const
+    {
+        if( aRef->IsLabelGlobal() )
+            return m_globalCount.at( aRef->m_Label );
+
+        return m_localCount.at( std::make_pair( aRef->m_SheetPath.Path(), aRef->m_Label ) );
+    }
+
+private:
+    std::map<wxString, int> m_globalCount;
+    std::map<std::pair<wxString, wxString>, int> m_localCount;
 };
 
-// Helper functions to build the warning messages about Similar Labels:
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aRef );
+
+/**
+ * Helper function: call aFunc( labelA, labelB ) for each pair of labels of aLabels
+ * having names which are equal when using case insensitive comparisons, in the
+ * order a scan of all the pairs of aLabels would find them.
+ * Labels are bucketed by lower case name, so only similar labels are compared.
+ */
+template <typename LABEL_SET, typename FUNC>
+static void forEachSimilarLabelsPair( const LABEL_SET& aLabels, FUNC aFunc )
+{
+    std::map<wxString, std::vector<NETLIST_OBJECT*>> buckets;
+
+    for( NETLIST_OBJECT* label : aLabels )
+        buckets[ label->m_Label.Lower() ].push_back( label );
+
+    std::map<wxString, size_t> position;
+
+    for( NETLIST_OBJECT* label : aLabels )
+    {
+        wxString key = label->m_Label.Lower();
+        const std::vector<NETLIST_OBJECT*>& similar = buckets[ key ];
+
+        for( size_t ii = ++position[ key ]; ii < similar.size(); ii++ )
+        {
+            if( label->m_Label.CmpNoCase( similar[ii]->m_Label ) == 0 )
+                aFunc( label, similar[ii] );
+        }
+    }
+}
+
+
+// Helper function to build the warning messages about Similar Labels:
 static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB );
 
 
@@ -703,7 +746,6 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     std::vector<NETLIST_OBJECT*> fullLabelList;
     // list of all labels , each label appears only once (used to to detect similar labels)
     std::set<NETLIST_OBJECT*, compare_labels> uniqueLabelList;
-    wxString msg;
 
     // Build a list of differents labels. If inside a given sheet there are
     // more than one given label, only one label is stored.
@@ -734,6 +776,17 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         }
     }
 
+    IDENTICAL_LABELS_COUNTER identicalLabels( fullLabelList );
+
+    auto diagnose = [&]( NETLIST_OBJECT* aLabelA, NETLIST_OBJECT* aLabelB )
+    {
+        // Create new marker for ERC.
+        if( identicalLabels.Count( aLabelA ) <= identicalLabels.Count( aLabelB ) )
+            SimilarLabelsDiagnose( aLabelA, aLabelB );
+        else
+            SimilarLabelsDiagnose( aLabelB, aLabelA );
+    };
+
     // build global labels and compare
     std::set<NETLIST_OBJECT*, compare_label_names> loc_labelList;
 
@@ -744,103 +797,32 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     }
 
     // compare global labels (same label names appears only once in list)
-    for( auto it = loc_labelList.begin(); it != loc_labelList.end(); ++it )
-    {
-        auto it_aux = it;
+    forEachSimilarLabelsPair( loc_labelList, diagnose );
 
-        for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-        {
-            if( (*it)->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-            {
-                // Create new marker for ERC.
-                int cntA = countIndenticalLabels( fullLabelList, *it );
-                int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                if( cntA <= cntB )
-                    SimilarLabelsDiagnose( (*it), (*it_aux) );
-                else
-                    SimilarLabelsDiagnose( (*it_aux), (*it) );
-            }
-        }
-    }
-
-    // Build paths list
-    std::set<NETLIST_OBJECT*, compare_paths> pathsList;
+    // Build the label list of each sheet path, in one pass
+    std::map<wxString, std::set<NETLIST_OBJECT*, compare_label_names>> pathsList;
 
     for( auto it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
-        pathsList.insert( *it );
+        pathsList[ (*it)->m_SheetPath.Path() ].insert( *it );
 
     // Examine each label inside a sheet path:
-    for( auto it = pathsList.begin(); it != pathsList.end(); ++it )
+    // Detect similar labels (same label names appears only once in list)
+    for( const auto& path : pathsList )
     {
-        loc_labelList.clear();
-
-        auto it_uniq = uniqueLabelList.begin();
-
-        for( ; it_uniq != uniqueLabelList.end(); ++it_uniq )
-        {
-            if( ( *it )->m_SheetPath.Path() == ( *it_uniq )->m_SheetPath.Path() )
-                loc_labelList.insert( *it_uniq );
-        }
-
-        // at this point, loc_labelList contains labels of the current sheet path.
-        // Detect similar labels (same label names appears only once in list)
-
-        for( auto ref_it = loc_labelList.begin(); ref_it != loc_labelList.end(); ++ref_it )
-        {
-            NETLIST_OBJECT* ref_item = *ref_it;
-            auto it_aux = ref_it;
-
-            for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-            {
-                // global label versus global label was already examined.
-                // here, at least one label must be local
-                if( ref_item->IsLabelGlobal() && ( *it_aux )->IsLabelGlobal() )
-                    continue;
-
-                if( ref_item->m_Label.CmpNoCase( ( *it_aux )->m_Label ) == 0 )
+        forEachSimilarLabelsPair( path.second,
+                [&]( NETLIST_OBJECT* aRef, NETLIST_OBJECT* aOther )
                 {
-                    // Create new marker for ERC.
-                    int cntA = countIndenticalLabels( fullLabelList, ref_item );
-                    int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                    if( cntA <= cntB )
-                        SimilarLabelsDiagnose( ref_item, ( *it_aux ) );
-                    else
-                        SimilarLabelsDiagnose( ( *it_aux ), ref_item );
-                }
-            }
-        }
-    }
-}
+                    // global label versus global label was already examined.
+                    // here, at least one label must be local
+                    if( aRef->IsLabelGlobal() && aOther->IsLabelGlobal() )
+                        return;
 
-// Helper function: count the number of labels identical to aLabel
-//  for global label: global labels in the full project
-//  for local label: all labels in the current sheet
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aRef )
-{
-    int count = 0;
-
-    if( aRef->IsLabelGlobal() )
-    {
-        for( auto i : aList)
-        {
-            if( i->IsLabelGlobal() && i->m_Label == aRef->m_Label )
-                count++;
-        }
+                    diagnose( aRef, aOther );
+                } );
     }
-    else
-    {
-        for( auto i : aList)
-        {
-            if( i->m_Label == aRef->m_Label && i->m_SheetPath.Path() == aRef->m_SheetPath.Path() )
-                count++;
-        }
-    }
-
-    return count;
 }
 
+
 // Helper function: creates a marker for similar labels ERC warning
 static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB )
 {
@@ -24,6 +24,7 @@
  */
 
 #include "netlist_exporter_generic.h"
+#include "netlist_tree_writer.h"
 
 #include <build_version.h>
 #include <sch_base_frame.h>
@@ -44,39 +45,49 @@ bool NETLIST_EXPORTER_GENERIC::WriteNetlist( const wxString& aOutFileName, unsig
     for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
         m_masterList->GetItem( ii )->m_Flag = 0;
 
-    // output the XML format netlist.
-    wxXmlDocument   xdoc;
+    // output the XML format netlist, written while the design is walked.
+    // The file is opened in binary mode, like wxXmlDocument::Save() does.
+    try
+    {
+        FILE_OUTPUTFORMATTER formatter( aOutFileName, wxT( "wb" ) );
+        NETLIST_XML_WRITER   writer( &formatter );
 
-    xdoc.SetRoot( makeRoot( GNL_ALL ) );
+        writer.StartDocument();
+        writeRoot( writer, GNL_ALL );
+        writer.EndDocument();
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
 
-    return xdoc.Save( aOutFileName, 2 /* indent bug, today was ignored by wxXml lib */ );
+    return true;
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeRoot( int aCtl )
+void NETLIST_EXPORTER_GENERIC::writeRoot( NETLIST_TREE_WRITER& aWriter, int aCtl )
 {
-    XNODE*      xroot = node( "export" );
-
-    xroot->AddAttribute( "version", "D" );
+    aWriter.StartNode( "export" );
+    aWriter.AddAttribute( "version", "D" );
 
     if( aCtl & GNL_HEADER )
         // add the "design" header
-        xroot->AddChild( makeDesignHeader() );
+        writeDesignHeader( aWriter );
 
     if( aCtl & GNL_COMPONENTS )
-        xroot->AddChild( makeComponents() );
+        writeComponents( aWriter );
 
     if( aCtl & GNL_PARTS )
-        xroot->AddChild( makeLibParts() );
+        writeLibParts( aWriter );
 
     if( aCtl & GNL_LIBRARIES )
-        // must follow makeGenericLibParts()
-        xroot->AddChild( makeLibraries() );
+        // must follow writeLibParts()
+        writeLibraries( aWriter );
 
     if( aCtl & GNL_NETS )
-        xroot->AddChild( makeListOfNets() );
+        writeListOfNets( aWriter );
 
-    return xroot;
+    aWriter.EndNode();
 }
 
 
@@ -91,7 +102,8 @@ struct COMP_FIELDS
 };
 
 
-void NETLIST_EXPORTER_GENERIC::addComponentFields( XNODE* xcomp, SCH_COMPONENT* comp, SCH_SHEET_PATH* aSheet )
+void NETLIST_EXPORTER_GENERIC::writeComponentFields( NETLIST_TREE_WRITER& aWriter,
+                                                     SCH_COMPONENT* comp, SCH_SHEET_PATH* aSheet )
 {
     COMP_FIELDS fields;
 
@@ -172,40 +184,41 @@ void NETLIST_EXPORTER_GENERIC::addComponentFields( XNODE* xcomp, SCH_COMPONENT*
 
     // Do not output field values blank in netlist:
     if( fields.value.size() )
-        xcomp->AddChild( node( "value", fields.value ) );
+        aWriter.Node( "value", fields.value );
     else    // value field always written in netlist
-        xcomp->AddChild( node( "value", "~" ) );
+        aWriter.Node( "value", "~" );
 
     if( fields.footprint.size() )
-        xcomp->AddChild( node( "footprint", fields.footprint ) );
+        aWriter.Node( "footprint", fields.footprint );
 
     if( fields.datasheet.size() )
-        xcomp->AddChild( node( "datasheet", fields.datasheet ) );
+        aWriter.Node( "datasheet", fields.datasheet );
 
     if( fields.f.size() )
     {
-        XNODE* xfields;
-        xcomp->AddChild( xfields = node( "fields" ) );
+        aWriter.StartNode( "fields" );
 
         // non MANDATORY fields are output alphabetically
         for( std::map< wxString, wxString >::const_iterator it = fields.f.begin();
              it != fields.f.end();  ++it )
         {
-            XNODE*  xfield;
-            xfields->AddChild( xfield = node( "field", it->second ) );
-            xfield->AddAttribute( "name", it->first );
+            aWriter.StartNode( "field" );
+            aWriter.AddAttribute( "name", it->first );
+            aWriter.AddText( it->second );
+            aWriter.EndNode();
         }
-    }
 
+        aWriter.EndNode();
+    }
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
+void NETLIST_EXPORTER_GENERIC::writeComponents( NETLIST_TREE_WRITER& aWriter )
 {
-    XNODE*      xcomps = node( "components" );
-
     wxString    timeStamp;
 
+    aWriter.StartNode( "components" );
+
     m_ReferencesAlreadyFound.Clear();
 
     SCH_SHEET_LIST sheetList( g_RootSheet );
@@ -224,64 +237,61 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
 
             schItem = comp;
 
-            XNODE* xcomp;  // current component being constructed
-
             // Output the component's elements in order of expected access frequency.
             // This may not always look best, but it will allow faster execution
             // under XSL processing systems which do sequential searching within
             // an element.
 
-            xcomps->AddChild( xcomp = node( "comp" ) );
-            xcomp->AddAttribute( "ref", comp->GetRef( &sheetList[i] ) );
+            aWriter.StartNode( "comp" );
+            aWriter.AddAttribute( "ref", comp->GetRef( &sheetList[i] ) );
 
-            addComponentFields( xcomp, comp, &sheetList[i] );
+            writeComponentFields( aWriter, comp, &sheetList[i] );
 
-            XNODE*  xlibsource;
-            xcomp->AddChild( xlibsource = node( "libsource" ) );
+            aWriter.StartNode( "libsource" );
 
             // "logical" library name, which is in anticipation of a better search
             // algorithm for parts based on "logical_lib.part" and where logical_lib
             // is merely the library name minus path and extension.
             if( comp->GetPartRef() )
-                xlibsource->AddAttribute( "lib", comp->GetPartRef()->GetLibId().GetLibNickname() );
+                aWriter.AddAttribute( "lib", comp->GetPartRef()->GetLibId().GetLibNickname() );
 
             // We only want the symbol name, not the full LIB_ID.
-            xlibsource->AddAttribute( "part", comp->GetLibId().GetLibItemName() );
-
-            xlibsource->AddAttribute( "description", comp->GetDescription() );
+            aWriter.AddAttribute( "part", comp->GetLibId().GetLibItemName() );
 
-            XNODE* xsheetpath;
+            aWriter.AddAttribute( "description", comp->GetDescription() );
+            aWriter.EndNode();
 
-            xcomp->AddChild( xsheetpath = node( "sheetpath" ) );
-            xsheetpath->AddAttribute( "names", sheetList[i].PathHumanReadable() );
-            xsheetpath->AddAttribute( "tstamps", sheetList[i].Path() );
+            aWriter.StartNode( "sheetpath" );
+            aWriter.AddAttribute( "names", sheetList[i].PathHumanReadable() );
+            aWriter.AddAttribute( "tstamps", sheetList[i].Path() );
+            aWriter.EndNode();
 
             timeStamp.Printf( "%8.8lX", (unsigned long)comp->GetTimeStamp() );
-            xcomp->AddChild( node( "tstamp", timeStamp ) );
+            aWriter.Node( "tstamp", timeStamp );
+
+            aWriter.EndNode();
         }
     }
 
-    return xcomps;
+    aWriter.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeDesignHeader()
+void NETLIST_EXPORTER_GENERIC::writeDesignHeader( NETLIST_TREE_WRITER& aWriter )
 {
     SCH_SCREEN* screen;
-    XNODE*     xdesign = node( "design" );
-    XNODE*     xtitleBlock;
-    XNODE*     xsheet;
-    XNODE*     xcomment;
     wxString   sheetTxt;
     wxFileName sourceFileName;
 
+    aWriter.StartNode( "design" );
+
     // the root sheet is a special sheet, call it source
-    xdesign->AddChild( node( "source", g_RootSheet->GetScreen()->GetFileName() ) );
+    aWriter.Node( "source", g_RootSheet->GetScreen()->GetFileName() );
 
-    xdesign->AddChild( node( "date", DateAndTime() ) );
+    aWriter.Node( "date", DateAndTime() );
 
     // which Eeschema tool
-    xdesign->AddChild( node( "tool", wxString( "Eeschema " ) + GetBuildVersion() ) );
+    aWriter.Node( "tool", wxString( "Eeschema " ) + GetBuildVersion() );
 
     /*
         Export the sheets information
@@ -292,101 +302,76 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeDesignHeader()
     {
         screen = sheetList[i].LastScreen();
 
-        xdesign->AddChild( xsheet = node( "sheet" ) );
+        aWriter.StartNode( "sheet" );
 
         // get the string representation of the sheet index number.
         // Note that sheet->GetIndex() is zero index base and we need to increment the
         // number by one to make it human readable
         sheetTxt.Printf( "%u", i + 1 );
-        xsheet->AddAttribute( "number", sheetTxt );
-        xsheet->AddAttribute( "name", sheetList[i].PathHumanReadable() );
-        xsheet->AddAttribute( "tstamps", sheetList[i].Path() );
+        aWriter.AddAttribute( "number", sheetTxt );
+        aWriter.AddAttribute( "name", sheetList[i].PathHumanReadable() );
+        aWriter.AddAttribute( "tstamps", sheetList[i].Path() );
 
 
         TITLE_BLOCK tb = screen->GetTitleBlock();
 
-        xsheet->AddChild( xtitleBlock = node( "title_block" ) );
+        aWriter.StartNode( "title_block" );
 
-        xtitleBlock->AddChild( node( "title", tb.GetTitle() ) );
-        xtitleBlock->AddChild( node( "company", tb.GetCompany() ) );
-        xtitleBlock->AddChild( node( "rev", tb.GetRevision() ) );
-        xtitleBlock->AddChild( node( "date", tb.GetDate() ) );
+        aWriter.Node( "title", tb.GetTitle() );
+        aWriter.Node( "company", tb.GetCompany() );
+        aWriter.Node( "rev", tb.GetRevision() );
+        aWriter.Node( "date", tb.GetDate() );
 
         // We are going to remove the fileName directories.
         sourceFileName = wxFileName( screen->GetFileName() );
-        xtitleBlock->AddChild( node( "source", sourceFileName.GetFullName() ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "1" );
-        xcomment->AddAttribute( "value", tb.GetComment( 0 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "2" );
-        xcomment->AddAttribute( "value", tb.GetComment( 1 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "3" );
-        xcomment->AddAttribute( "value", tb.GetComment( 2 ) );
+        aWriter.Node( "source", sourceFileName.GetFullName() );
 
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "4" );
-        xcomment->AddAttribute( "value", tb.GetComment( 3 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "5" );
-        xcomment->AddAttribute( "value", tb.GetComment( 4 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "6" );
-        xcomment->AddAttribute( "value", tb.GetComment( 5 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "7" );
-        xcomment->AddAttribute( "value", tb.GetComment( 6 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "8" );
-        xcomment->AddAttribute( "value", tb.GetComment( 7 ) );
+        for( int ii = 0; ii < 9; ii++ )
+        {
+            aWriter.StartNode( "comment" );
+            aWriter.AddAttribute( "number", wxString::Format( "%d", ii + 1 ) );
+            aWriter.AddAttribute( "value", tb.GetComment( ii ) );
+            aWriter.EndNode();
+        }
 
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "9" );
-        xcomment->AddAttribute( "value", tb.GetComment( 8 ) );
+        aWriter.EndNode();      // title_block
+        aWriter.EndNode();      // sheet
     }
 
-    return xdesign;
+    aWriter.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeLibraries()
+void NETLIST_EXPORTER_GENERIC::writeLibraries( NETLIST_TREE_WRITER& aWriter )
 {
-    XNODE*  xlibs = node( "libraries" );     // auto_ptr
+    aWriter.StartNode( "libraries" );
 
     for( std::set<wxString>::iterator it = m_libraries.begin(); it!=m_libraries.end();  ++it )
     {
         wxString    libNickname = *it;
-        XNODE*      xlibrary;
 
         if( m_libTable->HasLibrary( libNickname ) )
         {
-            xlibs->AddChild( xlibrary = node( "library" ) );
-            xlibrary->AddAttribute( "logical", libNickname );
-            xlibrary->AddChild( node( "uri",  m_libTable->GetFullURI( libNickname ) ) );
+            aWriter.StartNode( "library" );
+            aWriter.AddAttribute( "logical", libNickname );
+            aWriter.Node( "uri",  m_libTable->GetFullURI( libNickname ) );
+            aWriter.EndNode();
         }
 
         // @todo: add more fun stuff here
     }
 
-    return xlibs;
+    aWriter.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
+void NETLIST_EXPORTER_GENERIC::writeLibParts( NETLIST_TREE_WRITER& aWriter )
 {
-    XNODE*      xlibparts = node( "libparts" );   // auto_ptr
-
     LIB_PINS    pinList;
     LIB_FIELDS  fieldList;
 
+    aWriter.StartNode( "libparts" );
+
     m_libraries.clear();
 
     for( auto lcomp : m_LibParts )
@@ -397,47 +382,49 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
         if( !libNickname.IsEmpty() )
             m_libraries.insert( libNickname );  // inserts component's library if unique
 
-        XNODE* xlibpart;
-        xlibparts->AddChild( xlibpart = node( "libpart" ) );
-        xlibpart->AddAttribute( "lib", libNickname );
-        xlibpart->AddAttribute( "part", lcomp->GetName()  );
+        aWriter.StartNode( "libpart" );
+        aWriter.AddAttribute( "lib", libNickname );
+        aWriter.AddAttribute( "part", lcomp->GetName()  );
 
         //----- show the important properties -------------------------
         if( !lcomp->GetDescription().IsEmpty() )
-            xlibpart->AddChild( node( "description", lcomp->GetDescription() ) );
+            aWriter.Node( "description", lcomp->GetDescription() );
 
         if( !lcomp->GetDocFileName().IsEmpty() )
-            xlibpart->AddChild( node( "docs",  lcomp->GetDocFileName() ) );
+            aWriter.Node( "docs",  lcomp->GetDocFileName() );
 
         // Write the footprint list
         if( lcomp->GetFootprints().GetCount() )
         {
-            XNODE*  xfootprints;
-            xlibpart->AddChild( xfootprints = node( "footprints" ) );
+            aWriter.StartNode( "footprints" );
 
             for( unsigned i=0; i<lcomp->GetFootprints().GetCount(); ++i )
             {
-                xfootprints->AddChild( node( "fp", lcomp->GetFootprints()[i] ) );
+                aWriter.Node( "fp", lcomp->GetFootprints()[i] );
             }
+
+            aWriter.EndNode();
         }
 
         //----- show the fields here ----------------------------------
         fieldList.clear();
         lcomp->GetFields( fieldList );
 
-        XNODE*     xfields;
-        xlibpart->AddChild( xfields = node( "fields" ) );
+        aWriter.StartNode( "fields" );
 
         for( unsigned i=0;  i<fieldList.size();  ++i )
         {
             if( !fieldList[i].GetText().IsEmpty() )
             {
-                XNODE*     xfield;
-                xfields->AddChild( xfield = node( "field", fieldList[i].GetText() ) );
-                xfield->AddAttribute( "name", fieldList[i].GetName(false) );
+                aWriter.StartNode( "field" );
+                aWriter.AddAttribute( "name", fieldList[i].GetName(false) );
+                aWriter.AddText( fieldList[i].GetText() );
+                aWriter.EndNode();
             }
         }
 
+        aWriter.EndNode();
+
         //----- show the pins here ------------------------------------
         pinList.clear();
         lcomp->GetPins( pinList, 0, 0 );
@@ -462,38 +449,39 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
 
         if( pinList.size() )
         {
-            XNODE*     pins;
+            aWriter.StartNode( "pins" );
 
-            xlibpart->AddChild( pins = node( "pins" ) );
             for( unsigned i=0; i<pinList.size();  ++i )
             {
-                XNODE*     pin;
-
-                pins->AddChild( pin = node( "pin" ) );
-                pin->AddAttribute( "num", pinList[i]->GetNumber() );
-                pin->AddAttribute( "name", pinList[i]->GetName() );
-                pin->AddAttribute( "type", pinList[i]->GetCanonicalElectricalTypeName() );
+                aWriter.StartNode( "pin" );
+                aWriter.AddAttribute( "num", pinList[i]->GetNumber() );
+                aWriter.AddAttribute( "name", pinList[i]->GetName() );
+                aWriter.AddAttribute( "type", pinList[i]->GetCanonicalElectricalTypeName() );
 
                 // caution: construction work site here, drive slowly
+                aWriter.EndNode();
             }
+
+            aWriter.EndNode();
         }
+
+        aWriter.EndNode();      // libpart
     }
 
-    return xlibparts;
+    aWriter.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
+void NETLIST_EXPORTER_GENERIC::writeListOfNets( NETLIST_TREE_WRITER& aWriter, bool aUseGraph )
 {
-    XNODE*      xnets = node( "nets" );      // auto_ptr if exceptions ever get used.
     wxString    netCodeTxt;
     wxString    netName;
     wxString    ref;
 
-    XNODE*      xnet = 0;
     int         netCode;
     int         lastNetCode = -1;
     int         sameNetcodeCount = 0;
+    bool        netOpen = false;        // a "net" node is currently open
 
 
     /*  output:
@@ -503,6 +491,8 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
         </net>
     */
 
+    aWriter.StartNode( "nets" );
+
     m_LibParts.clear();     // must call this function before using m_LibParts.
 
     if( aUseGraph )
@@ -514,11 +504,9 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
             bool added = false;
 
             auto code = it.first;
-            auto subgraphs = it.second;
+            const auto& subgraphs = it.second;
             auto net_name = subgraphs[0]->GetNetName();
 
-            XNODE* xnode;
-
             for( auto subgraph : subgraphs )
             {
                 auto sheet = subgraph->m_sheet;
@@ -538,17 +526,17 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
 
                         if( !added )
                         {
-                            xnets->AddChild( xnet = node( "net" ) );
+                            aWriter.StartNode( "net" );
                             netCodeTxt.Printf( "%d", code );
-                            xnet->AddAttribute( "code", netCodeTxt );
-                            xnet->AddAttribute( "name", net_name );
+                            aWriter.AddAttribute( "code", netCodeTxt );
+                            aWriter.AddAttribute( "name", net_name );
 
                             added = true;
                         }
 
-                        xnet->AddChild( xnode = node( "node" ) );
-                        xnode->AddAttribute( "ref", refText );
-                        xnode->AddAttribute( "pin", pinText );
+                        aWriter.StartNode( "node" );
+                        aWriter.AddAttribute( "ref", refText );
+                        aWriter.AddAttribute( "pin", pinText );
 
                         wxString pinName;
 
@@ -556,10 +544,15 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
                             pinName = pin->GetName();
 
                         if( !pinName.IsEmpty() )
-                            xnode->AddAttribute( "pinfunction", pinName );
+                            aWriter.AddAttribute( "pinfunction", pinName );
+
+                        aWriter.EndNode();
                     }
                 }
             }
+
+            if( added )
+                aWriter.EndNode();
         }
     }
     else
@@ -592,34 +585,31 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
 
             if( ++sameNetcodeCount == 1 )
             {
-                xnets->AddChild( xnet = node( "net" ) );
+                if( netOpen )
+                    aWriter.EndNode();
+
+                aWriter.StartNode( "net" );
                 netCodeTxt.Printf( "%d", netCode );
-                xnet->AddAttribute( "code", netCodeTxt );
-                xnet->AddAttribute( "name", netName );
+                aWriter.AddAttribute( "code", netCodeTxt );
+                aWriter.AddAttribute( "name", netName );
+                netOpen = true;
             }
 
-            XNODE*      xnode;
-            xnet->AddChild( xnode = node( "node" ) );
-            xnode->AddAttribute( "ref", ref );
-            xnode->AddAttribute( "pin",  nitem->GetPinNumText() );
+            aWriter.StartNode( "node" );
+            aWriter.AddAttribute( "ref", ref );
+            aWriter.AddAttribute( "pin",  nitem->GetPinNumText() );
 
             if( !nitem->GetPinNameText().IsEmpty() )
-                xnode->AddAttribute( "pinfunction", nitem->GetPinNameText() );
-        }
-    }
-
-    return xnets;
-}
-
+                aWriter.AddAttribute( "pinfunction", nitem->GetPinNameText() );
 
-XNODE* NETLIST_EXPORTER_GENERIC::node( const wxString& aName, const wxString& aTextualContent /* = wxEmptyString*/ )
-{
-    XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
+            aWriter.EndNode();
+        }
 
-    if( aTextualContent.Len() > 0 )     // excludes wxEmptyString, the parameter's default value
-        n->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aTextualContent ) );
+        if( netOpen )
+            aWriter.EndNode();
+    }
 
-    return n;
+    aWriter.EndNode();
 }
 
 
@@ -29,18 +29,18 @@
 #include <netlist_exporter.h>
 
 #include <project.h>
-#include <xnode.h>      // also nests: <wx/xml/xml.h>
 
 #include <sch_edit_frame.h>
 
 class CONNECTION_GRAPH;
+class NETLIST_TREE_WRITER;
 class SYMBOL_LIB_TABLE;
 
 #define GENERIC_INTERMEDIATE_NETLIST_EXT wxT( "xml" )
 
 /**
  * Enum GNL
- * is a set of bit which control the totality of the tree built by makeRoot()
+ * is a set of bit which control the totality of the tree written by writeRoot()
  */
 enum GNL_T
 {
@@ -85,63 +85,50 @@ public:
 #define GNL_ALL     ( GNL_LIBRARIES | GNL_COMPONENTS | GNL_PARTS | GNL_HEADER | GNL_NETS )
 
 protected:
-   /**
-     * Function node
-     * is a convenience function that creates a new XNODE with an optional textual child.
-     * It also provides some insulation from a possible change in XML library.
-     *
-     * @param aName is the name to associate with a new node of type wxXML_ELEMENT_NODE.
-     * @param aTextualContent is optional, and if given is the text to include in a child
-     *   of the returned node, and has type wxXML_TEXT_NODE.
-     */
-    XNODE* node( const wxString& aName, const wxString& aTextualContent = wxEmptyString );
-
     /**
-     * Function makeGenericRoot
-     * builds the entire document tree for the generic export.  This is factored
+     * Function writeRoot
+     * writes the entire document tree for the generic export.  This is factored
      * out here so we can write the tree in either S-expression file format
-     * or in XML if we put the tree built here into a wxXmlDocument.
+     * or in XML, depending on \a aWriter.  The tree is written while the design
+     * is walked, it is never built in memory.
+     * @param aWriter - the tree writer to use
      * @param aCtl - a bitset or-ed together from GNL_ENUM values
-     * @return XNODE* - the root nodes
      */
-    XNODE* makeRoot( int aCtl = GNL_ALL );
+    void writeRoot( NETLIST_TREE_WRITER& aWriter, int aCtl = GNL_ALL );
 
     /**
-     * Function makeComponents
-     * @return XNODE* - returns a sub-tree holding all the schematic components.
+     * Function writeComponents
+     * writes a sub-tree holding all the schematic components.
      */
-    XNODE* makeComponents();
+    void writeComponents( NETLIST_TREE_WRITER& aWriter );
 
     /**
-     * Function makeDesignHeader
-     * fills out a project "design" header into an XML node.
-     * @return XNODE* - the design header
+     * Function writeDesignHeader
+     * writes a project "design" header.
      */
-    XNODE* makeDesignHeader();
+    void writeDesignHeader( NETLIST_TREE_WRITER& aWriter );
 
     /**
-     * Function makeLibParts
-     * fills out an XML node with the unique library parts and returns it.
-     * @return XNODE* - the library parts nodes
+     * Function writeLibParts
+     * writes the unique library parts.
      */
-    XNODE* makeLibParts();
+    void writeLibParts( NETLIST_TREE_WRITER& aWriter );
 
     /**
-     * Function makeListOfNets
-     * fills out an XML node with a list of nets and returns it.
-     * @return XNODE* - the list of nets nodes
+     * Function writeListOfNets
+     * writes the list of nets.
      */
-    XNODE* makeListOfNets( bool aUseGraph = true );
+    void writeListOfNets( NETLIST_TREE_WRITER& aWriter, bool aUseGraph = true );
 
     /**
-     * Function makeLibraries
-     * fills out an XML node with a list of used libraries and returns it.
-     * Must have called makeGenericLibParts() before this function.
-     * @return XNODE* - the library nodes
+     * Function writeLibraries
+     * writes the list of used libraries.
+     * Must have called writeLibParts() before this function.
      */
-    XNODE* makeLibraries();
+    void writeLibraries( NETLIST_TREE_WRITER& aWriter );
 
-    void addComponentFields(  XNODE* xcomp, SCH_COMPONENT* comp, SCH_SHEET_PATH* aSheet );
+    void writeComponentFields( NETLIST_TREE_WRITER& aWriter, SCH_COMPONENT* comp,
+                               SCH_SHEET_PATH* aSheet );
 };
 
 #endif
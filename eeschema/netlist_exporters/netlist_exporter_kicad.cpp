@@ -30,9 +30,9 @@
 #include <confirm.h>
 
 #include <sch_edit_frame.h>
-#include <xnode.h>
 #include <connection_graph.h>
 #include "netlist_exporter_kicad.h"
+#include "netlist_tree_writer.h"
 
 bool NETLIST_EXPORTER_KICAD::WriteNetlist( const wxString& aOutFileName, unsigned aNetlistOptions )
 {
@@ -60,7 +60,7 @@ void NETLIST_EXPORTER_KICAD::Format( OUTPUTFORMATTER* aOut, int aCtl )
     for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
         m_masterList->GetItem( ii )->m_Flag = 0;
 
-    std::unique_ptr<XNODE> xroot( makeRoot( aCtl ) );
+    NETLIST_SEXPR_WRITER writer( aOut );
 
-    xroot->Format( aOut, 0 );
+    writeRoot( writer, aCtl );
 }
@@ -0,0 +1,197 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <macros.h>
+#include <richio.h>
+
+#include "netlist_tree_writer.h"
+
+
+void NETLIST_SEXPR_WRITER::StartNode( const wxString& aName )
+{
+    if( !m_stack.empty() )
+    {
+        OPEN_NODE& parent = m_stack.back();
+
+        // XNODE::Format() starts a new line before the first child element and
+        // after each child element having a next sibling
+        if( !parent.m_lastIsText )
+            m_out->Print( 0, "\n" );
+
+        parent.m_childCount++;
+        parent.m_lastIsText = false;
+    }
+
+    m_out->Print( (int) m_stack.size(), "(%s", TO_UTF8( aName ) );
+
+    m_stack.emplace_back();
+    m_stack.back().m_name = aName;
+}
+
+
+void NETLIST_SEXPR_WRITER::AddAttribute( const wxString& aName, const wxString& aValue )
+{
+    wxASSERT( !m_stack.empty() && m_stack.back().m_childCount == 0 );
+
+    m_out->Print( 0, " (%s %s)", TO_UTF8( aName ), m_out->Quotew( aValue ).c_str() );
+}
+
+
+void NETLIST_SEXPR_WRITER::AddText( const wxString& aContent )
+{
+    wxASSERT( !m_stack.empty() );
+
+    m_out->Print( 0, " %s", m_out->Quotew( aContent ).c_str() );
+
+    m_stack.back().m_childCount++;
+    m_stack.back().m_lastIsText = true;
+}
+
+
+void NETLIST_SEXPR_WRITER::EndNode()
+{
+    wxASSERT( !m_stack.empty() );
+
+    m_out->Print( 0, ")" );
+    m_stack.pop_back();
+}
+
+
+void NETLIST_XML_WRITER::StartDocument()
+{
+    m_out->Print( 0, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
+}
+
+
+void NETLIST_XML_WRITER::EndDocument()
+{
+    wxASSERT( m_stack.empty() );
+
+    m_out->Print( 0, "\n" );
+}
+
+
+void NETLIST_XML_WRITER::StartNode( const wxString& aName )
+{
+    if( !m_stack.empty() )
+    {
+        closeStartTag();
+        indent( (int) m_stack.size() );
+
+        m_stack.back().m_childCount++;
+        m_stack.back().m_lastIsText = false;
+    }
+
+    m_out->Print( 0, "<%s", TO_UTF8( aName ) );
+
+    m_stack.emplace_back();
+    m_stack.back().m_name = aName;
+}
+
+
+void NETLIST_XML_WRITER::AddAttribute( const wxString& aName, const wxString& aValue )
+{
+    wxASSERT( !m_stack.empty() && m_stack.back().m_childCount == 0 );
+
+    m_out->Print( 0, " %s=\"%s\"", TO_UTF8( aName ), TO_UTF8( escape( aValue, true ) ) );
+}
+
+
+void NETLIST_XML_WRITER::AddText( const wxString& aContent )
+{
+    wxASSERT( !m_stack.empty() );
+
+    closeStartTag();
+    m_out->Print( 0, "%s", TO_UTF8( escape( aContent, false ) ) );
+
+    m_stack.back().m_childCount++;
+    m_stack.back().m_lastIsText = true;
+}
+
+
+void NETLIST_XML_WRITER::EndNode()
+{
+    wxASSERT( !m_stack.empty() );
+
+    const OPEN_NODE& node = m_stack.back();
+
+    if( node.m_childCount == 0 )
+    {
+        m_out->Print( 0, "/>" );
+    }
+    else
+    {
+        // The closing tag of an element is on its own line, unless its content ends by a text
+        if( !node.m_lastIsText )
+            indent( (int) m_stack.size() - 1 );
+
+        m_out->Print( 0, "</%s>", TO_UTF8( node.m_name ) );
+    }
+
+    m_stack.pop_back();
+}
+
+
+void NETLIST_XML_WRITER::indent( int aLevel )
+{
+    m_out->Print( 0, "\n%*s", aLevel * 2, "" );
+}
+
+
+void NETLIST_XML_WRITER::closeStartTag()
+{
+    if( m_stack.back().m_childCount == 0 )
+        m_out->Print( 0, ">" );
+}
+
+
+wxString NETLIST_XML_WRITER::escape( const wxString& aText, bool aIsAttribute )
+{
+    // Same entities as the ones created by wxXmlDocument::Save()
+    wxString escaped;
+
+    escaped.reserve( aText.length() );
+
+    for( wxUniChar c : aText )
+    {
+        switch( c.GetValue() )
+        {
+        case '<':   escaped.append( "&lt;" );   break;
+        case '>':   escaped.append( "&gt;" );   break;
+        case '&':   escaped.append( "&amp;" );  break;
+        case '\r':  escaped.append( "&#xD;" );  break;
+
+        default:
+            if( aIsAttribute && c == '"' )
+                escaped.append( "&quot;" );
+            else if( aIsAttribute && c == '\t' )
+                escaped.append( "&#x9;" );
+            else if( aIsAttribute && c == '\n' )
+                escaped.append( "&#xA;" );
+            else
+                escaped += c;
+        }
+    }
+
+    return escaped;
+}
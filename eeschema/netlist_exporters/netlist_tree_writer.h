@@ -0,0 +1,135 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef NETLIST_TREE_WRITER_H
+#define NETLIST_TREE_WRITER_H
+
+#include <vector>
+#include <wx/string.h>
+
+class OUTPUTFORMATTER;
+
+
+/**
+ * Class NETLIST_TREE_WRITER
+ * writes the element tree of a generic netlist to an OUTPUTFORMATTER while it is
+ * walked, so the whole tree never has to be built in memory.
+ *
+ * Elements are opened with StartNode() and closed with EndNode().  The attributes of
+ * an element must be added before its text content and its child elements.
+ */
+class NETLIST_TREE_WRITER
+{
+public:
+    NETLIST_TREE_WRITER( OUTPUTFORMATTER* aOut ) :
+        m_out( aOut )
+    {}
+
+    virtual ~NETLIST_TREE_WRITER() {}
+
+    virtual void StartNode( const wxString& aName ) = 0;
+
+    virtual void AddAttribute( const wxString& aName, const wxString& aValue ) = 0;
+
+    virtual void AddText( const wxString& aContent ) = 0;
+
+    virtual void EndNode() = 0;
+
+    /**
+     * Function Node
+     * writes a complete element with an optional textual content.
+     */
+    void Node( const wxString& aName, const wxString& aTextualContent = wxEmptyString )
+    {
+        StartNode( aName );
+
+        if( aTextualContent.Len() > 0 )
+            AddText( aTextualContent );
+
+        EndNode();
+    }
+
+protected:
+    struct OPEN_NODE
+    {
+        wxString m_name;
+        int      m_childCount = 0;      ///< count of text and element children written
+        bool     m_lastIsText = false;  ///< the last child written is a text
+    };
+
+    OUTPUTFORMATTER*       m_out;
+    std::vector<OPEN_NODE> m_stack;     ///< the elements currently open, root first
+};
+
+
+/**
+ * Class NETLIST_SEXPR_WRITER
+ * writes the netlist tree as an S-expression, exactly as XNODE::Format() does.
+ */
+class NETLIST_SEXPR_WRITER : public NETLIST_TREE_WRITER
+{
+public:
+    NETLIST_SEXPR_WRITER( OUTPUTFORMATTER* aOut ) :
+        NETLIST_TREE_WRITER( aOut )
+    {}
+
+    void StartNode( const wxString& aName ) override;
+    void AddAttribute( const wxString& aName, const wxString& aValue ) override;
+    void AddText( const wxString& aContent ) override;
+    void EndNode() override;
+};
+
+
+/**
+ * Class NETLIST_XML_WRITER
+ * writes the netlist tree as an XML document, exactly as wxXmlDocument::Save() does
+ * with a 2 spaces indentation.
+ */
+class NETLIST_XML_WRITER : public NETLIST_TREE_WRITER
+{
+public:
+    NETLIST_XML_WRITER( OUTPUTFORMATTER* aOut ) :
+        NETLIST_TREE_WRITER( aOut )
+    {}
+
+    /// Write the XML declaration, must be called before writing the root element.
+    void StartDocument();
+
+    /// Terminate the document, must be called after the root element is closed.
+    void EndDocument();
+
+    void StartNode( const wxString& aName ) override;
+    void AddAttribute( const wxString& aName, const wxString& aValue ) override;
+    void AddText( const wxString& aContent ) override;
+    void EndNode() override;
+
+private:
+    void indent( int aLevel );
+
+    /// Close the start tag of the current element, before its first child is written.
+    void closeStartTag();
+
+    static wxString escape( const wxString& aText, bool aIsAttribute );
+};
+
+#endif  // NETLIST_TREE_WRITER_H
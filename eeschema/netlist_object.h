@@ -32,6 +32,10 @@
 #define NETLIST_OBJECT_H
 
 
+#include <limits>
+#include <map>
+#include <unordered_map>
+
 #include <sch_sheet_path.h>
 #include <lib_pin.h>
 #include <sch_item.h>
@@ -306,6 +310,23 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
 
+    // Lookup tables used only while BuildNetListInfo() runs, to avoid scanning the
+    // whole list for each connection test:
+    std::unordered_map<int, NETLIST_OBJECTS> m_itemsByNet;    // items of each net code
+    std::unordered_map<int, NETLIST_OBJECTS> m_itemsByBusNet; // items of each bus net code
+    std::unordered_map<wxPoint, NETLIST_OBJECTS> m_sheetItemsByPos; // items of the
+                                                    // current sheet, by end point
+    NETLIST_OBJECTS m_sheetWires;   // NET_SEGMENT items of the current sheet
+    NETLIST_OBJECTS m_sheetBuses;   // NET_BUS items of the current sheet
+    std::map<wxString, NETLIST_OBJECTS> m_labelsByName;     // label items, by label text
+
+    // Index of the NET_PIN items, by component reference and pin number.
+    // Built on demand by GetPinInstances() and dropped when the list is sorted or cleared
+    std::map<std::pair<wxString, wxString>, std::vector<unsigned>> m_pinInstances;
+    size_t m_pinInstancesCount;     // list size m_pinInstances was built for
+
+    static constexpr size_t INVALID_PIN_INSTANCES = std::numeric_limits<size_t>::max();
+
 public:
     /**
      * Constructor.
@@ -317,6 +338,7 @@ public:
         // Do not leave some members uninitialized:
         m_lastNetCode = 0;
         m_lastBusNetCode = 0;
+        m_pinInstancesCount = INVALID_PIN_INSTANCES;
     }
 
     ~NETLIST_OBJECT_LIST();
@@ -375,6 +397,17 @@ public:
     /** Delete all objects in list and clear list */
     void Clear();
 
+    /**
+     * Return the indexes in list of all the NET_PIN items having the pin number
+     * \a aPinNum in the component \a aReference (several instances of the same
+     * pin exist in multiple unit parts and for duplicated pins).
+     * The lookup table is built on the first call and rebuilt after the list is sorted,
+     * cleared or resized.  Items must not be reordered by other means while the returned
+     * indexes are in use.
+     */
+    const std::vector<unsigned>& GetPinInstances( const wxString& aReference,
+                                                  const wxString& aPinNum );
+
     /**
      * Reset the connection type of all items to UNCONNECTED type
      */
@@ -442,6 +475,24 @@ private:
      */
     void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
 
+    /**
+     * Set the net code (or the bus net code if \a aIsBus is true) of \a aItem
+     * and keep the net code lookup tables up to date.
+     */
+    void setNetCode( NETLIST_OBJECT* aItem, int aNetCode, bool aIsBus );
+
+    /**
+     * Fill the lookup tables of the sheet starting at index \a aIdxStart in list,
+     * used by pointToPointConnect() and segmentToPointConnect().
+     * The list is expected sorted by sheets.
+     */
+    void buildSheetIndex( unsigned aIdxStart );
+
+    /**
+     * Drop the pin instance index, after the order of the items has changed.
+     */
+    void invalidatePinInstances();
+
     /*
      * This function merges the net codes of groups of objects already connected
      * to labels (wires, bus, pins ... ) when 2 labels are equivalents
@@ -469,16 +520,20 @@ private:
      */
     void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    /**
+     * Search connections between the end points of aRef and the end points of
+     * the other items of the current sheet (see buildSheetIndex())
+     * Propagate the aRef net code to connected items.
+     */
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus );
 
     /**
      * Search connections between a junction and segments
      * Propagate the junction net code to objects connected by this junction.
      * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * Search is done in the segments of the current sheet (see buildSheetIndex())
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus );
 
 
     /**
@@ -54,18 +54,58 @@ void NETLIST_OBJECT_LIST::Clear()
     }
 
     clear();
+    invalidatePinInstances();
+}
+
+
+const std::vector<unsigned>& NETLIST_OBJECT_LIST::GetPinInstances( const wxString& aReference,
+                                                                   const wxString& aPinNum )
+{
+    static const std::vector<unsigned> empty;
+
+    // Items are appended to the list directly by SCH_ITEM::GetNetListItem(), so a change
+    // of size also means the index is stale.
+    if( m_pinInstancesCount != size() )
+    {
+        m_pinInstances.clear();
+        m_pinInstancesCount = size();
+
+        for( unsigned ii = 0; ii < size(); ii++ )
+        {
+            NETLIST_OBJECT* item = GetItem( ii );
+
+            if( item->m_Type != NET_PIN )
+                continue;
+
+            wxString ref = ( (SCH_COMPONENT*) item->m_Link )->GetRef( &item->m_SheetPath );
+            m_pinInstances[ std::make_pair( ref, item->m_PinNum ) ].push_back( ii );
+        }
+    }
+
+    auto it = m_pinInstances.find( std::make_pair( aReference, aPinNum ) );
+
+    return it != m_pinInstances.end() ? it->second : empty;
 }
 
 
 void NETLIST_OBJECT_LIST::SortListbyNetcode()
 {
     sort( this->begin(), this->end(), NETLIST_OBJECT_LIST::sortItemsbyNetcode );
+    invalidatePinInstances();
 }
 
 
 void NETLIST_OBJECT_LIST::SortListbySheet()
 {
     sort( this->begin(), this->end(), NETLIST_OBJECT_LIST::sortItemsBySheet );
+    invalidatePinInstances();
+}
+
+
+void NETLIST_OBJECT_LIST::invalidatePinInstances()
+{
+    m_pinInstances.clear();
+    m_pinInstancesCount = INVALID_PIN_INSTANCES;
 }
 
 
@@ -90,17 +130,30 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     // Sort objects by Sheet
     SortListbySheet();
 
+    m_itemsByNet.clear();
+    m_itemsByBusNet.clear();
+
+    for( NETLIST_OBJECT* item : *this )
+    {
+        if( item->GetNet() )
+            m_itemsByNet[ item->GetNet() ].push_back( item );
+
+        if( item->m_BusNetCode )
+            m_itemsByBusNet[ item->m_BusNetCode ].push_back( item );
+    }
+
     sheet = &(GetItem( 0 )->m_SheetPath);
     m_lastNetCode = m_lastBusNetCode = 1;
+    buildSheetIndex( 0 );
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* net_item = GetItem( ii );
 
         if( net_item->m_SheetPath != *sheet )   // Sheet change
         {
             sheet  = &(net_item->m_SheetPath);
-            istart = ii;
+            buildSheetIndex( ii );
         }
 
         switch( net_item->m_Type )
@@ -120,31 +173,31 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             // Test connections point to point type without bus.
             if( net_item->GetNet() == 0 )
             {
-                net_item->SetNet( m_lastNetCode );
+                setNetCode( net_item, m_lastNetCode, IS_WIRE );
                 m_lastNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
+            pointToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_JUNCTION:
             // Control of the junction outside BUS.
             if( net_item->GetNet() == 0 )
             {
-                net_item->SetNet( m_lastNetCode );
+                setNetCode( net_item, m_lastNetCode, IS_WIRE );
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
 
             // Control of the junction, on BUS.
             if( net_item->m_BusNetCode == 0 )
             {
-                net_item->m_BusNetCode = m_lastBusNetCode;
+                setNetCode( net_item, m_lastBusNetCode, IS_BUS );
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_LABEL:
@@ -153,11 +206,11 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             // Test connections type junction without bus.
             if( net_item->GetNet() == 0 )
             {
-                net_item->SetNet( m_lastNetCode );
+                setNetCode( net_item, m_lastNetCode, IS_WIRE );
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
@@ -168,11 +221,11 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             // Control type connections point to point mode bus
             if( net_item->m_BusNetCode == 0 )
             {
-                net_item->m_BusNetCode = m_lastBusNetCode;
+                setNetCode( net_item, m_lastBusNetCode, IS_BUS );
                 m_lastBusNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_BUS, istart );
+            pointToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_BUSLABELMEMBER:
@@ -181,15 +234,19 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             // Control connections similar has on BUS
             if( net_item->GetNet() == 0 )
             {
-                net_item->m_BusNetCode = m_lastBusNetCode;
+                setNetCode( net_item, m_lastBusNetCode, IS_BUS );
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
         }
     }
 
+    m_sheetItemsByPos.clear();
+    m_sheetWires.clear();
+    m_sheetBuses.clear();
+
 #if defined(NETLIST_DEBUG) && defined(DEBUG)
     std::cout << "\n\nafter sheet local\n\n";
     DumpNetTable();
@@ -198,6 +255,12 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     // Updating the Bus Labels Netcode connected by Bus
     connectBusLabels();
 
+    for( NETLIST_OBJECT* item : *this )
+    {
+        if( item->IsLabelType() )
+            m_labelsByName[ item->m_Label ].push_back( item );
+    }
+
     // Group objects by label.
     for( unsigned ii = 0; ii < size(); ii++ )
     {
@@ -242,6 +305,10 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             sheetLabelConnect( GetItem( ii ) );
     }
 
+    m_labelsByName.clear();
+    m_itemsByNet.clear();
+    m_itemsByBusNet.clear();
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -492,10 +559,13 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
     if( SheetLabel->GetNet() == 0 )
         return;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
-    {
-        NETLIST_OBJECT* ObjetNet = GetItem( ii );
+    auto candidates = m_labelsByName.find( SheetLabel->m_Label );
 
+    if( candidates == m_labelsByName.end() )
+        return;
+
+    for( NETLIST_OBJECT* ObjetNet : candidates->second )
+    {
         if( ObjetNet->m_SheetPath != SheetLabel->m_SheetPathInclude )
             continue;  //use SheetInclude, not the sheet!!
 
@@ -512,7 +582,7 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
         if( ObjetNet->GetNet() )
             propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
         else
-            ObjetNet->SetNet( SheetLabel->GetNet() );
+            setNetCode( ObjetNet, SheetLabel->GetNet(), IS_WIRE );
     }
 }
 
@@ -522,40 +592,52 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
     // Propagate the net code between all bus label member objects connected by they name.
     // If the net code is not yet existing, a new one is created
     // Search is done in the entire list
+
+    // Bus label members are connected when they have the same bus net code and
+    // the same member number, so group them once by this key.
+    // Once the first member of a group is handled, all the group shares its net code,
+    // therefore only the first member (in list order) of each group needs to be handled.
+    std::map<std::pair<int, int>, NETLIST_OBJECTS> groups;
+
+    for( NETLIST_OBJECT* label : *this )
+    {
+        if( label->IsLabelBusMemberType() )
+            groups[ std::make_pair( label->m_BusNetCode, label->m_Member ) ].push_back( label );
+    }
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* Label = GetItem( ii );
 
-        if( Label->IsLabelBusMemberType() )
+        if( !Label->IsLabelBusMemberType() )
+            continue;
+
+        auto group = groups.find( std::make_pair( Label->m_BusNetCode, Label->m_Member ) );
+
+        if( group == groups.end() )     // group already handled
+            continue;
+
+        if( Label->GetNet() == 0 )
         {
-            if( Label->GetNet() == 0 )
-            {
-                // Not yet existiing net code: create a new one.
-                Label->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+            // Not yet existiing net code: create a new one.
+            setNetCode( Label, m_lastNetCode, IS_WIRE );
+            m_lastNetCode++;
+        }
 
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
-            {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+        for( NETLIST_OBJECT* LabelInTst : group->second )
+        {
+            if( LabelInTst == Label )
+                continue;
 
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
-
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
-
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
-            }
+            if( LabelInTst->GetNet() == 0 )
+                // Append this object to the current net
+                setNetCode( LabelInTst, Label->GetNet(), IS_WIRE );
+            else
+                // Merge the 2 net codes, they are connected.
+                propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
         }
+
+        groups.erase( group );
     }
 }
 
@@ -565,91 +647,108 @@ void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bo
     if( aOldNetCode == aNewNetCode )
         return;
 
-    if( aIsBus == false )    // Propagate NetCode
+    auto& index = aIsBus ? m_itemsByBusNet : m_itemsByNet;
+    auto oldItems = index.find( aOldNetCode );
+
+    if( oldItems == index.end() )
+        return;
+
+    NETLIST_OBJECTS items;
+    items.swap( oldItems->second );
+    index.erase( oldItems );
+
+    for( NETLIST_OBJECT* object : items )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        if( aIsBus )
+            object->m_BusNetCode = aNewNetCode;
+        else
+            object->SetNet( aNewNetCode );
+    }
 
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
+    if( aNewNetCode )
+    {
+        NETLIST_OBJECTS& newItems = index[ aNewNetCode ];
+        newItems.insert( newItems.end(), items.begin(), items.end() );
     }
-    else               // Propagate BusNetCode
+}
+
+
+void NETLIST_OBJECT_LIST::setNetCode( NETLIST_OBJECT* aItem, int aNetCode, bool aIsBus )
+{
+    int oldNetCode = aIsBus ? aItem->m_BusNetCode : aItem->GetNet();
+
+    if( oldNetCode == aNetCode )
+        return;
+
+    auto& index = aIsBus ? m_itemsByBusNet : m_itemsByNet;
+
+    if( oldNetCode )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        NETLIST_OBJECTS& oldItems = index[ oldNetCode ];
+        auto it = std::find( oldItems.begin(), oldItems.end(), aItem );
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
+        if( it != oldItems.end() )
+        {
+            *it = oldItems.back();
+            oldItems.pop_back();
         }
     }
+
+    if( aIsBus )
+        aItem->m_BusNetCode = aNetCode;
+    else
+        aItem->SetNet( aNetCode );
+
+    if( aNetCode )
+        index[ aNetCode ].push_back( aItem );
 }
 
 
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
+void NETLIST_OBJECT_LIST::buildSheetIndex( unsigned aIdxStart )
 {
-    int netCode;
+    m_sheetItemsByPos.clear();
+    m_sheetWires.clear();
+    m_sheetBuses.clear();
+
+    const SCH_SHEET_PATH& sheet = GetItem( aIdxStart )->m_SheetPath;
 
-    if( aIsBus == false )    // Objects other than BUS and BUSLABELS
+    for( unsigned i = aIdxStart; i < size(); i++ )
     {
-        netCode = aRef->GetNet();
+        NETLIST_OBJECT* item = GetItem( i );
 
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
+        if( item->m_SheetPath != sheet )
+            break;
 
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
+        m_sheetItemsByPos[ item->m_Start ].push_back( item );
 
-            switch( item->m_Type )
-            {
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_JUNCTION:
-            case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
-                }
-                break;
+        if( item->m_End != item->m_Start )
+            m_sheetItemsByPos[ item->m_End ].push_back( item );
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_ITEM_UNSPECIFIED:
-                break;
-            }
-        }
+        if( item->m_Type == NET_SEGMENT )
+            m_sheetWires.push_back( item );
+        else if( item->m_Type == NET_BUS )
+            m_sheetBuses.push_back( item );
     }
-    else    // Object type BUS, BUSLABELS, and junctions.
+}
+
+
+void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus )
+{
+    int netCode = aIsBus ? aRef->m_BusNetCode : aRef->GetNet();
+
+    for( const wxPoint& pos : { aRef->m_Start, aRef->m_End } )
     {
-        netCode = aRef->m_BusNetCode;
+        auto candidates = m_sheetItemsByPos.find( pos );
 
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
+        if( candidates == m_sheetItemsByPos.end() )
+            continue;
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
-                continue;
+        for( NETLIST_OBJECT* item : candidates->second )
+        {
+            bool canConnect = false;
 
             switch( item->m_Type )
             {
-            case NET_ITEM_UNSPECIFIED:
             case NET_SEGMENT:
             case NET_PIN:
             case NET_LABEL:
@@ -658,6 +757,11 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
             case NET_SHEETLABEL:
             case NET_PINLABEL:
             case NET_NOCONNECT:
+                canConnect = !aIsBus;
+                break;
+
+            case NET_JUNCTION:
+                canConnect = true;
                 break;
 
             case NET_BUS:
@@ -665,46 +769,32 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
             case NET_SHEETBUSLABELMEMBER:
             case NET_HIERBUSLABELMEMBER:
             case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
-                {
-                    if( item->m_BusNetCode == 0 )
-                        item->m_BusNetCode = netCode;
-                    else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
-                }
+                canConnect = aIsBus;
+                break;
+
+            case NET_ITEM_UNSPECIFIED:
                 break;
             }
+
+            if( !canConnect )
+                continue;
+
+            int itemNetCode = aIsBus ? item->m_BusNetCode : item->GetNet();
+
+            if( itemNetCode == 0 )
+                setNetCode( item, netCode, aIsBus );
+            else
+                propagateNetCode( itemNetCode, netCode, aIsBus );
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
+    // Only segments of the same sheet can be physically connected to aJonction
+    for( NETLIST_OBJECT* segment : aIsBus == IS_WIRE ? m_sheetWires : m_sheetBuses )
     {
-        NETLIST_OBJECT* segment = GetItem( i );
-
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
-            continue;
-
-        if( aIsBus == IS_WIRE )
-        {
-            if( segment->m_Type != NET_SEGMENT )
-                continue;
-        }
-        else
-        {
-            if( segment->m_Type != NET_BUS )
-                continue;
-        }
-
         if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
         {
             // Propagation Netcode has all the objects of the same Netcode.
@@ -713,14 +803,14 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
                 if( segment->GetNet() )
                     propagateNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
                 else
-                    segment->SetNet( aJonction->GetNet() );
+                    setNetCode( segment, aJonction->GetNet(), aIsBus );
             }
             else
             {
                 if( segment->m_BusNetCode )
                     propagateNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
                 else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
+                    setNetCode( segment, aJonction->m_BusNetCode, aIsBus );
             }
         }
     }
@@ -732,10 +822,14 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
     if( aLabelRef->GetNet() == 0 )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
-    {
-        NETLIST_OBJECT* item = GetItem( i );
+    // Only labels having the same text can be connected
+    auto candidates = m_labelsByName.find( aLabelRef->m_Label );
 
+    if( candidates == m_labelsByName.end() )
+        return;
+
+    for( NETLIST_OBJECT* item : candidates->second )
+    {
         if( item->GetNet() == aLabelRef->GetNet() )
             continue;
 
@@ -764,7 +858,7 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
             if( item->GetNet() )
                 propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
             else
-                item->SetNet( aLabelRef->GetNet() );
+                setNetCode( item, aLabelRef->GetNet(), IS_WIRE );
         }
     }
 }
@@ -772,87 +866,55 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
 
 void NETLIST_OBJECT_LIST::setUnconnectedFlag()
 {
-    NETLIST_OBJECT* NetItemRef;
-    unsigned NetStart, NetEnd;
-    NET_CONNECTION_T StateFlag;
+    unsigned NetStart = 0;
+    int pinCount = 0;
+    bool hasNoConnect = false;
 
-    NetStart  = NetEnd = 0;
-    StateFlag = UNCONNECTED;
     for( unsigned ii = 0; ii < size(); ii++ )
     {
-        NetItemRef = GetItem( ii );
-        if( NetItemRef->m_Type == NET_NOCONNECT && StateFlag != PAD_CONNECT )
-            StateFlag = NOCONNECT_SYMBOL_PRESENT;
-
-        // Analysis of current net.
-        unsigned idxtoTest = ii + 1;
+        NETLIST_OBJECT* item = GetItem( ii );
 
-        if( ( idxtoTest >= size() )
-           || ( NetItemRef->GetNet() != GetItem( idxtoTest )->GetNet() ) )
+        switch( item->m_Type )
         {
-            // Net analysis to update m_ConnectionType
-            NetEnd = idxtoTest;
+        case NET_ITEM_UNSPECIFIED:
+            wxMessageBox( wxT( "BuildNetListBase() error" ) );
+            break;
 
-            /* set m_ConnectionType member to StateFlag for all items of
-             * this net: */
-            for( unsigned kk = NetStart; kk < NetEnd; kk++ )
-                GetItem( kk )->m_ConnectionType = StateFlag;
+        case NET_PIN:
+            pinCount++;
+            break;
 
-            if( idxtoTest >= size() )
-                return;
+        case NET_NOCONNECT:
+            hasNoConnect = true;
+            break;
 
-            // Start Analysis next Net
-            StateFlag = UNCONNECTED;
-            NetStart  = idxtoTest;
-            continue;
+        default:
+            break;
         }
 
-        /* test the current item: if this is a pin and if the reference item
-         * is also a pin, then 2 pins are connected, so set StateFlag to
-         * PAD_CONNECT (can be already done)  Of course, if the current
-         * item is a no connect symbol, set StateFlag to
-         * NOCONNECT_SYMBOL_PRESENT to inhibit error diags. However if
-         * StateFlag is already set to PAD_CONNECT this state is kept (the
-         * no connect symbol was surely an error and an ERC will report this)
-         */
-       for( ; ; idxtoTest++ )
-        {
-            if( ( idxtoTest >= size() )
-               || ( NetItemRef->GetNet() != GetItem( idxtoTest )->GetNet() ) )
-                break;
+        unsigned NetEnd = ii + 1;
 
-            switch( GetItem( idxtoTest )->m_Type )
-            {
-            case NET_ITEM_UNSPECIFIED:
-                wxMessageBox( wxT( "BuildNetListBase() error" ) );
-                break;
-
-            case NET_SEGMENT:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                break;
+        if( NetEnd < size() && item->GetNet() == GetItem( NetEnd )->GetNet() )
+            continue;
 
-            case NET_PIN:
-                if( NetItemRef->m_Type == NET_PIN )
-                    StateFlag = PAD_CONNECT;
+        /* End of net: if at least 2 pins are connected, the state is PAD_CONNECT.
+         * Otherwise if a no connect symbol is in net, set NOCONNECT_SYMBOL_PRESENT
+         * to inhibit error diags.  However if there are connected pins, PAD_CONNECT is
+         * kept (the no connect symbol was surely an error and an ERC will report this)
+         */
+        NET_CONNECTION_T StateFlag = UNCONNECTED;
 
-                break;
+        if( pinCount >= 2 )
+            StateFlag = PAD_CONNECT;
+        else if( hasNoConnect )
+            StateFlag = NOCONNECT_SYMBOL_PRESENT;
 
-            case NET_NOCONNECT:
-                if( StateFlag != PAD_CONNECT )
-                    StateFlag = NOCONNECT_SYMBOL_PRESENT;
+        for( unsigned kk = NetStart; kk < NetEnd; kk++ )
+            GetItem( kk )->m_ConnectionType = StateFlag;
 
-                break;
-            }
-        }
+        // Start Analysis next Net
+        NetStart = NetEnd;
+        pinCount = 0;
+        hasNoConnect = false;
     }
 }
@@ -21,6 +21,11 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <boost/algorithm/string/join.hpp>
 #include <cctype>
 
@@ -461,19 +466,43 @@ static void parseQuotedString( wxString& aString, LINE_READER& aReader,
 }
 
 
+/**
+ * The location in the library file of a symbol definition which has not been parsed yet.
+ *
+ * Root symbols and their aliases share the same DEF line offset.  The document file
+ * information is kept here until the symbol is parsed.
+ */
+struct LEGACY_SYMBOL_ENTRY
+{
+    long        m_offset;       // File offset of the DEF line.
+    unsigned    m_lineNumber;   // Line number before the DEF line for error reporting.
+    bool        m_isPower;      // Only set for root symbols, aliases are never power symbols.
+    wxString    m_description;
+    wxString    m_keyWords;
+    wxString    m_docFileName;
+};
+
+
+typedef std::map< wxString, LEGACY_SYMBOL_ENTRY, LibPartMapSort > LEGACY_SYMBOL_INDEX;
+
+
 /**
  * A cache assistant for the part library portion of the #SCH_PLUGIN API, and only for the
  * #SCH_LEGACY_PLUGIN, so therefore is private to this implementation file, i.e. not placed
  * into a header.
+ *
+ * Loading a library only indexes the symbol names, aliases and DEF line file offsets.  The
+ * graphics, pins and fields of a symbol are parsed the first time the symbol is requested.
  */
 class SCH_LEGACY_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash;  // Keep track of the modification status of the library.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
     wxDateTime      m_fileModTime;
-    LIB_PART_MAP    m_symbols;      // Map of names of #LIB_PART pointers.
+    LIB_PART_MAP    m_symbols;      // Map of names of parsed #LIB_PART pointers.
+    LEGACY_SYMBOL_INDEX m_unloadedSymbols;  // Symbols in m_fileName not parsed yet.
     bool            m_isWritable;
     bool            m_isModified;
     int             m_versionMajor;
@@ -481,6 +510,10 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_libType;      // Is this cache a component or symbol library.
 
     void                  loadHeader( FILE_LINE_READER& aReader );
+    void                  indexSymbol( FILE_LINE_READER& aReader, long aOffset,
+                                       unsigned aLineNumber );
+    LIB_PART*             loadSymbol( const wxString& aName );
+    void                  loadAllSymbols();
     static void           loadAliases( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
                                        LIB_PART_MAP* aMap = nullptr );
     static void           loadField( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
@@ -534,6 +567,28 @@ public:
 
     void DeleteSymbol( const wxString& aName );
 
+    /**
+     * Return the symbol \a aName, parsing it from the library file if required.
+     *
+     * @return the symbol or NULL if the library does not contain \a aName.
+     */
+    LIB_PART* GetSymbol( const wxString& aName ) { return loadSymbol( aName ); }
+
+    /**
+     * Add the names of all of the symbols in the library to \a aNames in name order without
+     * parsing the symbols.
+     */
+    void GetSymbolNames( wxArrayString& aNames, bool aPowerSymbolsOnly );
+
+    /**
+     * Return all of the symbols in the library, parsing any symbol not loaded yet.
+     */
+    const LIB_PART_MAP& GetSymbols()
+    {
+        loadAllSymbols();
+        return m_symbols;
+    }
+
     // If m_libFileName is a symlink follow it to the real source file
     wxFileName GetRealFile() const;
 
@@ -566,6 +621,7 @@ SCH_LEGACY_PLUGIN::SCH_LEGACY_PLUGIN()
 
 SCH_LEGACY_PLUGIN::~SCH_LEGACY_PLUGIN()
 {
+    releaseParsedScreens();
     delete m_cache;
 }
 
@@ -578,6 +634,7 @@ void SCH_LEGACY_PLUGIN::init( KIWAY* aKiway, const PROPERTIES* aProperties )
     m_kiway = aKiway;
     m_cache = NULL;
     m_out = NULL;
+    m_repaired = false;
 }
 
 
@@ -628,6 +685,7 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
         std::unique_ptr< SCH_SHEET > newSheet( new SCH_SHEET );
         newSheet->SetFileName( aFileName );
         m_rootSheet = newSheet.get();
+        prefetchHierarchy( newSheet.get() );
         loadHierarchy( newSheet.get() );
 
         // If we got here, the schematic loaded successfully.
@@ -638,15 +696,216 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
         m_rootSheet = aAppendToMe->GetRootSheet();
         wxASSERT( m_rootSheet != NULL );
         sheet = aAppendToMe;
+        prefetchHierarchy( sheet );
         loadHierarchy( sheet );
     }
 
+    releaseParsedScreens();
+
     wxASSERT( m_currentPath.size() == 1 );  // only the project path should remain
 
     return sheet;
 }
 
 
+void SCH_LEGACY_PLUGIN::prefetchHierarchy( SCH_SHEET* aSheet )
+{
+    releaseParsedScreens();
+
+    size_t threadCount = std::max( 1U, std::thread::hardware_concurrency() );
+    UTF8   threadCountProp;
+
+    if( m_props && m_props->Value( PropPrefetchThreads, &threadCountProp ) )
+        threadCount = strtoul( threadCountProp.c_str(), NULL, 10 );
+
+    if( threadCount == 0 || aSheet->GetScreen() )
+        return;
+
+    wxFileName fileName = aSheet->GetFileName();
+
+    if( !fileName.IsAbsolute() )
+        fileName.MakeAbsolute( m_currentPath.top() );
+
+    SCH_SCREEN* screen = NULL;
+
+    m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+
+    if( screen )
+        return;
+
+    // Parse the top level file on this thread.  If it cannot be parsed, leave it to
+    // loadHierarchy() to load it again and report the error the usual way.
+    PARSED_SCREEN top = parseScreen( fileName.GetFullPath() );
+
+    if( !top.m_error.IsEmpty() )
+    {
+        delete top.m_screen;
+        return;
+    }
+
+    m_parsedScreens[ fileName.GetFullPath() ] = top;
+
+    // The sub-sheet files are independent of each other so they are parsed by worker
+    // threads as they get discovered.  Attaching the screens to the hierarchy is left to
+    // loadHierarchy() which walks the sheets in file order on this thread, so the result
+    // is the same as loading every file one after the other.
+    std::deque<wxString>    queue;
+    size_t                  pending = 0;    // files queued or being parsed
+    std::mutex              lock;           // guards the queue, the count and the screens
+    std::condition_variable changed;
+
+    auto queueSubSheets = [&]( SCH_SCREEN* aScreen )
+    {
+        wxString path = wxFileName( aScreen->GetFileName() ).GetPath();
+
+        for( EDA_ITEM* item = aScreen->GetDrawItems(); item; item = item->Next() )
+        {
+            if( item->Type() != SCH_SHEET_T )
+                continue;
+
+            wxFileName subSheetFileName = static_cast<SCH_SHEET*>( item )->GetFileName();
+
+            if( !subSheetFileName.IsAbsolute() )
+                subSheetFileName.MakeAbsolute( path );
+
+            wxString fullPath = subSheetFileName.GetFullPath();
+
+            {
+                std::lock_guard<std::mutex> guard( lock );
+
+                // Empty entries mark the files already queued.
+                if( !m_parsedScreens.emplace( fullPath, PARSED_SCREEN() ).second )
+                    continue;
+
+                pending++;
+                queue.push_back( fullPath );
+            }
+
+            changed.notify_one();
+        }
+    };
+
+    auto worker = [&]()
+    {
+        std::unique_lock<std::mutex> guard( lock );
+
+        while( true )
+        {
+            // Wait for a file to parse, or for the last one to be parsed without queuing
+            // any other.
+            changed.wait( guard, [&]() { return !queue.empty() || pending == 0; } );
+
+            if( queue.empty() )
+                return;
+
+            wxString subSheetFileName = queue.front();
+            queue.pop_front();
+
+            guard.unlock();
+
+            PARSED_SCREEN parsed = parseScreen( subSheetFileName );
+
+            if( parsed.m_error.IsEmpty() )
+                queueSubSheets( parsed.m_screen );
+
+            guard.lock();
+
+            m_parsedScreens[ subSheetFileName ] = parsed;
+
+            // Only after queuing the sub-sheets so the count cannot drop to zero early.
+            if( --pending == 0 )
+                changed.notify_all();
+        }
+    };
+
+    queueSubSheets( top.m_screen );
+
+    if( pending == 0 )
+        return;
+
+    threadCount = std::min<size_t>( threadCount, pending );
+
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 0; ii < threadCount; ++ii )
+        threads.emplace_back( worker );
+
+    for( std::thread& thread : threads )
+        thread.join();
+}
+
+
+SCH_LEGACY_PLUGIN::PARSED_SCREEN SCH_LEGACY_PLUGIN::parseScreen( const wxString& aFileName )
+{
+    // Every file gets its own parser, the parser state is per file.  This may run on a
+    // worker thread: the caller holds the LOCALE_IO toggle.
+    SCH_LEGACY_PLUGIN parser;
+    PARSED_SCREEN     parsed;
+
+    parser.init( m_kiway, m_props );
+
+    parsed.m_screen = new SCH_SCREEN( m_kiway );
+    parsed.m_screen->SetFileName( aFileName );
+
+    try
+    {
+        parser.loadFile( aFileName, parsed.m_screen );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        parsed.m_error = ioe.What();
+    }
+    catch( const std::exception& e )
+    {
+        parsed.m_error = e.what();
+    }
+
+    parsed.m_repaired = parser.m_repaired;
+
+    return parsed;
+}
+
+
+void SCH_LEGACY_PLUGIN::attachScreen( SCH_SHEET* aSheet, const wxString& aFileName )
+{
+    auto it = m_parsedScreens.find( aFileName );
+
+    if( it == m_parsedScreens.end() || !it->second.m_screen )
+    {
+        // Not prefetched, load it now.
+        aSheet->SetScreen( new SCH_SCREEN( m_kiway ) );
+        aSheet->GetScreen()->SetFileName( aFileName );
+        loadFile( aFileName, aSheet->GetScreen() );
+    }
+    else
+    {
+        PARSED_SCREEN& parsed = it->second;
+
+        aSheet->SetScreen( parsed.m_screen );
+        parsed.m_screen = NULL;
+        m_repaired |= parsed.m_repaired;
+
+        if( !parsed.m_error.IsEmpty() )
+            THROW_IO_ERROR( parsed.m_error );
+    }
+
+    // Set the file as modified so the user can be warned.
+    if( m_repaired && m_rootSheet->GetScreen() )
+        m_rootSheet->GetScreen()->SetModify();
+}
+
+
+void SCH_LEGACY_PLUGIN::releaseParsedScreens()
+{
+    // Screens not claimed by loadHierarchy() are only left over when a file was already
+    // part of the hierarchy being appended to.
+    for( auto& entry : m_parsedScreens )
+        delete entry.second.m_screen;
+
+    m_parsedScreens.clear();
+}
+
+
 // Everything below this comment is recursive.  Modify with care.
 
 void SCH_LEGACY_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
@@ -681,12 +940,9 @@ void SCH_LEGACY_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
         }
         else
         {
-            aSheet->SetScreen( new SCH_SCREEN( m_kiway ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
-
             try
             {
-                loadFile( fileName.GetFullPath(), aSheet->GetScreen() );
+                attachScreen( aSheet, fileName.GetFullPath() );
 
                 EDA_ITEM* item = aSheet->GetScreen()->GetDrawItems();
 
@@ -1531,8 +1787,7 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( LINE_READER& aReader )
                 unit = 1;
 
                 // Set the file as modified so the user can be warned.
-                if( m_rootSheet && m_rootSheet->GetScreen() )
-                    m_rootSheet->GetScreen()->SetModify();
+                m_repaired = true;
             }
 
             component->SetUnit( unit );
@@ -1545,8 +1800,7 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( LINE_READER& aReader )
                 convert = 1;
 
                 // Set the file as modified so the user can be warned.
-                if( m_rootSheet && m_rootSheet->GetScreen() )
-                    m_rootSheet->GetScreen()->SetModify();
+                m_repaired = true;
             }
 
             component->SetConvert( convert );
@@ -2312,7 +2566,7 @@ void SCH_LEGACY_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias )
 }
 
 
-int SCH_LEGACY_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_LEGACY_PLUGIN_CACHE::m_modHash( 1 );    // starts at 1 and goes up
 
 
 SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -2460,6 +2714,8 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::removeSymbol( LIB_PART* aPart )
 void SCH_LEGACY_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 {
     // aPart is cloned in PART_LIB::AddPart().  The cache takes ownership of aPart.
+    loadAllSymbols();
+
     wxString name = aPart->GetName();
     LIB_PART_MAP::iterator it = m_symbols.find( name );
 
@@ -2530,8 +2786,15 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         m_libType = LIBRARY_TYPE_EESCHEMA;
     }
 
-    while( reader.ReadLine() )
+    while( true )
     {
+        // Remember where the line starts so the symbol can be parsed later.
+        long     offset = reader.Tell();
+        unsigned lineNumber = reader.LineNumber();
+
+        if( !reader.ReadLine() )
+            break;
+
         line = reader.Line();
 
         if( *line == '#' || isspace( *line ) )  // Skip comments and blank lines.
@@ -2543,10 +2806,8 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
 
         if( strCompare( "DEF", line ) )
         {
-            // Read one DEF/ENDDEF part entry from library:
-            LIB_PART* part = LoadPart( reader, m_versionMajor, m_versionMinor, &m_symbols );
-
-            m_symbols[ part->GetName() ] = part;
+            // Index one DEF/ENDDEF part entry from library.  It gets parsed on demand.
+            indexSymbol( reader, offset, lineNumber );
         }
     }
 
@@ -2568,7 +2829,8 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
     wxString    text;
     wxString    aliasName;
     wxFileName  fn = m_libFileName;
-    LIB_PART*   symbol = NULL;;
+    LIB_PART*   symbol = NULL;
+    LEGACY_SYMBOL_ENTRY* entry = NULL;
 
     fn.SetExt( DOC_EXT );
 
@@ -2606,13 +2868,19 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
         aliasName = LIB_ID::FixIllegalChars( aliasName, LIB_ID::ID_SCH );
 
         LIB_PART_MAP::iterator it = m_symbols.find( aliasName );
+        LEGACY_SYMBOL_INDEX::iterator entryIt = m_unloadedSymbols.find( aliasName );
+
+        symbol = NULL;
+        entry = NULL;
 
-        if( it == m_symbols.end() )
+        if( it != m_symbols.end() )
+            symbol = it->second;
+        else if( entryIt != m_unloadedSymbols.end() )
+            entry = &entryIt->second;
+        else
             wxLogWarning( "Symbol '%s' not found in library:\n\n"
                           "'%s'\n\nat line %d offset %d", aliasName, fn.GetFullPath(),
                           reader.LineNumber(), (int) (line - reader.Line() ) );
-        else
-            symbol = it->second;
 
         // Read the curent alias associated doc.
         // if the alias does not exist, just skip the description
@@ -2636,11 +2904,15 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
             case 'D':
                 if( symbol )
                     symbol->SetDescription( text );
+                else if( entry )
+                    entry->m_description = text;
                 break;
 
             case 'K':
                 if( symbol )
                     symbol->SetKeyWords( text );
+                else if( entry )
+                    entry->m_keyWords = text;
                 break;
 
             case 'F':
@@ -2649,6 +2921,10 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
                     symbol->SetDocFileName( text );
                     symbol->GetField( DATASHEET )->SetText( text );
                 }
+                else if( entry )
+                {
+                    entry->m_docFileName = text;
+                }
                 break;
 
             case 0:
@@ -2688,6 +2964,195 @@ void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
 }
 
 
+void SCH_LEGACY_PLUGIN_CACHE::indexSymbol( FILE_LINE_READER& aReader, long aOffset,
+                                           unsigned aLineNumber )
+{
+    const char* line = aReader.Line();
+
+    wxCHECK_RET( strCompare( "DEF", line, &line ), "Invalid DEF section" );
+
+    wxString utf8Line = wxString::FromUTF8( line );
+    wxStringTokenizer tokens( utf8Line, " \r\n\t" );
+
+    if( tokens.CountTokens() < 8 )
+        SCH_PARSE_ERROR( "invalid symbol definition", aReader, line );
+
+    LEGACY_SYMBOL_ENTRY entry;
+
+    entry.m_offset = aOffset;
+    entry.m_lineNumber = aLineNumber;
+    entry.m_isPower = false;
+
+    // Mangle the name the same way LoadPart() does so the index keys match the parsed names.
+    wxString name = tokens.GetNextToken();
+
+    if( name.IsEmpty() )
+        name = "~";
+    else if( name[0] == '~' )
+        name = name.Right( name.Length() - 1 );
+
+    name = LIB_ID::FixIllegalChars( name, LIB_ID::ID_SCH );
+
+    // Skip the prefix, unused pin count, pin name offset, show pin number and name flags,
+    // unit count and unit lock flag to get to the optional power symbol flag.
+    for( int i = 0; i < 7; i++ )
+        tokens.GetNextToken();
+
+    if( tokens.HasMoreTokens() && tokens.GetNextToken() == "P" )
+        entry.m_isPower = true;
+
+    m_unloadedSymbols[ name ] = entry;
+
+    // Aliases are never power symbols, they only share the root symbol definition.
+    entry.m_isPower = false;
+
+    while( ( line = aReader.ReadLine() ) != NULL )
+    {
+        if( strCompare( "ENDDEF", line, &line ) )
+            return;
+
+        if( strCompare( "ALIAS", line, &line ) )
+        {
+            wxStringTokenizer aliasTokens( wxString::FromUTF8( line ), " \r\n\t" );
+
+            while( aliasTokens.HasMoreTokens() )
+            {
+                wxString aliasName = LIB_ID::FixIllegalChars( aliasTokens.GetNextToken(),
+                                                              LIB_ID::ID_SCH );
+                m_unloadedSymbols[ aliasName ] = entry;
+            }
+        }
+    }
+
+    SCH_PARSE_ERROR( "missing ENDDEF", aReader, line );
+}
+
+
+LIB_PART* SCH_LEGACY_PLUGIN_CACHE::loadSymbol( const wxString& aName )
+{
+    LIB_PART_MAP::iterator it = m_symbols.find( aName );
+
+    if( it != m_symbols.end() )
+        return it->second;
+
+    LEGACY_SYMBOL_INDEX::iterator entryIt = m_unloadedSymbols.find( aName );
+
+    if( entryIt == m_unloadedSymbols.end() )
+        return NULL;
+
+    long offset = entryIt->second.m_offset;
+
+    wxLogTrace( traceSchLegacyPlugin, "Parsing symbol \"%s\" from library \"%s\"",
+                aName, m_fileName );
+
+    FILE_LINE_READER reader( m_fileName );
+    reader.Seek( offset, entryIt->second.m_lineNumber );
+
+    if( !reader.ReadLine() )
+        THROW_IO_ERROR( _( "unexpected end of file" ) );
+
+    LIB_PART_MAP aliases;
+    std::unique_ptr< LIB_PART > part( LoadPart( reader, m_versionMajor, m_versionMinor,
+                                                &aliases ) );
+
+    // Move the root symbol and its aliases into the cache.  Names redefined later in the
+    // library file belong to the later definition, the same as when the library was
+    // loaded in a single pass.
+    auto claim = [&]( LIB_PART* aSymbol ) -> bool
+    {
+        LEGACY_SYMBOL_INDEX::iterator claimIt = m_unloadedSymbols.find( aSymbol->GetName() );
+
+        if( claimIt == m_unloadedSymbols.end() || claimIt->second.m_offset != offset )
+            return false;
+
+        const LEGACY_SYMBOL_ENTRY& entry = claimIt->second;
+
+        if( !entry.m_description.IsEmpty() )
+            aSymbol->SetDescription( entry.m_description );
+
+        if( !entry.m_keyWords.IsEmpty() )
+            aSymbol->SetKeyWords( entry.m_keyWords );
+
+        if( !entry.m_docFileName.IsEmpty() )
+        {
+            aSymbol->SetDocFileName( entry.m_docFileName );
+            aSymbol->GetField( DATASHEET )->SetText( entry.m_docFileName );
+        }
+
+        m_symbols[ aSymbol->GetName() ] = aSymbol;
+        m_unloadedSymbols.erase( claimIt );
+        return true;
+    };
+
+    // Aliases keep a reference to the root symbol so they are only usable if the root
+    // symbol is still part of the library.
+    bool rootClaimed = claim( part.get() );
+
+    for( auto& alias : aliases )
+    {
+        if( rootClaimed && claim( alias.second ) )
+            continue;
+
+        LEGACY_SYMBOL_INDEX::iterator aliasIt = m_unloadedSymbols.find( alias.first );
+
+        if( aliasIt != m_unloadedSymbols.end() && aliasIt->second.m_offset == offset )
+            m_unloadedSymbols.erase( aliasIt );
+
+        delete alias.second;
+    }
+
+    if( rootClaimed )
+        part.release();
+
+    it = m_symbols.find( aName );
+
+    return ( it != m_symbols.end() ) ? it->second : NULL;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadAllSymbols()
+{
+    while( !m_unloadedSymbols.empty() )
+    {
+        wxString name = m_unloadedSymbols.begin()->first;
+
+        loadSymbol( name );
+
+        // Make sure a malformed index entry cannot stall the loop.
+        m_unloadedSymbols.erase( name );
+    }
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::GetSymbolNames( wxArrayString& aNames, bool aPowerSymbolsOnly )
+{
+    // Both maps use the same sort order and never share a name so merging them gives the
+    // same name order as a fully parsed library.
+    LIB_PART_MAP::const_iterator loaded = m_symbols.begin();
+    LEGACY_SYMBOL_INDEX::const_iterator unloaded = m_unloadedSymbols.begin();
+    LibPartMapSort less;
+
+    while( loaded != m_symbols.end() || unloaded != m_unloadedSymbols.end() )
+    {
+        if( unloaded == m_unloadedSymbols.end()
+          || ( loaded != m_symbols.end() && less( loaded->first, unloaded->first ) ) )
+        {
+            if( !aPowerSymbolsOnly || loaded->second->IsPower() )
+                aNames.Add( loaded->first );
+
+            ++loaded;
+        }
+        else
+        {
+            if( !aPowerSymbolsOnly || unloaded->second.m_isPower )
+                aNames.Add( unloaded->first );
+
+            ++unloaded;
+        }
+    }
+}
+
+
 LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart( LINE_READER& aReader, int aMajorVersion,
                                              int aMinorVersion, LIB_PART_MAP* aMap )
 {
@@ -3612,6 +4077,9 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     if( !m_isModified )
         return;
 
+    // Every symbol has to be parsed before the library file gets overwritten.
+    loadAllSymbols();
+
     // Write through symlinks, don't replace them
     wxFileName fn = GetRealFile();
 
@@ -4139,6 +4607,8 @@ void SCH_LEGACY_PLUGIN_CACHE::saveDocFile()
 
 void SCH_LEGACY_PLUGIN_CACHE::DeleteSymbol( const wxString& aSymbolName )
 {
+    loadAllSymbols();
+
     LIB_PART_MAP::iterator it = m_symbols.find( aSymbolName );
 
     if( it == m_symbols.end() )
@@ -4241,13 +4711,7 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( wxArrayString&    aSymbolNameList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
-    const LIB_PART_MAP& symbols = m_cache->m_symbols;
-
-    for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
-    {
-        if( !powerSymbolsOnly || it->second->IsPower() )
-            aSymbolNameList.Add( it->first );
-    }
+    m_cache->GetSymbolNames( aSymbolNameList, powerSymbolsOnly );
 }
 
 
@@ -4263,7 +4727,7 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
-    const LIB_PART_MAP& symbols = m_cache->m_symbols;
+    const LIB_PART_MAP& symbols = m_cache->GetSymbols();
 
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
     {
@@ -4282,12 +4746,7 @@ LIB_PART* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxS
 
     cacheLib( aLibraryPath );
 
-    LIB_PART_MAP::const_iterator it = m_cache->m_symbols.find( aSymbolName );
-
-    if( it == m_cache->m_symbols.end() )
-        return nullptr;
-
-    return it->second;
+    return m_cache->GetSymbol( aSymbolName );
 }
 
 
@@ -4423,3 +4882,4 @@ void SCH_LEGACY_PLUGIN::FormatPart( LIB_PART* part, OUTPUTFORMATTER & formatter
 
 const char* SCH_LEGACY_PLUGIN::PropBuffering = "buffering";
 const char* SCH_LEGACY_PLUGIN::PropNoDocFile = "no_doc_file";
+const char* SCH_LEGACY_PLUGIN::PropPrefetchThreads = "prefetch_threads";
@@ -23,6 +23,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <map>
 #include <memory>
 #include <sch_io_mgr.h>
 #include <stack>
@@ -90,6 +91,13 @@ public:
      */
     static const char* PropNoDocFile;
 
+    /**
+     * The property used to set the number of threads parsing the sheet files of a hierarchy
+     * ahead of loading it.  Zero loads each file when its sheet is reached, on the calling
+     * thread.  The default is the number of hardware threads.
+     */
+    static const char* PropPrefetchThreads;
+
     int GetModifyHash() const override;
 
     SCH_SHEET* Load( const wxString& aFileName, KIWAY* aKiway,
@@ -134,6 +142,20 @@ public:
     static void FormatPart( LIB_PART* aPart, OUTPUTFORMATTER& aFormatter );
 
 private:
+    /**
+     * A schematic file parsed ahead of being attached to the sheet hierarchy.
+     */
+    struct PARSED_SCREEN
+    {
+        SCH_SCREEN* m_screen   = nullptr;
+        wxString    m_error;            ///< Empty when the file was parsed without errors.
+        bool        m_repaired = false; ///< Invalid data was fixed while parsing the file.
+    };
+
+    void prefetchHierarchy( SCH_SHEET* aSheet );
+    PARSED_SCREEN parseScreen( const wxString& aFileName );
+    void attachScreen( SCH_SHEET* aSheet, const wxString& aFileName );
+    void releaseParsedScreens();
     void loadHierarchy( SCH_SHEET* aSheet );
     void loadHeader( LINE_READER& aReader, SCH_SCREEN* aScreen );
     void loadPageSettings( LINE_READER& aReader, SCH_SCREEN* aScreen );
@@ -176,6 +198,10 @@ protected:
     SCH_SHEET*           m_rootSheet;  ///< The root sheet of the schematic being loaded..
     OUTPUTFORMATTER*     m_out;        ///< The output formatter for saving SCH_SCREEN objects.
     SCH_LEGACY_PLUGIN_CACHE* m_cache;
+    bool                 m_repaired;   ///< Invalid data was fixed while loading the file.
+
+    /// Schematic files parsed by prefetchHierarchy() keyed by absolute file name.
+    std::map<wxString, PARSED_SCREEN> m_parsedScreens;
 
     /// initialize PLUGIN like a constructor would.
     void init( KIWAY* aKiway, const PROPERTIES* aProperties = nullptr );
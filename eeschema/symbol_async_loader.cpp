@@ -0,0 +1,198 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <class_libentry.h>
+#include <common.h>
+#include <ki_exception.h>
+#include <symbol_lib_table.h>
+#include <widgets/progress_reporter.h>
+
+#include <symbol_async_loader.h>
+
+
+SYMBOL_ASYNC_LOADER::SYMBOL_ASYNC_LOADER( const std::vector<wxString>& aNicknames,
+                                          SYMBOL_LIB_TABLE* aTable, bool aOnlyPowerSymbols,
+                                          PROGRESS_REPORTER* aReporter ) :
+        m_nicknames( aNicknames ),
+        m_table( aTable ),
+        m_onlyPowerSymbols( aOnlyPowerSymbols ),
+        m_reporter( aReporter ),
+        m_finished( 0 ),
+        m_cancelled( false )
+{
+    m_symbols.resize( m_nicknames.size() );
+    m_loaded.resize( m_nicknames.size(), false );
+}
+
+
+SYMBOL_ASYNC_LOADER::~SYMBOL_ASYNC_LOADER()
+{
+    Abort();
+}
+
+
+void SYMBOL_ASYNC_LOADER::Start( unsigned aNThreads )
+{
+    wxCHECK( m_threads.empty(), /* void */ );
+
+    // Instantiating the plugins, building the nickname index of the library table and
+    // expanding the environment variables of the URIs are not thread safe.  Do it here so
+    // the workers never touch the table rows.
+    m_libs.resize( m_nicknames.size() );
+
+    for( size_t ii = 0; ii < m_nicknames.size(); ++ii )
+    {
+        LIB& lib = m_libs[ii];
+
+        try
+        {
+            SYMBOL_LIB_TABLE_ROW* row = m_table->FindRow( m_nicknames[ii] );
+
+            if( !row || !row->plugin )
+                continue;
+
+            lib.plugin = row->plugin;
+            lib.uri = row->GetFullURI( true );
+
+            if( row->GetProperties() )
+                lib.properties = *row->GetProperties();
+
+            if( m_onlyPowerSymbols )
+                lib.properties[ SYMBOL_LIB_TABLE::PropPowerSymsOnly ] = "";
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            lib.error = ioe.What();
+        }
+    }
+
+    for( size_t ii = 0; ii < m_nicknames.size(); ++ii )
+        m_queue.push( ii );
+
+    if( aNThreads == 0 )
+        aNThreads = std::max( 1U, std::thread::hardware_concurrency() );
+
+    aNThreads = std::min<unsigned>( aNThreads, m_nicknames.size() );
+
+    // Changing the locale is global and not thread safe.  Holding a toggle here keeps the
+    // plugins' own toggles from calling setlocale() while the workers run.
+    m_toggle = std::make_unique<LOCALE_IO>();
+
+    for( unsigned ii = 0; ii < aNThreads; ++ii )
+        m_threads.emplace_back( &SYMBOL_ASYNC_LOADER::worker, this );
+}
+
+
+bool SYMBOL_ASYNC_LOADER::Join()
+{
+    joinThreads();
+
+    std::lock_guard<std::mutex> lock( m_resultsLock );
+    return m_errors.IsEmpty();
+}
+
+
+void SYMBOL_ASYNC_LOADER::Abort()
+{
+    m_cancelled.store( true );
+    joinThreads();
+}
+
+
+bool SYMBOL_ASYNC_LOADER::Done() const
+{
+    return m_cancelled.load() || m_finished.load() >= m_nicknames.size();
+}
+
+
+void SYMBOL_ASYNC_LOADER::joinThreads()
+{
+    for( std::thread& thread : m_threads )
+        thread.join();
+
+    m_threads.clear();
+    m_toggle.reset();
+}
+
+
+void SYMBOL_ASYNC_LOADER::worker()
+{
+    size_t index;
+
+    while( !m_cancelled.load() && m_queue.pop( index ) )
+    {
+        std::vector<LIB_PART*> symbols;
+        wxString               error;
+
+        const LIB&            lib = m_libs[index];
+
+        try
+        {
+            if( !lib.error.IsEmpty() )
+                THROW_IO_ERROR( lib.error );
+
+            if( !lib.plugin )
+                THROW_IO_ERROR( wxString::Format( _( "Library \"%s\" not found." ),
+                                                  m_nicknames[index] ) );
+
+            lib.plugin->EnumerateSymbolLib( symbols, lib.uri, &lib.properties );
+
+            // Only the table knows the nickname of the library, see
+            // SYMBOL_LIB_TABLE::LoadSymbolLib().
+            for( LIB_PART* part : symbols )
+            {
+                LIB_ID id = part->GetLibId();
+
+                id.SetLibNickname( m_nicknames[index] );
+                part->SetLibId( id );
+            }
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            error = wxString::Format( _( "Error loading symbol library %s.\n\n%s\n" ),
+                                      m_nicknames[index], ioe.What() );
+        }
+        catch( const std::exception& e )
+        {
+            error = wxString::Format( _( "Error loading symbol library %s.\n\n%s\n" ),
+                                      m_nicknames[index], e.what() );
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( m_resultsLock );
+
+            if( error.IsEmpty() )
+            {
+                m_symbols[index] = std::move( symbols );
+                m_loaded[index] = true;
+            }
+            else
+            {
+                m_errors += error;
+            }
+        }
+
+        m_finished.fetch_add( 1 );
+
+        if( m_reporter )
+            m_reporter->AdvanceProgress();
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYMBOL_ASYNC_LOADER_H
+#define SYMBOL_ASYNC_LOADER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <properties.h>
+#include <sync_queue.h>
+
+class LIB_PART;
+class LOCALE_IO;
+class PROGRESS_REPORTER;
+class SCH_PLUGIN;
+class SYMBOL_LIB_TABLE;
+
+
+/**
+ * Loads the symbols of a list of symbol libraries in worker threads.
+ *
+ * Each library is loaded by a single thread through its own #SCH_PLUGIN instance so
+ * libraries are independent of each other.  The plugins, URIs and options of all of the
+ * libraries are resolved on the calling thread in Start() and the workers never access the
+ * library table, whose rows are not safe to access concurrently.
+ *
+ * The results are kept in the order of the nickname list so the caller can add them to
+ * the GUI from the main thread in a deterministic order.
+ */
+class SYMBOL_ASYNC_LOADER
+{
+public:
+    /**
+     * @param aNicknames is the list of library nicknames to load.
+     * @param aTable is the symbol library table containing the libraries.
+     * @param aOnlyPowerSymbols only loads the power symbols of the libraries when true.
+     * @param aReporter is an optional progress reporter advanced once per library.
+     */
+    SYMBOL_ASYNC_LOADER( const std::vector<wxString>& aNicknames, SYMBOL_LIB_TABLE* aTable,
+                         bool aOnlyPowerSymbols = false, PROGRESS_REPORTER* aReporter = nullptr );
+
+    ~SYMBOL_ASYNC_LOADER();
+
+    /**
+     * Spin up the worker threads.  Returns immediately.
+     *
+     * @param aNThreads is the number of worker threads, 0 uses the hardware concurrency.
+     */
+    void Start( unsigned aNThreads = 0 );
+
+    /**
+     * Wait for the worker threads to finish.
+     *
+     * @return true if all of the libraries were loaded without errors.
+     */
+    bool Join();
+
+    /**
+     * Ask the worker threads to stop after the library they are loading and wait for them.
+     */
+    void Abort();
+
+    /**
+     * @return true when every library has been processed or the load was aborted.
+     */
+    bool Done() const;
+
+    /**
+     * @return the number of libraries processed so far.
+     */
+    size_t GetFinishedCount() const { return m_finished.load(); }
+
+    /**
+     * @return the symbols of each library in the order of the nickname list.  Libraries
+     *         that failed to load or were skipped because of an abort have no symbols.
+     *         Only valid after Join() or Abort().
+     */
+    const std::vector<std::vector<LIB_PART*>>& GetSymbols() const { return m_symbols; }
+
+    /**
+     * @return true for each library of the nickname list that was completely loaded.
+     *         Only valid after Join() or Abort().
+     */
+    const std::vector<bool>& GetLoaded() const { return m_loaded; }
+
+    /**
+     * @return the error messages of the libraries that failed to load, one per line.
+     */
+    const wxString& GetErrors() const { return m_errors; }
+
+private:
+    ///> Worker thread function.
+    void worker();
+
+    ///> Join the worker threads and release the locale toggle.
+    void joinThreads();
+
+    ///> A library resolved from the table before the workers start.
+    struct LIB
+    {
+        SCH_PLUGIN* plugin = nullptr;
+        wxString    uri;                ///< URI with the environment variables expanded.
+        PROPERTIES  properties;
+        wxString    error;              ///< Error looking up the library in the table.
+    };
+
+    std::vector<wxString>               m_nicknames;
+    std::vector<LIB>                    m_libs;
+    SYMBOL_LIB_TABLE*                   m_table;
+    bool                                m_onlyPowerSymbols;
+    PROGRESS_REPORTER*                  m_reporter;
+
+    SYNC_QUEUE<size_t>                  m_queue;        ///< Indices of libraries to load.
+    std::vector<std::thread>            m_threads;
+    std::atomic<size_t>                 m_finished;
+    std::atomic<bool>                   m_cancelled;
+
+    ///> Held while the workers run so they never switch the global locale themselves.
+    std::unique_ptr<LOCALE_IO>          m_toggle;
+
+    std::mutex                          m_resultsLock;
+    std::vector<std::vector<LIB_PART*>> m_symbols;
+    std::vector<bool>                   m_loaded;
+    wxString                            m_errors;
+};
+
+#endif // SYMBOL_ASYNC_LOADER_H
@@ -20,12 +20,13 @@
  */
 
 #include <wx/tokenzr.h>
-#include <wx/progdlg.h>
 
 #include <eda_pattern_match.h>
+#include <symbol_async_loader.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 #include <generate_alias_info.h>
+#include <widgets/progress_reporter.h>
 
 #include <symbol_tree_model_adapter.h>
 
@@ -53,36 +54,59 @@ SYMBOL_TREE_MODEL_ADAPTER::~SYMBOL_TREE_MODEL_ADAPTER()
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNicknames,
                                               wxWindow* aParent )
 {
-    wxProgressDialog* prg = nullptr;
-    wxLongLong        nextUpdate = wxGetUTCTimeMillis() + (PROGRESS_INTERVAL_MILLIS / 2);
+    std::unique_ptr<WX_PROGRESS_REPORTER> progressReporter;
 
     if( m_show_progress )
     {
-        prg = new wxProgressDialog( _( "Loading Symbol Libraries" ), wxEmptyString,
-                                    aNicknames.size(), aParent );
+        progressReporter = std::make_unique<WX_PROGRESS_REPORTER>( aParent,
+                                                    _( "Loading Symbol Libraries" ), 1 );
+        progressReporter->SetMaxProgress( aNicknames.size() );
+        progressReporter->Report( _( "Loading Symbol Libraries" ) );
     }
 
-    unsigned int ii = 0;
+    // Load the libraries in worker threads, the tree itself can only be built on this one.
+    SYMBOL_ASYNC_LOADER loader( aNicknames, m_libs, GetFilter() == CMP_FILTER_POWER,
+                                progressReporter.get() );
 
-    for( const auto& nickname : aNicknames )
+    loader.Start();
+
+    // Only poll to keep the progress dialog responsive, otherwise just wait for the workers.
+    if( progressReporter )
     {
-        if( prg && wxGetUTCTimeMillis() > nextUpdate )
+        while( !loader.Done() )
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
-            nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
+            if( !progressReporter->KeepRefreshing() )
+                loader.Abort();
+
+            wxMilliSleep( PROGRESS_INTERVAL_MILLIS );
         }
+    }
+
+    loader.Join();
+
+    if( !loader.GetErrors().IsEmpty() )
+        wxLogError( loader.GetErrors() );
+
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+    {
+        if( !loader.GetLoaded()[ii] )
+            continue;
 
-        AddLibrary( nickname );
-        ii++;
+        const std::vector<LIB_PART*>& symbols = loader.GetSymbols()[ii];
+
+        if( symbols.size() > 0 )
+        {
+            std::vector<LIB_TREE_ITEM*> comp_list( symbols.begin(), symbols.end() );
+
+            DoAddLibrary( aNicknames[ii], m_libs->GetDescription( aNicknames[ii] ), comp_list,
+                          false );
+        }
     }
 
     m_tree.AssignIntrinsicRanks();
 
-    if( prg )
-    {
-        prg->Destroy();
+    if( progressReporter )
         m_show_progress = false;
-    }
 }
 
 
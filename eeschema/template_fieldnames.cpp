@@ -22,6 +22,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <mutex>
+
 #include <template_fieldnames.h>
 #include <dsnlexer.h>
 #include <fctsys.h>
@@ -39,6 +41,11 @@ const wxString TEMPLATE_FIELDNAME::GetDefaultFieldName( int aFieldNdx )
     static wxString footprintDefault;
     static wxString datasheetDefault;
     static wxString fieldDefault;
+    static std::mutex lock;
+
+    // Symbol libraries (SYMBOL_ASYNC_LOADER) and schematic sheets are loaded by worker
+    // threads, and every LIB_FIELD they create asks for its default name.
+    std::lock_guard<std::mutex> guard( lock );
 
     // Fetching translations can take a surprising amount of time when loading libraries,
     // so only do it when necessary.
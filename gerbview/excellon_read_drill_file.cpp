@@ -265,30 +265,44 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
         return false;
     }
 
-    layerId = images->AddGbrImage( drill_layer, layerId );
+    return AddExcellonImage( drill_layer );
+}
+
+
+bool GERBVIEW_FRAME::AddExcellonImage( EXCELLON_IMAGE* aImage )
+{
+    int layerId = GetActiveLayer();      // current layer used in GerbView
+    GERBER_FILE_IMAGE_LIST* images = GetGerberLayout()->GetImagesList();
+
+    // If the active layer contains old gerber or nc drill data, remove it
+    if( images->GetGbrImage( layerId ) )
+        Erase_Current_DrawLayer( false );
+
+    aImage->m_GraphicLayer = layerId;
+    layerId = images->AddGbrImage( aImage, layerId );
 
     if( layerId < 0 )
     {
-        delete drill_layer;
+        delete aImage;
         DisplayError( this, _( "No room to load file" ) );
         return false;
     }
 
     // Display errors list
-    if( drill_layer->GetMessages().size() > 0 )
+    if( aImage->GetMessages().size() > 0 )
     {
         HTML_MESSAGE_BOX dlg( this, _( "Error reading EXCELLON drill file" ) );
-        dlg.ListSet( drill_layer->GetMessages() );
+        dlg.ListSet( aImage->GetMessages() );
         dlg.ShowModal();
     }
 
     if( GetCanvas() )
     {
-        for( GERBER_DRAW_ITEM* item = drill_layer->GetItemsList(); item; item = item->Next() )
+        for( GERBER_DRAW_ITEM* item = aImage->GetItemsList(); item; item = item->Next() )
             GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
     }
 
-    return success;
+    return true;
 }
 
 /*
@@ -22,6 +22,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
 #include <fctsys.h>
 #include <wx/fs_zip.h>
 #include <wx/wfstream.h>
@@ -269,8 +274,17 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Create progress dialog (only used if more than 1 file to load
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    // The files are independent: they are read in parallel, each one in its own image,
+    // and the images are put on the GerbView layers afterwards, in the list order.
+    struct FILE_TO_LOAD
+    {
+        wxString                           m_path;
+        bool                               m_isDrill;
+        std::unique_ptr<GERBER_FILE_IMAGE> m_image;
+        bool                               m_loaded;
+    };
+
+    std::vector<FILE_TO_LOAD> files;
 
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
@@ -291,62 +305,144 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
             continue;
         }
 
-        m_lastFileName = filename.GetFullPath();
+        // The layer is set when the image is added to the list
+        FILE_TO_LOAD file;
+        file.m_path = filename.GetFullPath();
+        file.m_isDrill = aFileType && (*aFileType)[ii] == 1;
+        file.m_loaded = false;
+
+        if( file.m_isDrill )
+            file.m_image.reset( new EXCELLON_IMAGE( 0 ) );
+        else
+            file.m_image.reset( new GERBER_FILE_IMAGE( 0 ) );
+
+        files.push_back( std::move( file ) );
+    }
+
+    // Create progress dialog (only used if more than 1 file to load
+    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+
+    if( files.size() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading Gerber files..." ), 1, false );
+        progress->SetMaxProgress( files.size() );
+        progress->Report( wxString::Format( _( "Loading %u files" ), (unsigned) files.size() ) );
+        progress->KeepRefreshing();
+    }
+
+    {
+        // The readers switch to the C locale: do it once here, LOCALE_IO does not
+        // support being switched by several threads at the same time
+        LOCALE_IO toggleIo;
+
+        std::atomic<size_t> nextFile( 0 );
+        size_t              parallelThreadCount = std::min<size_t>(
+                std::max<size_t>( std::thread::hardware_concurrency(), 1 ), files.size() );
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
+        auto load_lambda = [&]() -> size_t
         {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%lu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
+            size_t num = 0;
+
+            for( size_t i = nextFile++; i < files.size(); i = nextFile++ )
+            {
+                FILE_TO_LOAD& file = files[i];
+
+                if( file.m_isDrill )
+                {
+                    auto drill = static_cast<EXCELLON_IMAGE*>( file.m_image.get() );
+                    file.m_loaded = drill->LoadFile( file.m_path );
+                }
+                else
+                {
+                    file.m_loaded = file.m_image->LoadGerberFile( file.m_path );
+                }
+
+                if( progress )
+                    progress->AdvanceProgress();
+
+                num++;
+            }
+
+            return num;
+        };
+
+        if( parallelThreadCount <= 1 )
+            load_lambda();
+        else
+        {
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii] = std::async( std::launch::async, load_lambda );
+
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            {
+                // Here we balance returns with a 100ms timeout to allow UI updating
+                std::future_status status;
+                do
+                {
+                    if( progress )
+                        progress->KeepRefreshing();
+
+                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+                } while( status != std::future_status::ready );
+            }
         }
-        else if( progress )
+    }
+
+    for( size_t ii = 0; ii < files.size(); ii++ )
+    {
+        FILE_TO_LOAD& file = files[ii];
+
+        m_lastFileName = file.m_path;
+
+        if( !file.m_loaded )
         {
-            progress->Report( wxString::Format( _("Loading %u/%lu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-            progress->KeepRefreshing();
+            wxString warning;
+            warning << "<b>" << _( "File not readable:" ) << "</b><br>"
+                    << file.m_path << "<br>";
+            reporter.Report( warning, REPORTER::RPT_WARNING );
+            success = false;
+            continue;
         }
 
         SetActiveLayer( layer, false );
 
         visibility[ layer ] = true;
 
-        if( aFileType && (*aFileType)[ii] == 1 )
+        if( file.m_isDrill )
         {
-            LoadExcellonFiles( filename.GetFullPath() );
-            layer = GetActiveLayer();   // Loading NC drill file changes the active layer
+            if( !AddExcellonImage( static_cast<EXCELLON_IMAGE*>( file.m_image.release() ) ) )
+                continue;
+
+            // Update the list of recent drill files.
+            UpdateFileHistory( m_lastFileName, &m_drillFileHistory );
         }
         else
         {
-            if( Read_GERBER_File( filename.GetFullPath() ) )
-            {
-                UpdateFileHistory( m_lastFileName );
+            AddGerberImage( file.m_image.release() );
+            UpdateFileHistory( m_lastFileName );
+        }
 
-                layer = getNextAvailableLayer( layer );
+        layer = getNextAvailableLayer( layer );
 
-                if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
-                {
-                    success = false;
-                    reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
-
-                    // Report the name of not loaded files:
-                    ii += 1;
-                    while( ii < aFilenameList.GetCount() )
-                    {
-                        filename = aFilenameList[ii++];
-                        wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                        reporter.Report( txt, REPORTER::RPT_ERROR );
-                    }
-                    break;
-                }
+        if( layer == NO_AVAILABLE_LAYERS && ii < files.size() - 1 )
+        {
+            success = false;
+            reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
 
-                SetActiveLayer( layer, false );
+            // Report the name of not loaded files:
+            for( ii += 1; ii < files.size(); ii++ )
+            {
+                filename = files[ii].m_path;
+                wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
+                reporter.Report( txt, REPORTER::RPT_ERROR );
             }
+
+            break;
         }
 
-        if( progress )
-            progress->AdvanceProgress();
+        SetActiveLayer( layer, false );
     }
 
     if( !success )
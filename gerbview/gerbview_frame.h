@@ -45,6 +45,7 @@ class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
 class GERBER_FILE_IMAGE_LIST;
+class EXCELLON_IMAGE;
 class REPORTER;
 
 
@@ -524,6 +525,14 @@ public:
     bool LoadGerberFiles( const wxString& aFileName );
     bool Read_GERBER_File( const wxString&   GERBER_FullFileName );
 
+    /**
+     * Function AddGerberImage
+     * puts an image read from a Gerber file on the active layer, replacing its content,
+     * reports the errors found in the file and shows its items.
+     * @param aImage is the image, owned by the images list after the call.
+     */
+    void AddGerberImage( GERBER_FILE_IMAGE* aImage );
+
     /**
      * function LoadExcellonFiles
      * Load a drill (EXCELLON) file or many files.
@@ -535,6 +544,15 @@ public:
     bool LoadExcellonFiles( const wxString& aFileName );
     bool Read_EXCELLON_File( const wxString& aFullFileName );
 
+    /**
+     * Function AddExcellonImage
+     * puts an image read from a drill file on the active layer, as AddGerberImage().
+     * @param aImage is the image, owned by the images list after the call, or deleted
+     * if it cannot be added.
+     * @return true if the image was added.
+     */
+    bool AddExcellonImage( EXCELLON_IMAGE* aImage );
+
     /**
      * function LoadZipArchiveFileLoadZipArchiveFile
      * Load a zipped archive file.
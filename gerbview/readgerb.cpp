@@ -42,15 +42,13 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
     wxString msg;
 
     int layer = GetActiveLayer();
-    GERBER_FILE_IMAGE_LIST* images = GetImagesList();
-    GERBER_FILE_IMAGE* gerber = GetGbrImage( layer );
 
-    if( gerber != NULL )
+    if( GetGbrImage( layer ) != NULL )
     {
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
+    GERBER_FILE_IMAGE* gerber = new GERBER_FILE_IMAGE( layer );
 
     // Read the gerber file. The image will be added only if it can be read
     // to avoid broken data.
@@ -64,24 +62,42 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         return false;
     }
 
-    images->AddGbrImage( gerber, layer );
+    AddGerberImage( gerber );
+
+    return true;
+}
+
+
+void GERBVIEW_FRAME::AddGerberImage( GERBER_FILE_IMAGE* aImage )
+{
+    wxString msg;
+
+    int layer = GetActiveLayer();
+
+    if( GetGbrImage( layer ) != NULL )
+    {
+        Erase_Current_DrawLayer( false );
+    }
+
+    aImage->m_GraphicLayer = layer;
+    GetImagesList()->AddGbrImage( aImage, layer );
 
     // Display errors list
-    if( gerber->GetMessages().size() > 0 )
+    if( aImage->GetMessages().size() > 0 )
     {
         HTML_MESSAGE_BOX dlg( this, _("Errors") );
-        dlg.ListSet(gerber->GetMessages());
+        dlg.ListSet(aImage->GetMessages());
         dlg.ShowModal();
     }
 
-    /* if the gerber file has items using D codes but missing D codes definitions,
+    /* if the aImage file has items using D codes but missing D codes definitions,
      * it can be a deprecated RS274D file (i.e. without any aperture information),
      * or has missing definitions,
      * warn the user:
      */
-    if( gerber->GetItemsList() && gerber->m_Has_MissingDCode )
+    if( aImage->GetItemsList() && aImage->m_Has_MissingDCode )
     {
-        if( !gerber->m_Has_DCode )
+        if( !aImage->m_Has_DCode )
             msg = _("Warning: this file has no D-Code definition\n"
                     "Therefore the size of some items is undefined");
         else
@@ -93,17 +109,15 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 
     if( GetCanvas() )
     {
-        if( gerber->m_ImageNegative )
+        if( aImage->m_ImageNegative )
         {
             // TODO: find a way to handle negative images
             // (maybe convert geometry into positives?)
         }
 
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
+        for( auto item = aImage->GetItemsList(); item; item = item->Next() )
             GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
     }
-
-    return true;
 }
 
 
@@ -111,8 +125,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -120,6 +132,11 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     int      D_commande = 0;       // command number for D commands like D02
     char*    text;
 
+    // A large buffer to store one line. Not a static one: several files can be
+    // read at the same time
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char*    lineBuffer = buffer.data();
+
     ClearMessageList( );
     ResetDefaultValues();
 
@@ -25,11 +25,12 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <mutex>
+
 #include <eda_rect.h>
 
 #include <gal/stroke_font.h>
 #include <gal/graphics_abstraction_layer.h>
-#include <newstroke_font.h>
 
 class PLOTTER;
 
@@ -167,4 +168,8 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/// basic_gal stores the attributes of the text being drawn, so it must be locked while it
+/// is used (texts can be plotted by several threads).
+extern std::mutex basic_gal_mutex;
+
 #endif      // define BASIC_GAL_H
@@ -31,6 +31,10 @@
 #include <base_struct.h>            // EDA_RECT
 #include "kicad_string.h"
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 class SHAPE_POLY_SET;
 
 // part of the kicad_plugin.h family of defines.
@@ -99,6 +103,18 @@ struct TEXT_EFFECTS
 };
 
 
+/**
+ * Struct TEXT_SHAPE
+ * is the laid out shape of a text: the strokes of its glyphs and their bounding box.
+ * It is built by EDA_TEXT::GetTextShape() and shared by all the users of the same text.
+ */
+struct TEXT_SHAPE
+{
+    std::vector<wxPoint> m_Segments;     ///< 2 points (start and end) per stroke segment
+    EDA_RECT             m_BoundingBox;  ///< box of the segments, including the pen width
+};
+
+
 /**
  * Class EDA_TEXT
  * is a mix-in class (via multiple inheritance) that handles texts such as
@@ -263,6 +279,32 @@ public:
      */
     void TransformTextShapeToSegmentList( std::vector<wxPoint>& aCornerBuffer ) const;
 
+    /**
+     * Function GetTextShape
+     * returns the strokes of the shown text, laid out with the current text effects.
+     * The shape is built on the first call and cached: it is rebuilt only when the
+     * text, its effects or \a aAngle have changed since the previous call.
+     * This function is thread safe, and the returned shape is never modified.
+     * @param aAngle is the draw rotation of the text, in 0.1 degrees.  It is only
+     * needed by texts drawn with an other angle than GetTextAngle(), like footprint
+     * texts (single line texts only).
+     */
+    std::shared_ptr<const TEXT_SHAPE> GetTextShape( double aAngle ) const;
+
+    std::shared_ptr<const TEXT_SHAPE> GetTextShape() const
+    {
+        return GetTextShape( GetTextAngle() );
+    }
+
+    /**
+     * Functions GetShapeCacheHits, GetShapeCacheMisses
+     * return the count of calls to GetTextShape() (for all texts) that found the
+     * shape in the cache, or that had to build it.  For profiling purpose.
+     */
+    static int64_t GetShapeCacheHits();
+    static int64_t GetShapeCacheMisses();
+    static void ResetShapeCacheStats();
+
     /**
      * Function TransformBoundingBoxWithClearanceToPolygon
      * Convert the text bounding box to a rectangular polygon
@@ -388,6 +430,19 @@ private:
     // Private text effects data. API above provides accessor funcs.
     TEXT_EFFECTS    m_e;
 
+    /// The last shape built by GetTextShape(), with the parameters used to build it.
+    struct SHAPE_CACHE
+    {
+        TEXT_EFFECTS m_Effects;
+        wxString     m_Text;
+        double       m_Angle;
+        TEXT_SHAPE   m_Shape;
+    };
+
+    // Only accessed with std::atomic_load/std::atomic_store: the cache can be read
+    // and replaced from several threads (zone filling, plotting...)
+    mutable std::shared_ptr<const SHAPE_CACHE> m_shapeCache;
+
     /// EDA_TEXT effects bools
     enum TE_FLAGS {
         // start at zero, sequence is irrelevant
@@ -34,6 +34,7 @@
 
 #include <gal/compositor.h>
 #include <gal/gal_display_options.h>
+#include <math/box2.h>
 #include <cairo.h>
 
 #include <cstdint>
@@ -93,6 +94,18 @@ public:
         }
     }
 
+    /**
+     * Function CreateTileContext()
+     * creates a context drawing directly in the pixel storage of the current buffer,
+     * limited to a part of it.  Contexts of non overlapping parts may be used from
+     * different threads, while the current buffer is not used.
+     *
+     * @param aRect is the part of the buffer to draw in, in pixels.
+     * @return The new context, to be destroyed by the caller, or nullptr if aRect is empty
+     * or not inside the buffer.
+     */
+    cairo_t* CreateTileContext( const BOX2I& aRect );
+
     /**
      * Function SetMainContext()
      * Sets a context to be treated as the main context (ie. as a target of buffers rendering and
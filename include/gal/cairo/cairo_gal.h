@@ -36,8 +36,10 @@
 
 #include <gal/graphics_abstraction_layer.h>
 #include <wx/dcbuffer.h>
+#include <wx/image.h>
 
 #include <memory>
+#include <vector>
 
 /**
  * @brief Class CAIRO_GAL is the cairo implementation of the graphics abstraction layer.
@@ -380,6 +382,9 @@ public:
 
     virtual void ClearTarget( RENDER_TARGET aTarget ) override;
 
+    /// @copydoc GAL::CreateTileGAL()
+    virtual GAL* CreateTileGAL( const BOX2I& aScreenRect ) override;
+
     /**
      * Function PostPaint
      * posts an event to m_paint_listener.  A post is used so that the actual drawing
@@ -466,6 +471,79 @@ protected:
     bool updatedGalDisplayOptions( const GAL_DISPLAY_OPTIONS& aOptions ) override;
 };
 
+
+
+/**
+ * @brief Class CAIRO_TILE_GAL draws a part of the screen of a CAIRO_GAL.
+ *
+ * It has the same world to screen transformation as its parent, and draws in immediate
+ * mode with its own context, in the pixels of the tile.  See GAL::CreateTileGAL().
+ */
+class CAIRO_TILE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    /**
+     * @param aParent is the GAL whose part of the screen is drawn.
+     * @param aContext is the context drawing in the tile pixels, it is destroyed with the GAL.
+     * @param aOrigin is the top left corner of the tile on the screen, in pixels.
+     */
+    CAIRO_TILE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, const GAL& aParent,
+                    cairo_t* aContext, const VECTOR2I& aOrigin );
+
+    /// The screen is cleared by the parent GAL
+    virtual void ClearScreen() override {}
+};
+
+
+/**
+ * @brief Class CAIRO_IMAGE_GAL draws in memory, without a window.
+ *
+ * Its targets are composited as in CAIRO_GAL, so it draws the same images, e.g. to render
+ * boards from the command line or to measure the drawing performance.
+ */
+class CAIRO_IMAGE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    /**
+     * @param aWidth and aHeight are the image size, in pixels.
+     */
+    CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth, int aHeight );
+
+    virtual ~CAIRO_IMAGE_GAL();
+
+    virtual void ResizeScreen( int aWidth, int aHeight ) override;
+
+    virtual void SetTarget( RENDER_TARGET aTarget ) override;
+
+    virtual RENDER_TARGET GetTarget() const override;
+
+    virtual void ClearTarget( RENDER_TARGET aTarget ) override;
+
+    /// @copydoc GAL::CreateTileGAL()
+    virtual GAL* CreateTileGAL( const BOX2I& aScreenRect ) override;
+
+    /**
+     * Function GetImage
+     * returns the image drawn between the last BeginDrawing() and EndDrawing() calls.
+     */
+    wxImage GetImage() const;
+
+protected:
+    /// @copydoc GAL::BeginDrawing()
+    virtual void beginDrawing() override;
+
+    /// @copydoc GAL::EndDrawing()
+    virtual void endDrawing() override;
+
+    std::unique_ptr<CAIRO_COMPOSITOR> compositor;   ///< Object for layers compositing
+    unsigned int            mainBuffer;             ///< Handle to the main buffer
+    unsigned int            overlayBuffer;          ///< Handle to the overlay buffer
+    RENDER_TARGET           currentTarget;          ///< Current rendering target
+
+    std::vector<unsigned char> bitmapBuffer;        ///< Storage of the cairo image
+    int                     stride;                 ///< Stride value for Cairo
+};
+
 } // namespace KIGFX
 
 #endif  // CAIROGAL_H_
@@ -32,12 +32,12 @@
 #include <limits>
 
 #include <math/matrix3x3.h>
+#include <math/box2.h>
 
 #include <gal/color4d.h>
 #include <gal/definitions.h>
 #include <gal/stroke_font.h>
 #include <gal/gal_display_options.h>
-#include <newstroke_font.h>
 
 class SHAPE_LINE_CHAIN;
 class SHAPE_POLY_SET;
@@ -833,6 +833,20 @@ public:
      */
     virtual void ClearTarget( RENDER_TARGET aTarget ) {};
 
+    /**
+     * @brief Creates a GAL drawing a part of the screen in the current target.
+     *
+     * The returned GAL uses the world to screen transformation of this GAL, and draws
+     * in immediate mode directly to the pixels of aScreenRect in the current target.
+     * GALs of non overlapping tiles can draw at the same time from different threads,
+     * as long as this GAL does not draw in the meantime.  They have to be deleted before
+     * this GAL finishes drawing.
+     *
+     * @param aScreenRect is the part of the screen to draw, in pixels.
+     * @return The tile GAL, owned by the caller, or nullptr if the GAL cannot draw tiles.
+     */
+    virtual GAL* CreateTileGAL( const BOX2I& aScreenRect ) { return nullptr; };
+
     /**
      * @brief Sets negative draw mode in the renderer
      *
@@ -1128,6 +1142,12 @@ protected:
         worldScale = screenDPI * worldUnitLength * zoomFactor;
     }
 
+    /**
+     * Copy the world->screen transform (screen size, zoom, look at point, rotation,
+     * flipping and depth range) of another GAL.
+     */
+    void copyWorldTransform( const GAL& aGal );
+
     /**
      * @brief compute minimum grid spacing from the grid settings
      *
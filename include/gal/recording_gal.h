@@ -0,0 +1,199 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef RECORDING_GAL_H_
+#define RECORDING_GAL_H_
+
+#include <gal/graphics_abstraction_layer.h>
+#include <geometry/shape_poly_set.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace KIGFX
+{
+
+/**
+ * Class GAL_DISPLAY_LIST
+ * is a list of GAL drawing commands recorded by RECORDING_GAL, that can be replayed
+ * later on an other GAL.
+ */
+class GAL_DISPLAY_LIST
+{
+public:
+    /**
+     * Function Replay
+     * sends the recorded commands to \a aGal, in the order they were recorded.
+     */
+    void Replay( GAL& aGal ) const;
+
+    bool Empty() const { return m_commands.empty(); }
+
+    void Clear();
+
+private:
+    friend class RECORDING_GAL;
+
+    enum COMMAND : uint8_t
+    {
+        CMD_LINE,
+        CMD_SEGMENT,
+        CMD_POLYLINE,
+        CMD_POLYLINE_CHAIN,
+        CMD_CIRCLE,
+        CMD_ARC,
+        CMD_ARC_SEGMENT,
+        CMD_RECTANGLE,
+        CMD_POLYGON,
+        CMD_POLYGON_CHAIN,
+        CMD_POLYGON_SET,
+        CMD_CURVE,
+        CMD_BITMAP,
+        CMD_BITMAP_TEXT,
+        CMD_IS_FILL,
+        CMD_IS_STROKE,
+        CMD_FILL_COLOR,
+        CMD_STROKE_COLOR,
+        CMD_LINE_WIDTH,
+        CMD_LAYER_DEPTH,
+        CMD_NEGATIVE_DRAW_MODE,
+        CMD_TRANSFORM,
+        CMD_ROTATE,
+        CMD_TRANSLATE,
+        CMD_SCALE,
+        CMD_SAVE,
+        CMD_RESTORE
+    };
+
+    // The arguments of each command are stored in the order of the commands.
+    // Scalar and point arguments go to m_args, the other ones to their own list.
+    std::vector<COMMAND>              m_commands;
+    std::vector<double>               m_args;
+    std::vector<VECTOR2D>             m_points;     ///< points of polylines and polygons
+    std::vector<SHAPE_LINE_CHAIN>     m_chains;
+    std::vector<SHAPE_POLY_SET>       m_polySets;
+    std::vector<wxString>             m_texts;
+    std::vector<const BITMAP_BASE*>   m_bitmaps;
+};
+
+
+/**
+ * Class RECORDING_GAL
+ * is a GAL that does not draw anything but records the drawing commands it receives
+ * in a GAL_DISPLAY_LIST.
+ *
+ * It allows painters to run from worker threads: each thread draws items on its own
+ * RECORDING_GAL, and the display lists are replayed on the real GAL by the thread owning
+ * it.  Stroke texts are laid out by the recording GAL, so only their strokes are replayed.
+ *
+ * The world transform and the engine type are copied from the GAL the commands are
+ * recorded for, so painters get the same answers as when drawing on it directly.
+ */
+class RECORDING_GAL : public GAL
+{
+public:
+    /**
+     * @param aTarget is the GAL the recorded commands are intended for.  Its world
+     * transform is copied, so the recording GAL must be created again when it changes.
+     */
+    RECORDING_GAL( GAL* aTarget );
+
+    /**
+     * Function TakeDisplayList
+     * returns the commands recorded since the previous call, and starts a new list.
+     */
+    std::unique_ptr<GAL_DISPLAY_LIST> TakeDisplayList();
+
+    /// Drop the commands recorded since the previous call to TakeDisplayList().
+    void ClearDisplayList() { m_list->Clear(); }
+
+    bool IsCairoEngine() override { return m_isCairo; }
+    bool IsOpenGlEngine() override { return m_isOpenGl; }
+
+    void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                      double aWidth ) override;
+    void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+    void DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                  double aEndAngle ) override;
+    void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                         double aEndAngle, double aWidth ) override;
+    void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
+    void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) override;
+    void DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                    const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                    double aFilterValue = 0.0 ) override;
+    void DrawBitmap( const BITMAP_BASE& aBitmap ) override;
+
+    void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                     double aRotationAngle ) override;
+
+    void SetIsFill( bool aIsFillEnabled ) override;
+    void SetIsStroke( bool aIsStrokeEnabled ) override;
+    void SetFillColor( const COLOR4D& aColor ) override;
+    void SetStrokeColor( const COLOR4D& aColor ) override;
+    void SetLineWidth( float aLineWidth ) override;
+    void SetLayerDepth( double aLayerDepth ) override;
+    void SetNegativeDrawMode( bool aSetting ) override;
+
+    void Transform( const MATRIX3x3D& aTransformation ) override;
+    void Rotate( double aAngle ) override;
+    void Translate( const VECTOR2D& aTranslation ) override;
+    void Scale( const VECTOR2D& aScale ) override;
+    void Save() override;
+    void Restore() override;
+
+private:
+    void addCommand( GAL_DISPLAY_LIST::COMMAND aCommand )
+    {
+        m_list->m_commands.push_back( aCommand );
+    }
+
+    void addArg( double aValue )
+    {
+        m_list->m_args.push_back( aValue );
+    }
+
+    void addArg( const VECTOR2D& aPoint )
+    {
+        m_list->m_args.push_back( aPoint.x );
+        m_list->m_args.push_back( aPoint.y );
+    }
+
+    void addArg( const COLOR4D& aColor );
+
+    bool                              m_isCairo;
+    bool                              m_isOpenGl;
+    std::unique_ptr<GAL_DISPLAY_LIST> m_list;
+};
+
+}   // namespace KIGFX
+
+#endif  // RECORDING_GAL_H_
@@ -42,9 +42,6 @@ namespace KIGFX
 {
 class GAL;
 
-typedef std::vector<std::vector<VECTOR2D>> GLYPH;
-typedef std::vector<GLYPH>                 GLYPH_LIST;
-
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
  *
@@ -61,11 +58,11 @@ public:
     /**
      * @brief Load the new stroke font.
      *
-     * @param aNewStrokeFont is the pointer to the font data.
-     * @param aNewStrokeFontSize is the size of the font data.
+     * The glyphs of the font are decoded at build time into constant tables, so this
+     * has no cost.
      * @return True, if the font was successfully loaded, else false.
      */
-    bool LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize );
+    bool LoadNewStrokeFont();
 
     /**
      * @brief Draw a string.
@@ -121,8 +118,17 @@ public:
 
 private:
     GAL*                      m_gal;                  ///< Pointer to the GAL
-    const GLYPH_LIST*         m_glyphs;               ///< Glyph list
-    const std::vector<BOX2D>* m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+
+    /**
+     * @return the index in the glyph tables of the glyph used to draw aChar ('?' if
+     * the font has no glyph for aChar).
+     */
+    static int glyphIndex( unsigned aChar );
+
+    /**
+     * @return the width (advance) of a glyph, for a glyph size of 1.0
+     */
+    static double glyphWidth( int aGlyphIndex );
 
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
@@ -141,15 +147,6 @@ private:
      */
     double computeOverbarVerticalPosition() const;
 
-    /**
-     * @brief Compute the bounding box of a given glyph.
-     *
-     * @param aGlyph is the glyph.
-     * @param aGlyphWidth is the x-component of the bounding box size.
-     * @return is the complete bounding box size.
-     */
-    BOX2D computeBoundingBox( const GLYPH& aGlyph, double aGlyphWidth ) const;
-
     /**
      * @brief Draws a single line of text. Multiline texts should be split before using the
      * function.
@@ -0,0 +1,116 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLYGON_LOD_H
+#define __POLYGON_LOD_H
+
+#include <geometry/shape_poly_set.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * Class POLYGON_LOD
+ *
+ * Keeps simplified versions of a polygon set, to draw it with less vertices when
+ * zoomed out.
+ *
+ * Level 0 is the polygon set itself.  At level n > 0, the outlines are simplified
+ * (Douglas-Peucker) with a max deviation of aBaseTolerance * 2^(n-1), then cleaned up
+ * and triangulated.  The levels are built on demand and kept until the source polygon
+ * set changes.  A translated source reuses them, with an offset.
+ *
+ * Get() can be called from several threads drawing the same source, e.g. the tiles
+ * of a redraw.
+ */
+class POLYGON_LOD
+{
+public:
+    ///> Number of levels, including the level 0
+    static const int LEVEL_COUNT = 10;
+
+    ///> Polygon sets with less vertices are always drawn at level 0
+    static const int MIN_VERTEX_COUNT = 128;
+
+    /**
+     * @param aBaseTolerance is the max deviation of the outlines at level 1, in
+     * internal units.
+     */
+    POLYGON_LOD( int aBaseTolerance ) :
+        m_baseTolerance( aBaseTolerance )
+    {
+        Clear();
+    }
+
+    /**
+     * Function Level
+     * returns the most simplified level keeping the deviation under half of
+     * aPixelSize (in internal units).
+     */
+    static int Level( double aPixelSize, int aBaseTolerance );
+
+    int Level( double aPixelSize ) const
+    {
+        return Level( aPixelSize, m_baseTolerance );
+    }
+
+    /**
+     * Function Get
+     * returns aSource simplified at aLevel, building it if needed.
+     * @param aOffset is set to the translation to apply to the returned polygon set,
+     * non zero when aSource was moved since the level was built.
+     */
+    const SHAPE_POLY_SET& Get( const SHAPE_POLY_SET& aSource, int aLevel, VECTOR2I& aOffset );
+
+    ///> Drops the simplified levels
+    void Clear();
+
+private:
+    ///> Identifies the shape of a polygon set, independently of its position
+    struct KEY
+    {
+        int      m_vertexCount;
+        VECTOR2I m_origin;
+        uint64_t m_hash;
+    };
+
+    static KEY makeKey( const SHAPE_POLY_SET& aSource );
+
+    void build( const SHAPE_POLY_SET& aSource, int aLevel );
+
+    enum LEVEL_STATE : uint8_t
+    {
+        LS_NOT_BUILT,
+        LS_SOURCE,          ///< simplification does not pay off, the source is used
+        LS_BUILT
+    };
+
+    int                          m_baseTolerance;
+    KEY                          m_key;
+    std::vector<LEVEL_STATE>     m_states;
+    std::vector<SHAPE_POLY_SET>  m_levels;
+    std::mutex                   m_mutex;
+};
+
+#endif
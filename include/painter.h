@@ -359,6 +359,22 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * creates a painter drawing as this one, with the same settings, on an other GAL.
+     * The VIEW uses clones drawing on RECORDING_GALs to draw items from worker threads,
+     * so Draw() of a clone must not modify the items nor any data shared with other
+     * painters, and must only change the GAL state through virtual GAL methods or text
+     * attributes.  The default implementation returns nullptr: the items of a painter
+     * that cannot be cloned are drawn by the main thread.
+     * @param aGal is the GAL the new painter draws on.
+     * @return a new painter (the caller takes its ownership) or nullptr.
+     */
+    virtual PAINTER* Clone( GAL* aGal )
+    {
+        return nullptr;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
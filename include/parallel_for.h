@@ -0,0 +1,87 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Run aFunc( 0 ) .. aFunc( aCount - 1 ) on several threads and wait for all of them.
+ *
+ * The threads take the items in order from a shared counter, so they stay busy when the
+ * items take different times.  The calling thread is one of them.  If aFunc throws, the
+ * items not started yet are skipped and the first exception is rethrown once the threads
+ * are joined.
+ *
+ * @param aCount is the number of items.
+ * @param aFunc is called once for each item, from any of the threads.
+ * @param aThreadCount is the maximum number of threads, 0 for one per core.
+ */
+inline void ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                         size_t aThreadCount = 0 )
+{
+    if( aThreadCount == 0 )
+        aThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+    aThreadCount = std::min( aThreadCount, aCount );
+
+    std::atomic<size_t> nextItem( 0 );
+    std::exception_ptr  error;
+    std::mutex          errorLock;
+
+    auto worker = [&]()
+    {
+        try
+        {
+            for( size_t ii = nextItem++; ii < aCount; ii = nextItem++ )
+                aFunc( ii );
+        }
+        catch( ... )
+        {
+            std::lock_guard<std::mutex> guard( errorLock );
+
+            if( !error )
+                error = std::current_exception();
+
+            nextItem = aCount;
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 1; ii < aThreadCount; ++ii )
+        threads.emplace_back( worker );
+
+    worker();
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    if( error )
+        std::rethrow_exception( error );
+}
+
+#endif // PARALLEL_FOR_H
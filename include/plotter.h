@@ -33,6 +33,8 @@
 #define PLOT_COMMON_H_
 
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include <math/box2.h>
 #include <gr_text.h>
 #include <page_info.h>
@@ -762,6 +764,9 @@ protected:
                                       std::vector<int> *pos_pairs );
     void fputsPostscriptString(FILE *fout, const wxString& txt);
 
+    /// Return the string txt escaped for postscript/PDF, as written by fputsPostscriptString
+    std::string encodePostscriptString( const wxString& txt );
+
     /// Virtual primitive for emitting the setrgbcolor operator
     virtual void emitSetRGBColor( double r, double g, double b ) = 0;
 
@@ -837,15 +842,14 @@ protected:
     virtual void emitSetRGBColor( double r, double g, double b ) override;
 };
 
+class PDF_PAGE_STREAM;
+struct PDF_PENDING_STREAM;
+
 class PDF_PLOTTER : public PSLIKE_PLOTTER
 {
 public:
-    PDF_PLOTTER() : pageStreamHandle( 0 ), workFile( NULL )
-    {
-        // Avoid non initialized variables:
-        pageStreamHandle = streamLengthHandle = fontResDictHandle = 0;
-        pageTreeHandle = 0;
-    }
+    PDF_PLOTTER();
+    ~PDF_PLOTTER();
 
     virtual PlotFormat GetPlotterType() const override
     {
@@ -874,6 +878,21 @@ public:
     virtual void SetCurrentLineWidth( int width, void* aData = NULL ) override;
     virtual void SetDash( int dashed ) override;
 
+    /**
+     * Set the zlib compression level of the page streams, from 0 (no compression)
+     * to 9 (best compression, the default).
+     * Must be called before StartPlot()
+     */
+    void SetCompressionLevel( int aLevel ) { m_compressionLevel = aLevel; }
+
+    /**
+     * When enabled, the content of each page is compressed by a worker thread when the
+     * page is closed, while the next pages are plotted.  Useful for documents having
+     * many pages.
+     * Must be called before StartPlot()
+     */
+    void SetThreadedCompression( bool aEnable ) { m_threadedCompression = aEnable; }
+
     /** PDF can have multiple pages, so SetPageSettings can be called
      * with the outputFile open (but not inside a page stream!) */
     virtual void SetPageSettings( const PAGE_INFO& aPageSettings ) override;
@@ -916,14 +935,29 @@ protected:
     void closePdfObject();
     int startPdfStream(int handle = -1);
     void closePdfStream();
+
+    /// Write a compressed stream object and its length object
+    void writePdfStream( int aHandle, int aLengthHandle, const std::string& aData );
+
+    /// Write the streams compressed by worker threads, in order.  Only the streams
+    /// already compressed are written, unless aWaitAll is true.
+    void writePendingStreams( bool aWaitAll );
+
     int pageTreeHandle;		 /// Handle to the root of the page tree object
     int fontResDictHandle;	 /// Font resource dictionary
     std::vector<int> pageHandles;/// Handles to the page objects
     int pageStreamHandle;	 /// Handle of the page content object
+    int streamHandle;            /// Handle of the stream being built
     int streamLengthHandle;      /// Handle to the deferred stream length
-    wxString workFilename;
-    FILE* workFile;  	         /// Temporary file to costruct the stream before zipping
+    std::unique_ptr<PDF_PAGE_STREAM> workStream; /// The stream being built, compressed
+                                                 /// when it is closed or while it is written
     std::vector<long> xrefTable; /// The PDF xref offset table
+
+    int  m_compressionLevel;     /// The zlib compression level of streams
+    bool m_threadedCompression;  /// true to compress the streams in worker threads
+
+    /// Streams compressed by worker threads, waiting to be written, in page order
+    std::vector<std::unique_ptr<PDF_PENDING_STREAM>> m_pendingStreams;
 };
 
 class SVG_PLOTTER : public PSLIKE_PLOTTER
@@ -1371,6 +1405,43 @@ protected:
     std::vector<APERTURE> m_apertures;  // The list of available apertures
     int m_currentApertureIdx;   // The index of the current aperture in m_apertures
 
+    /**
+     * The key used to find an aperture in m_apertures: its type, its size (or diameter and
+     * rotation for regular polygons) and its attribute.
+     */
+    struct APERTURE_KEY
+    {
+        APERTURE::APERTURE_TYPE m_Type;
+        wxSize                  m_Size;
+        int                     m_ApertureAttribute;
+
+        bool operator==( const APERTURE_KEY& aOther ) const
+        {
+            return m_Type == aOther.m_Type && m_Size == aOther.m_Size
+                   && m_ApertureAttribute == aOther.m_ApertureAttribute;
+        }
+    };
+
+    struct APERTURE_KEY_HASH
+    {
+        size_t operator()( const APERTURE_KEY& aKey ) const
+        {
+            size_t seed = std::hash<int>()( aKey.m_Type );
+            seed ^= std::hash<int>()( aKey.m_Size.x ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+            seed ^= std::hash<int>()( aKey.m_Size.y ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+            seed ^= std::hash<int>()( aKey.m_ApertureAttribute ) + 0x9e3779b9
+                    + ( seed << 6 ) + ( seed >> 2 );
+            return seed;
+        }
+    };
+
+    // The index of each aperture of m_apertures, to avoid searching the whole list
+    // each time an aperture is selected
+    std::unordered_map<APERTURE_KEY, int, APERTURE_KEY_HASH> m_apertureIndex;
+
+    // A buffer reused to build the corner list of the regions flashed for pads
+    std::vector<wxPoint> m_regionCorners;
+
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
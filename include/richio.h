@@ -244,6 +244,27 @@ public:
         rewind( m_fp );
         m_lineNum = 0;
     }
+
+    /**
+     * Function Tell
+     * returns the current position in the file, suitable to be passed to Seek().
+     */
+    long Tell() const
+    {
+        return ftell( m_fp );
+    }
+
+    /**
+     * Function Seek
+     * moves the file position to @a aOffset, previously returned by Tell(), and
+     * sets the line number to @a aLineNumber.  The next ReadLine() will report
+     * aLineNumber + 1.
+     */
+    void Seek( long aOffset, unsigned aLineNumber )
+    {
+        fseek( m_fp, aOffset, SEEK_SET );
+        m_lineNum = aLineNumber;
+    }
 };
 
 
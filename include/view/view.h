@@ -29,6 +29,7 @@
 #include <set>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 
 #include <math/box2.h>
 #include <gal/definitions.h>
@@ -39,6 +40,7 @@ namespace KIGFX
 {
 class PAINTER;
 class GAL;
+class GAL_DISPLAY_LIST;
 class VIEW_ITEM;
 class VIEW_GROUP;
 class VIEW_RTREE;
@@ -677,6 +679,17 @@ public:
         m_reverseDrawOrder = aFlag;
     }
 
+    /**
+     * Function SetUpdateThreadCount()
+     * Sets the number of worker threads drawing the items when updating many of them.
+     * @param aCount is the number of threads, 0 to use one thread per core.  Items are
+     * drawn by the calling thread only when it is 1.
+     */
+    void SetUpdateThreadCount( unsigned aCount )
+    {
+        m_updateThreadCount = aCount;
+    }
+
     std::shared_ptr<VIEW_OVERLAY> MakeOverlay();
 
     /**
@@ -731,6 +744,16 @@ protected:
     ///* Redraws contents within rect aRect
     void redrawRect( const BOX2I& aRect );
 
+    /**
+     * Function redrawTiles()
+     * Draws the contents of layers within rect aRect by screen tiles, each tile being
+     * drawn by a worker thread with a GAL from GAL::CreateTileGAL() and a clone of the
+     * painter.
+     * @param aLayers are the layers to draw, in the drawing order, all in the same target.
+     * @return false if the GAL or the painter do not support it, nothing is drawn then.
+     */
+    bool redrawTiles( const BOX2I& aRect, const LAYER_ORDER& aLayers );
+
     inline void markTargetClean( int aTarget )
     {
         wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
@@ -776,19 +799,37 @@ protected:
     ///* used by GAL)
     void clearGroupCache();
 
+    /// Items and the layer on which they have to be drawn again, the entries of an
+    /// item being consecutive
+    typedef std::vector<std::pair<VIEW_ITEM*, int>> ITEM_LAYER_LIST;
+
     /**
      * Function invalidateItem()
      * Manages dirty flags & redraw queueing when updating an item.
      * @param aItem is the item to be updated.
      * @param aUpdateFlags determines the way an item is refreshed.
+     * @param aRedrawList receives the layers on which the item has to be drawn again.
      */
-    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
+    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags, ITEM_LAYER_LIST& aRedrawList );
 
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
 
-    /// Updates all informations needed to draw an item
-    void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
+    /**
+     * Updates all informations needed to draw an item
+     * @param aDisplayList is the item drawing, already recorded by a painter. If null,
+     * the item is drawn by the painter of the view.
+     */
+    void updateItemGeometry( VIEW_ITEM* aItem, int aLayer,
+                             const GAL_DISPLAY_LIST* aDisplayList = nullptr );
+
+    /**
+     * Function updateItemsGeometry()
+     * Updates the drawing of a list of items.  When the list is large enough and the
+     * painter can be cloned, the items are drawn by worker threads on RECORDING_GALs,
+     * and the recorded drawings are added to the GAL cache by the calling thread.
+     */
+    void updateItemsGeometry( const ITEM_LAYER_LIST& aItems );
 
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
@@ -867,10 +908,22 @@ protected:
     /// Flag to reverse the draw order when using draw priority
     bool m_reverseDrawOrder;
 
+    /// Number of threads drawing the items in updateItemsGeometry(), 0 for one per core
+    unsigned m_updateThreadCount;
+
     /// A control for printing: m_printMode <= 0 means no printing mode (normal draw mode
     /// m_printMode > 0 is a printing mode (currently means "we are in printing mode")
     int m_printMode;
 
+    /// Views of the workers drawing screen tiles, given to the items drawing themselves
+    std::vector<std::unique_ptr<VIEW>> m_tileViews;
+
+    /// For the views drawing screen tiles, the view whose items are drawn
+    VIEW* m_tileParent;
+
+    /// Serializes the VIEW_ITEM::ViewDraw() calls made while drawing screen tiles
+    std::mutex m_viewDrawMutex;
+
     VIEW( const VIEW& ) = delete;
 };
 } // namespace KIGFX
@@ -41,24 +41,17 @@
 #include <convert_basic_shapes_to_polygon.h>
 #include <geometry/geometry_utils.h>
 
-// A helper struct for the callback function
-// These variables are parameters used in addTextSegmToPoly.
-// But addTextSegmToPoly is a call-back function,
-// so we cannot send them as arguments.
-struct TSEGM_2_POLY_PRMS {
-    int m_textWidth;
-    int m_error;
-    SHAPE_POLY_SET* m_cornerBuffer;
-};
-TSEGM_2_POLY_PRMS prms;
-
-// This is a call back function, used by GRText to draw the 3D text shape:
-static void addTextSegmToPoly( int x0, int y0, int xf, int yf, void* aData )
+// Convert the strokes of a text shape to polygons of width aTextWidth
+static void addTextShapeToPoly( SHAPE_POLY_SET& aCornerBuffer, const TEXT_SHAPE& aShape,
+                                int aTextWidth, int aError )
 {
-    TSEGM_2_POLY_PRMS* prm = static_cast<TSEGM_2_POLY_PRMS*>( aData );
-    TransformSegmentToPolygon( *prm->m_cornerBuffer,
-                               wxPoint( x0, y0 ), wxPoint( xf, yf ),
-                               prm->m_error, prm->m_textWidth );
+    const std::vector<wxPoint>& segments = aShape.m_Segments;
+
+    for( size_t ii = 0; ii + 1 < segments.size(); ii += 2 )
+    {
+        TransformSegmentToPolygon( aCornerBuffer, segments[ii], segments[ii+1], aError,
+                                   aTextWidth );
+    }
 }
 
 
@@ -226,21 +219,10 @@ void MODULE::TransformGraphicShapesWithClearanceToPolygonSet( PCB_LAYER_ID aLaye
     if( Value().GetLayer() == aLayer && Value().IsVisible() )
         texts.push_back( &Value() );
 
-    prms.m_cornerBuffer = &aCornerBuffer;
-
     for( TEXTE_MODULE* textmod : texts )
     {
-        prms.m_textWidth  = textmod->GetThickness() + ( 2 * aInflateValue );
-        prms.m_error = aError;
-        wxSize size = textmod->GetTextSize();
-
-        if( textmod->IsMirrored() )
-            size.x = -size.x;
-
-        GRText( NULL, textmod->GetTextPos(), BLACK, textmod->GetShownText(),
-                textmod->GetDrawRotation(), size, textmod->GetHorizJustify(),
-                textmod->GetVertJustify(), textmod->GetThickness(), textmod->IsItalic(),
-                true, addTextSegmToPoly, &prms );
+        addTextShapeToPoly( aCornerBuffer, *textmod->GetTextShape( textmod->GetDrawRotation() ),
+                            textmod->GetThickness() + ( 2 * aInflateValue ), aError );
     }
 
 }
@@ -282,21 +264,10 @@ void MODULE::TransformGraphicTextWithClearanceToPolygonSet( PCB_LAYER_ID aLayer,
     if( Value().GetLayer() == aLayer && Value().IsVisible() )
         texts.push_back( &Value() );
 
-    prms.m_cornerBuffer = &aCornerBuffer;
-
     for( TEXTE_MODULE* textmod : texts )
     {
-        prms.m_textWidth = textmod->GetThickness() + ( 2 * aInflateValue );
-        prms.m_error = aError;
-        wxSize size = textmod->GetTextSize();
-
-        if( textmod->IsMirrored() )
-            size.x = -size.x;
-
-        GRText( NULL, textmod->GetTextPos(), BLACK, textmod->GetShownText(),
-                textmod->GetDrawRotation(), size, textmod->GetHorizJustify(),
-                textmod->GetVertJustify(), textmod->GetThickness(), textmod->IsItalic(),
-                true, addTextSegmToPoly, &prms );
+        addTextShapeToPoly( aCornerBuffer, *textmod->GetTextShape( textmod->GetDrawRotation() ),
+                            textmod->GetThickness() + ( 2 * aInflateValue ), aError );
     }
 
 }
@@ -373,36 +344,8 @@ void EDA_TEXT::TransformBoundingBoxWithClearanceToPolygon( SHAPE_POLY_SET* aCorn
 void TEXTE_PCB::TransformShapeWithClearanceToPolygonSet( SHAPE_POLY_SET& aCornerBuffer,
                                                          int aClearanceValue, int aError ) const
 {
-    wxSize size = GetTextSize();
-
-    if( IsMirrored() )
-        size.x = -size.x;
-
-    prms.m_cornerBuffer = &aCornerBuffer;
-    prms.m_textWidth = GetThickness() + ( 2 * aClearanceValue );
-    prms.m_error = aError;
-    COLOR4D color = COLOR4D::BLACK;  // not actually used, but needed by GRText
-
-    if( IsMultilineAllowed() )
-    {
-        wxArrayString strings_list;
-        wxStringSplit( GetShownText(), strings_list, '\n' );
-        std::vector<wxPoint> positions;
-        positions.reserve( strings_list.Count() );
-        GetPositionsOfLinesOfMultilineText( positions, strings_list.Count() );
-
-        for( unsigned ii = 0; ii < strings_list.Count(); ii++ )
-        {
-            wxString txt = strings_list.Item( ii );
-            GRText( NULL, positions[ii], color, txt, GetTextAngle(), size, GetHorizJustify(),
-                    GetVertJustify(), GetThickness(), IsItalic(), true, addTextSegmToPoly, &prms );
-        }
-    }
-    else
-    {
-        GRText( NULL, GetTextPos(), color, GetShownText(), GetTextAngle(), size, GetHorizJustify(),
-                GetVertJustify(), GetThickness(), IsItalic(), true, addTextSegmToPoly, &prms );
-    }
+    addTextShapeToPoly( aCornerBuffer, *GetTextShape(), GetThickness() + ( 2 * aClearanceValue ),
+                        aError );
 }
 
 
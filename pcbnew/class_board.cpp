@@ -31,6 +31,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <fctsys.h>
 #include <common.h>
@@ -98,6 +99,9 @@ wxPoint BOARD_ITEM::ZeroOffset( 0, 0 );
 // so dummyColorsSettings provide this default initialization
 static PCB_GENERAL_SETTINGS dummyGeneralSettings( FRAME_PCB_EDITOR );
 
+/// The last revision given to a board, shared by all the boards so revisions are unique
+static std::atomic<unsigned long long> s_lastBoardRevision( 0 );
+
 BOARD::BOARD() :
     BOARD_ITEM_CONTAINER( (BOARD_ITEM*) NULL, PCB_T ),
         m_paper( PAGE_INFO::A4 ), m_NetInfo( this )
@@ -105,6 +109,8 @@ BOARD::BOARD() :
     // we have not loaded a board yet, assume latest until then.
     m_fileFormatVersionAtLoad = LEGACY_BOARD_FILE_VERSION;
 
+    IncrementRevision();
+
     m_generalSettings = &dummyGeneralSettings;
 
     m_CurrentZoneContour = NULL;            // This ZONE_CONTAINER handle the
@@ -173,6 +179,12 @@ BOARD::~BOARD()
 }
 
 
+void BOARD::IncrementRevision()
+{
+    m_revision = ++s_lastBoardRevision;
+}
+
+
 void BOARD::BuildConnectivity()
 {
     GetConnectivity()->Build( this );
@@ -189,6 +189,8 @@ private:
 
     int                     m_fileFormatVersionAtLoad;  ///< the version loaded from the file
 
+    unsigned long long      m_revision;                 ///< see GetRevision()
+
     std::shared_ptr<CONNECTIVITY_DATA>      m_connectivity;
 
     BOARD_DESIGN_SETTINGS   m_designSettings;
@@ -265,6 +267,21 @@ public:
     void SetFileFormatVersionAtLoad( int aVersion ) { m_fileFormatVersionAtLoad = aVersion; }
     int GetFileFormatVersionAtLoad()  const { return m_fileFormatVersionAtLoad; }
 
+    /**
+     * Function GetRevision
+     * returns a number identifying the current state of the board: it is never 0, and
+     * unique among all the boards of the process.  It changes when IncrementRevision()
+     * is called after a modification, so data built from the board (e.g. the 3D layers)
+     * can be kept until the board changes.
+     */
+    unsigned long long GetRevision() const { return m_revision; }
+
+    /**
+     * Function IncrementRevision
+     * gives a new revision to the board, to be called when it is modified.
+     */
+    void IncrementRevision();
+
     void Add( BOARD_ITEM* aItem, ADD_MODE aMode = ADD_INSERT ) override;
 
     void Remove( BOARD_ITEM* aBoardItem ) override;
@@ -42,8 +42,13 @@
 #include <polygon_test_point_inside.h>
 
 
+/// Max deviation of the filled polygons drawn at the first simplified level of detail
+static const int FILL_LOD_TOLERANCE = Millimeter2iu( 0.005 );
+
+
 ZONE_CONTAINER::ZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent, bool aInModule )
-        : BOARD_CONNECTED_ITEM( aParent, aInModule ? PCB_MODULE_ZONE_AREA_T : PCB_ZONE_AREA_T )
+        : BOARD_CONNECTED_ITEM( aParent, aInModule ? PCB_MODULE_ZONE_AREA_T : PCB_ZONE_AREA_T ),
+          m_filledPolysLOD( FILL_LOD_TOLERANCE )
 {
     m_CornerSelection = nullptr;                // no corner is selected
     m_IsFilled = false;                         // fill status : true when the zone is filled
@@ -74,7 +79,8 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent, bool aInModule )
 
 
 ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone )
-        : BOARD_CONNECTED_ITEM( aZone.GetParent(), PCB_ZONE_AREA_T )
+        : BOARD_CONNECTED_ITEM( aZone.GetParent(), PCB_ZONE_AREA_T ),
+          m_filledPolysLOD( FILL_LOD_TOLERANCE )
 {
     initDataFromSrcInCopyCtor( aZone );
 }
@@ -1167,6 +1173,20 @@ void ZONE_CONTAINER::SwapData( BOARD_ITEM* aImage )
 }
 
 
+const SHAPE_POLY_SET& ZONE_CONTAINER::GetFilledPolysListLOD( double aPixelSize,
+                                                             VECTOR2I& aOffset ) const
+{
+    return m_filledPolysLOD.Get( m_FilledPolysList, m_filledPolysLOD.Level( aPixelSize ),
+                                 aOffset );
+}
+
+
+int ZONE_CONTAINER::GetFillLODLevel( double aPixelSize )
+{
+    return POLYGON_LOD::Level( aPixelSize, FILL_LOD_TOLERANCE );
+}
+
+
 void ZONE_CONTAINER::CacheTriangulation()
 {
     m_FilledPolysList.CacheTriangulation();
@@ -36,6 +36,7 @@
 #include <board_connected_item.h>
 #include <layers_id_colors_and_visibility.h>
 #include <geometry/shape_poly_set.h>
+#include <geometry/polygon_lod.h>
 #include <zone_settings.h>
 
 
@@ -551,6 +552,21 @@ public:
         return m_FilledPolysList;
     }
 
+    /**
+     * Function GetFilledPolysListLOD
+     * returns the filled polygons simplified for drawing with pixels of aPixelSize
+     * (in internal units).  The outlines deviate by less than half a pixel.
+     * @param aOffset is set to the translation to apply to the returned polygons.
+     */
+    const SHAPE_POLY_SET& GetFilledPolysListLOD( double aPixelSize, VECTOR2I& aOffset ) const;
+
+    /**
+     * Function GetFillLODLevel
+     * returns the level of detail of the filled polygons drawn with pixels of aPixelSize.
+     * Zones must be redrawn when it changes.
+     */
+    static int GetFillLODLevel( double aPixelSize );
+
     /** (re)create a list of triangles that "fill" the solid areas.
      * used for instance to draw these solid areas on opengl
      */
@@ -803,6 +819,7 @@ protected:
     SHAPE_POLY_SET        m_RawPolysList;
     MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
+    mutable POLYGON_LOD   m_filledPolysLOD;     // Simplified filled areas, for drawing
 
     ZONE_HATCH_STYLE      m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
@@ -27,7 +27,11 @@
 #include <cmath>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <wx/dir.h>
 
@@ -50,6 +54,7 @@
 
 #include <convert_basic_shapes_to_polygon.h>
 #include <geometry/geometry_utils.h>
+#include <parallel_for.h>
 
 #include <zone_filler.h>
 
@@ -163,6 +168,9 @@ public:
 
     std::list< SGNODE* > m_components;
 
+    // DEF names of the model files already written as inline nodes
+    std::map< wxString, wxString > m_inlineModels;
+
     bool m_plainPCB;
 
     double m_minLineWidth;    // minimum width of a VRML line segment
@@ -419,144 +427,130 @@ static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
 }
 
 
+// a layer of the board output, with its color and position
+struct VRML_LAYER_OUTPUT
+{
+    VRML_LAYER*      layer;
+    VRML_COLOR_INDEX colorID;
+    bool             plane;      // a plane (e.g. copper) or a shell (the board, plated holes)
+    bool             top;        // the plane faces up
+    double           top_z;
+    double           bottom_z;   // for shells only
+};
+
+
 static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     const char* aFileName, OSTREAM* aOutputFile )
 {
-    // VRML_LAYER board;
-    aModel.m_board.Tesselate( &aModel.m_holes );
     double brdz = aModel.m_brd_thickness / 2.0
                   - ( Millimeter2iu( ART_OFFSET / 2.0 ) ) * BOARD_SCALE;
+    double artz = Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE;
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_PCB ),
-                            &aModel.m_board, false, false, brdz, -brdz );
-    }
-    else
-    {
-        create_vrml_shell( aModel.m_OutputPCB, VRML_COLOR_PCB, &aModel.m_board, brdz, -brdz );
-    }
+    std::vector< VRML_LAYER_OUTPUT > layers;
 
-    if( aModel.m_plainPCB )
-    {
-        if( !USE_INLINES )
-            S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(), USE_DEFS, true );
-
-        return;
-    }
-
-    // VRML_LAYER m_top_copper;
-    aModel.m_top_copper.Tesselate( &aModel.m_holes );
-
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TRACK ),
-                           &aModel.m_top_copper, true, true,
-                           aModel.GetLayerZ( F_Cu ), 0 );
-    }
-    else
-    {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TRACK, &aModel.m_top_copper,
-                           aModel.GetLayerZ( F_Cu ), true );
-    }
-
-    // VRML_LAYER m_top_tin;
-    aModel.m_top_tin.Tesselate( &aModel.m_holes );
+    // VRML_LAYER board;
+    layers.push_back( { &aModel.m_board, VRML_COLOR_PCB, false, false, brdz, -brdz } );
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
-                            &aModel.m_top_tin, true, true,
-                            aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                            0 );
-    }
-    else
+    if( !aModel.m_plainPCB )
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_top_tin,
-                           aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                           true );
-    }
-
-    // VRML_LAYER m_bot_copper;
-    aModel.m_bot_copper.Tesselate( &aModel.m_holes );
+        layers.push_back( { &aModel.m_top_copper, VRML_COLOR_TRACK, true, true,
+                            aModel.GetLayerZ( F_Cu ), 0 } );
+        layers.push_back( { &aModel.m_top_tin, VRML_COLOR_TIN, true, true,
+                            aModel.GetLayerZ( F_Cu ) + artz, 0 } );
+        layers.push_back( { &aModel.m_bot_copper, VRML_COLOR_TRACK, true, false,
+                            aModel.GetLayerZ( B_Cu ), 0 } );
+        layers.push_back( { &aModel.m_bot_tin, VRML_COLOR_TIN, true, false,
+                            aModel.GetLayerZ( B_Cu ) - artz, 0 } );
+        layers.push_back( { &aModel.m_plated_holes, VRML_COLOR_TIN, false, false,
+                            aModel.GetLayerZ( F_Cu ) + artz, aModel.GetLayerZ( B_Cu ) - artz } );
+        layers.push_back( { &aModel.m_top_silk, VRML_COLOR_SILK, true, true,
+                            aModel.GetLayerZ( F_SilkS ), 0 } );
+        layers.push_back( { &aModel.m_bot_silk, VRML_COLOR_SILK, true, false,
+                            aModel.GetLayerZ( B_SilkS ), 0 } );
+    }
+
+    // The layers are independent, so they are tesselated in parallel. Each one is written,
+    // in the order above, as soon as its future is ready, then released.
+    // Tesselating imports and renumbers the vertices of the holes, so each layer uses
+    // its own copy of them.
+    std::vector< std::unique_ptr< VRML_LAYER > > holes( layers.size() );
+    std::vector< std::promise<void> > tesselated( layers.size() );
+    std::vector< std::future<void> > ready;
+
+    for( std::promise<void>& layerDone : tesselated )
+        ready.push_back( layerDone.get_future() );
+
+    std::thread tesselator( [&]()
+    {
+        ParallelFor( layers.size(), [&]( size_t i )
+        {
+            try
+            {
+                // the plated holes are tesselated alone
+                if( layers[i].layer == &aModel.m_plated_holes )
+                {
+                    layers[i].layer->Tesselate( NULL, true );
+                }
+                else
+                {
+                    holes[i].reset( new VRML_LAYER );
+                    holes[i]->AppendLayer( aModel.m_holes );
+                    layers[i].layer->Tesselate( holes[i].get() );
+                }
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TRACK ),
-                            &aModel.m_bot_copper, true, false,
-                            aModel.GetLayerZ( B_Cu ), 0 );
-    }
-    else
-    {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TRACK, &aModel.m_bot_copper,
-                           aModel.GetLayerZ( B_Cu ), false );
-    }
+                tesselated[i].set_value();
+            }
+            catch( ... )
+            {
+                tesselated[i].set_exception( std::current_exception() );
+            }
+        } );
+    } );
 
-    // VRML_LAYER m_bot_tin;
-    aModel.m_bot_tin.Tesselate( &aModel.m_holes );
+    // the threads use the layers until they are all done, so an error is only
+    // reported after that
+    std::exception_ptr error;
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
-                            &aModel.m_bot_tin, true, false,
-                            aModel.GetLayerZ( B_Cu )
-                            - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                            0 );
-    }
-    else
+    for( size_t i = 0; i < layers.size(); ++i )
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_bot_tin,
-                           aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                           false );
-    }
+        const VRML_LAYER_OUTPUT& out = layers[i];
 
-    // VRML_LAYER PTH;
-    aModel.m_plated_holes.Tesselate( NULL, true );
-
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
-                            &aModel.m_plated_holes, false, false,
-                            aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                            aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE );
-    }
-    else
-    {
-        create_vrml_shell( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_plated_holes,
-                           aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                           aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE );
-    }
+        try
+        {
+            // waits for the layer, and rethrows an error of its tesselation
+            ready[i].get();
 
-    // VRML_LAYER m_top_silk;
-    aModel.m_top_silk.Tesselate( &aModel.m_holes );
+            if( !error )
+            {
+                if( USE_INLINES )
+                    write_triangle_bag( *aOutputFile, aModel.GetColor( out.colorID ), out.layer,
+                                        out.plane, out.top, out.top_z, out.bottom_z );
+                else if( out.plane )
+                    create_vrml_plane( aModel.m_OutputPCB, out.colorID, out.layer, out.top_z,
+                                       out.top );
+                else
+                    create_vrml_shell( aModel.m_OutputPCB, out.colorID, out.layer, out.top_z,
+                                       out.bottom_z );
+            }
+        }
+        catch( ... )
+        {
+            if( !error )
+                error = std::current_exception();
+        }
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_SILK ), &aModel.m_top_silk,
-                            true, true, aModel.GetLayerZ( F_SilkS ), 0 );
-    }
-    else
-    {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_SILK, &aModel.m_top_silk,
-                           aModel.GetLayerZ( F_SilkS ), true );
+        // the output (or the scenegraph) has all it needs from the layer
+        out.layer->Clear();
+        holes[i].reset();
     }
 
-    // VRML_LAYER m_bot_silk;
-    aModel.m_bot_silk.Tesselate( &aModel.m_holes );
+    tesselator.join();
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_SILK ), &aModel.m_bot_silk,
-                            true, false, aModel.GetLayerZ( B_SilkS ), 0 );
-    }
-    else
-    {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_SILK, &aModel.m_bot_silk,
-                           aModel.GetLayerZ( B_SilkS ), false );
-    }
+    if( error )
+        std::rethrow_exception( error );
 
     if( !USE_INLINES )
-        S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(), true, true );
+        S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(), USE_DEFS, true );
 }
 
 
@@ -1438,36 +1432,55 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             dstFile.SetName( srcFile.GetName() );
             dstFile.SetExt( "wrl"  );
 
-            // copy the file if necessary
-            wxDateTime srcModTime = srcFile.GetModificationTime();
-            wxDateTime destModTime = srcModTime;
-
-            destModTime.SetToCurrent();
-
-            if( dstFile.FileExists() )
-                destModTime = dstFile.GetModificationTime();
+            // the file is copied and written with a DEF name for its first placement,
+            // the others only USE it
+            auto inlined = aModel.m_inlineModels.find( dstFile.GetFullPath() );
+            bool firstUse = inlined == aModel.m_inlineModels.end();
+            wxString defName;
 
-            if( srcModTime != destModTime )
+            if( firstUse )
             {
-                wxLogDebug( "Copying 3D model %s to %s.",
-                            GetChars( srcFile.GetFullPath() ),
-                            GetChars( dstFile.GetFullPath() ) );
+                // copy the file if necessary
+                wxDateTime srcModTime = srcFile.GetModificationTime();
+                wxDateTime destModTime = srcModTime;
 
-                wxString fileExt = srcFile.GetExt();
-                fileExt.LowerCase();
+                destModTime.SetToCurrent();
 
-                // copy VRML models and use the scenegraph library to
-                // translate other model types
-                if( fileExt == "wrl" )
-                {
-                    if( !wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() ) )
-                        continue;
-                }
-                else
+                if( dstFile.FileExists() )
+                    destModTime = dstFile.GetModificationTime();
+
+                if( srcModTime != destModTime )
                 {
-                    if( !S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d, USE_DEFS, true ) )
+                    wxLogDebug( "Copying 3D model %s to %s.",
+                                GetChars( srcFile.GetFullPath() ),
+                                GetChars( dstFile.GetFullPath() ) );
+
+                    wxString fileExt = srcFile.GetExt();
+                    fileExt.LowerCase();
+
+                    // copy VRML models and use the scenegraph library to
+                    // translate other model types
+                    bool copied;
+
+                    if( fileExt == "wrl" )
+                        copied = wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() );
+                    else
+                        copied = S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d,
+                                                 USE_DEFS, true );
+
+                    if( !copied )
+                    {
+                        ++sM;
                         continue;
+                    }
                 }
+
+                defName.Printf( "MODEL_%u", (unsigned) aModel.m_inlineModels.size() );
+                aModel.m_inlineModels[ dstFile.GetFullPath() ] = defName;
+            }
+            else
+            {
+                defName = inlined->second;
             }
 
             (*aOutputFile) << "Transform {\n";
@@ -1489,20 +1502,29 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             (*aOutputFile) << sM->m_Scale.y << " ";
             (*aOutputFile) << sM->m_Scale.z << "\n";
 
-            (*aOutputFile) << "  children [\n    Inline {\n      url \"";
+            if( firstUse )
+            {
+                (*aOutputFile) << "  children [\n    DEF " << TO_UTF8( defName );
+                (*aOutputFile) << " Inline {\n      url \"";
+
+                if( USE_RELPATH )
+                {
+                    wxFileName tmp = dstFile;
+                    tmp.SetExt( "" );
+                    tmp.SetName( "" );
+                    tmp.RemoveLastDir();
+                    dstFile.MakeRelativeTo( tmp.GetPath() );
+                }
 
-            if( USE_RELPATH )
+                wxString fn = dstFile.GetFullPath();
+                fn.Replace( "\\", "/" );
+                (*aOutputFile) << TO_UTF8( fn ) << "\"\n    } ]\n";
+            }
+            else
             {
-                wxFileName tmp = dstFile;
-                tmp.SetExt( "" );
-                tmp.SetName( "" );
-                tmp.RemoveLastDir();
-                dstFile.MakeRelativeTo( tmp.GetPath() );
+                (*aOutputFile) << "  children [\n    USE " << TO_UTF8( defName ) << " ]\n";
             }
 
-            wxString fn = dstFile.GetFullPath();
-            fn.Replace( "\\", "/" );
-            (*aOutputFile) << TO_UTF8( fn ) << "\"\n    } ]\n";
             (*aOutputFile) << "  }\n";
         }
         else
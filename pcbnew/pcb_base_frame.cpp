@@ -105,6 +105,7 @@ PCB_BASE_FRAME::~PCB_BASE_FRAME()
     // Ensure m_canvasType is up to date, to save it in config
     m_canvasType = GetCanvas()->GetBackend();
 
+    CINFO3D_VISU::ReleaseParkedLayers( m_Pcb );
     delete m_Pcb;
 }
 
@@ -117,6 +118,10 @@ EDA_3D_VIEWER* PCB_BASE_FRAME::Get3DViewerFrame()
 
 void PCB_BASE_FRAME::Update3DView( bool aForceReload, const wxString* aTitle )
 {
+    // The board was changed, e.g. a footprint loaded, even if there is no viewer to show it
+    GetBoard()->IncrementRevision();
+    CINFO3D_VISU::ReleaseParkedLayers( GetBoard() );
+
     EDA_3D_VIEWER* draw3DFrame = Get3DViewerFrame();
 
     if( draw3DFrame )
@@ -169,6 +174,7 @@ void PCB_BASE_FRAME::SetBoard( BOARD* aBoard )
 {
     if( m_Pcb != aBoard )
     {
+        CINFO3D_VISU::ReleaseParkedLayers( m_Pcb );
         delete m_Pcb;
         m_Pcb = aBoard;
         m_Pcb->SetGeneralSettings( &Settings() );
@@ -758,6 +764,9 @@ void PCB_BASE_FRAME::OnModify()
     GetScreen()->SetModify();
     GetScreen()->SetSave();
 
+    GetBoard()->IncrementRevision();
+    CINFO3D_VISU::ReleaseParkedLayers( GetBoard() );
+
     UpdateStatusBar();
     UpdateMsgPanel();
 }
@@ -301,6 +301,14 @@ PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
 }
 
 
+PAINTER* PCB_PAINTER::Clone( GAL* aGal )
+{
+    PCB_PAINTER* painter = new PCB_PAINTER( aGal );
+    painter->ApplySettings( &m_pcbSettings );
+    return painter;
+}
+
+
 int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 {
     // if items have 0 thickness, draw them with the outline
@@ -1086,11 +1094,14 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone, int aLayer )
     // Draw the filling
     if( displayMode != PCB_RENDER_SETTINGS::DZ_HIDE_FILLED )
     {
-        const SHAPE_POLY_SET& polySet = aZone->GetFilledPolysList();
-
-        if( polySet.OutlineCount() == 0 )  // Nothing to draw
+        if( aZone->GetFilledPolysList().OutlineCount() == 0 )  // Nothing to draw
             return;
 
+        // Large fills are drawn with less vertices when zoomed out
+        VECTOR2I offset;
+        const SHAPE_POLY_SET& polySet = aZone->GetFilledPolysListLOD(
+                1.0 / m_gal->GetWorldScale(), offset );
+
         // Set up drawing options
         int outline_thickness = aZone->GetFilledPolysUseThickness() ? aZone->GetMinThickness() : 0;
         m_gal->SetStrokeColor( color );
@@ -1108,7 +1119,17 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone, int aLayer )
             m_gal->SetIsStroke( true );
         }
 
-        m_gal->DrawPolygon( polySet );
+        if( offset != VECTOR2I( 0, 0 ) )
+        {
+            m_gal->Save();
+            m_gal->Translate( offset );
+            m_gal->DrawPolygon( polySet );
+            m_gal->Restore();
+        }
+        else
+        {
+            m_gal->DrawPolygon( polySet );
+        }
     }
 
 }
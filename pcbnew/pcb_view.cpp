@@ -32,10 +32,72 @@ using namespace std::placeholders;
 #include <pcb_painter.h>
 
 #include <class_module.h>
+#include <class_zone.h>
+#include <layers_id_colors_and_visibility.h>
 
 namespace KIGFX {
+
+static const LAYER_NUM GAL_LAYER_ORDER[] =
+{
+    LAYER_GP_OVERLAY,
+    LAYER_SELECT_OVERLAY,
+    LAYER_DRC,
+    LAYER_PADS_NETNAMES, LAYER_VIAS_NETNAMES,
+    Dwgs_User, Cmts_User, Eco1_User, Eco2_User, Edge_Cuts,
+
+    LAYER_MOD_TEXT_FR,
+    LAYER_MOD_REFERENCES, LAYER_MOD_VALUES,
+
+    LAYER_RATSNEST, LAYER_ANCHOR,
+    LAYER_VIAS_HOLES, LAYER_PADS_PLATEDHOLES, LAYER_NON_PLATEDHOLES,
+    LAYER_VIA_THROUGH, LAYER_VIA_BBLIND,
+    LAYER_VIA_MICROVIA, LAYER_PADS_TH,
+
+    LAYER_PAD_FR_NETNAMES, LAYER_PAD_FR,
+    NETNAMES_LAYER_INDEX( F_Cu ), F_Cu, F_Mask, F_SilkS, F_Paste, F_Adhes, F_CrtYd, F_Fab,
+
+    NETNAMES_LAYER_INDEX( In1_Cu ),   In1_Cu,
+    NETNAMES_LAYER_INDEX( In2_Cu ),   In2_Cu,
+    NETNAMES_LAYER_INDEX( In3_Cu ),   In3_Cu,
+    NETNAMES_LAYER_INDEX( In4_Cu ),   In4_Cu,
+    NETNAMES_LAYER_INDEX( In5_Cu ),   In5_Cu,
+    NETNAMES_LAYER_INDEX( In6_Cu ),   In6_Cu,
+    NETNAMES_LAYER_INDEX( In7_Cu ),   In7_Cu,
+    NETNAMES_LAYER_INDEX( In8_Cu ),   In8_Cu,
+    NETNAMES_LAYER_INDEX( In9_Cu ),   In9_Cu,
+    NETNAMES_LAYER_INDEX( In10_Cu ),  In10_Cu,
+    NETNAMES_LAYER_INDEX( In11_Cu ),  In11_Cu,
+    NETNAMES_LAYER_INDEX( In12_Cu ),  In12_Cu,
+    NETNAMES_LAYER_INDEX( In13_Cu ),  In13_Cu,
+    NETNAMES_LAYER_INDEX( In14_Cu ),  In14_Cu,
+    NETNAMES_LAYER_INDEX( In15_Cu ),  In15_Cu,
+    NETNAMES_LAYER_INDEX( In16_Cu ),  In16_Cu,
+    NETNAMES_LAYER_INDEX( In17_Cu ),  In17_Cu,
+    NETNAMES_LAYER_INDEX( In18_Cu ),  In18_Cu,
+    NETNAMES_LAYER_INDEX( In19_Cu ),  In19_Cu,
+    NETNAMES_LAYER_INDEX( In20_Cu ),  In20_Cu,
+    NETNAMES_LAYER_INDEX( In21_Cu ),  In21_Cu,
+    NETNAMES_LAYER_INDEX( In22_Cu ),  In22_Cu,
+    NETNAMES_LAYER_INDEX( In23_Cu ),  In23_Cu,
+    NETNAMES_LAYER_INDEX( In24_Cu ),  In24_Cu,
+    NETNAMES_LAYER_INDEX( In25_Cu ),  In25_Cu,
+    NETNAMES_LAYER_INDEX( In26_Cu ),  In26_Cu,
+    NETNAMES_LAYER_INDEX( In27_Cu ),  In27_Cu,
+    NETNAMES_LAYER_INDEX( In28_Cu ),  In28_Cu,
+    NETNAMES_LAYER_INDEX( In29_Cu ),  In29_Cu,
+    NETNAMES_LAYER_INDEX( In30_Cu ),  In30_Cu,
+
+    LAYER_PAD_BK_NETNAMES, LAYER_PAD_BK,
+    NETNAMES_LAYER_INDEX( B_Cu ), B_Cu, B_Mask, B_Adhes, B_Paste, B_SilkS, B_CrtYd, B_Fab,
+
+    LAYER_MOD_TEXT_BK,
+    LAYER_WORKSHEET
+};
+
+
 PCB_VIEW::PCB_VIEW( bool aIsDynamic ) :
-    VIEW( aIsDynamic )
+    VIEW( aIsDynamic ),
+    m_zoneFillLOD( -1 )
 {
     // Set m_boundary to define the max area size. The default value
     // is acceptable for Pcbnew and Gerbview.
@@ -110,6 +172,91 @@ void PCB_VIEW::Update( KIGFX::VIEW_ITEM* aItem )
 }
 
 
+void PCB_VIEW::SetScale( double aScale, VECTOR2D aAnchor )
+{
+    VIEW::SetScale( aScale, aAnchor );
+
+    // Zone fills are cached with the vertices needed at the current scale: redraw them
+    // when the level of detail changes
+    int lod = ZONE_CONTAINER::GetFillLODLevel( 1.0 / GetGAL()->GetWorldScale() );
+
+    if( lod != m_zoneFillLOD )
+    {
+        UpdateAllItemsConditionally( KIGFX::GEOMETRY, []( VIEW_ITEM* aItem ) -> bool
+                {
+                    return dynamic_cast<ZONE_CONTAINER*>( aItem ) != nullptr;
+                } );
+
+        m_zoneFillLOD = lod;
+    }
+}
+
+
+void PCB_VIEW::SetDefaultLayerOrder()
+{
+    for( LAYER_NUM i = 0; (unsigned) i < sizeof( GAL_LAYER_ORDER ) / sizeof( LAYER_NUM ); ++i )
+    {
+        LAYER_NUM layer = GAL_LAYER_ORDER[i];
+        wxASSERT( layer < VIEW_MAX_LAYERS );
+
+        SetLayerOrder( layer, i );
+    }
+}
+
+
+void PCB_VIEW::SetDefaultLayerDeps( bool aCached )
+{
+    auto target = aCached ? TARGET_CACHED : TARGET_NONCACHED;
+
+    for( int i = 0; i < VIEW_MAX_LAYERS; i++ )
+        SetLayerTarget( i, target );
+
+    for( LAYER_NUM i = 0; (unsigned) i < sizeof( GAL_LAYER_ORDER ) / sizeof( LAYER_NUM ); ++i )
+    {
+        LAYER_NUM layer = GAL_LAYER_ORDER[i];
+        wxASSERT( layer < VIEW_MAX_LAYERS );
+
+        // Set layer display dependencies & targets
+        if( IsCopperLayer( layer ) )
+            SetRequired( GetNetnameLayer( layer ), layer );
+        else if( IsNetnameLayer( layer ) )
+            SetLayerDisplayOnly( layer );
+    }
+
+    SetLayerTarget( LAYER_ANCHOR, TARGET_NONCACHED );
+    SetLayerDisplayOnly( LAYER_ANCHOR );
+
+    // Some more required layers settings
+    SetRequired( LAYER_VIAS_HOLES, LAYER_VIA_THROUGH );
+    SetRequired( LAYER_VIAS_NETNAMES, LAYER_VIA_THROUGH );
+    SetRequired( LAYER_PADS_PLATEDHOLES, LAYER_PADS_TH );
+    SetRequired( LAYER_NON_PLATEDHOLES, LAYER_PADS_TH );
+    SetRequired( LAYER_PADS_NETNAMES, LAYER_PADS_TH );
+
+    // Front modules
+    SetRequired( LAYER_PAD_FR, F_Cu );
+    SetRequired( LAYER_MOD_TEXT_FR, LAYER_MOD_FR );
+    SetRequired( LAYER_PAD_FR_NETNAMES, LAYER_PAD_FR );
+
+    // Back modules
+    SetRequired( LAYER_PAD_BK, B_Cu );
+    SetRequired( LAYER_MOD_TEXT_BK, LAYER_MOD_BK );
+    SetRequired( LAYER_PAD_BK_NETNAMES, LAYER_PAD_BK );
+
+    SetLayerTarget( LAYER_SELECT_OVERLAY , TARGET_OVERLAY );
+    SetLayerDisplayOnly( LAYER_SELECT_OVERLAY ) ;
+    SetLayerTarget( LAYER_GP_OVERLAY , TARGET_OVERLAY );
+    SetLayerDisplayOnly( LAYER_GP_OVERLAY ) ;
+    SetLayerTarget( LAYER_RATSNEST, TARGET_OVERLAY );
+    SetLayerDisplayOnly( LAYER_RATSNEST );
+
+    SetLayerTarget( LAYER_WORKSHEET, TARGET_NONCACHED );
+    SetLayerDisplayOnly( LAYER_WORKSHEET ) ;
+    SetLayerDisplayOnly( LAYER_GRID );
+    SetLayerDisplayOnly( LAYER_DRC );
+}
+
+
 void PCB_VIEW::UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions )
 {
     auto    painter     = static_cast<KIGFX::PCB_PAINTER*>( GetPainter() );
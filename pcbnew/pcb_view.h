@@ -51,7 +51,25 @@ public:
     /// @copydoc VIEW::Update()
     virtual void Update( VIEW_ITEM* aItem ) override;
 
+    /// @copydoc VIEW::SetScale()
+    virtual void SetScale( double aScale, VECTOR2D aAnchor = { 0, 0 } ) override;
+
     void UpdateDisplayOptions( const PCB_DISPLAY_OPTIONS& aOptions );
+
+    ///> Sets the layer order used by the board editors
+    void SetDefaultLayerOrder();
+
+    /**
+     * Function SetDefaultLayerDeps()
+     * Sets the rendering targets and the dependencies of the board layers.
+     * @param aCached tells if the layers are drawn from GAL groups.  Caching makes
+     * no sense for Cairo and other software renderers.
+     */
+    void SetDefaultLayerDeps( bool aCached );
+
+private:
+    ///> Level of detail of the zone fills drawn at the current scale
+    int m_zoneFillLOD;
 };
 
 }
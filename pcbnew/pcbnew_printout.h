@@ -97,6 +97,8 @@ public:
         m_drillMarkSize = aSize;
     }
 
+    PAINTER* Clone( GAL* aGal ) override;
+
 protected:
     int getDrillShape( const D_PAD* aPad ) const override;
 
@@ -29,6 +29,7 @@
 #ifndef PCBPLOT_H_
 #define PCBPLOT_H_
 
+#include <vector>
 #include <wx/filename.h>
 #include <pad_shapes.h>
 #include <pcb_plot_params.h>
@@ -170,6 +171,40 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
                          const wxString& aFullFileName,
                          const wxString& aSheetDesc );
 
+/**
+ * A layer to plot by PlotBoardLayers()
+ */
+struct PLOT_LAYER_JOB
+{
+    PCB_LAYER_ID m_Layer;           ///< the layer to plot
+    wxString     m_FileName;        ///< the full name of the plot file
+    bool         m_Success = false; ///< set by PlotBoardLayers(): the plot file is created
+    double       m_PlotTime = 0.0;  ///< set by PlotBoardLayers(): plot time in ms
+
+    PLOT_LAYER_JOB( PCB_LAYER_ID aLayer, const wxString& aFileName ) :
+        m_Layer( aLayer ),
+        m_FileName( aFileName )
+    {}
+};
+
+/**
+ * Function PlotBoardLayers
+ * plots a set of layers, each one in its own file.
+ * Layers are plotted by several threads, each one using its own plotter, and the
+ * files are the same as the files created by StartPlotBoard() and PlotOneBoardLayer()
+ * for each layer.
+ * Stroke texts are all drawn by the shared basic_gal, which is locked by basic_gal_mutex,
+ * so the texts of the layers are plotted one thread at a time.
+ * @param aBoard = the board to plot
+ * @param aPlotOpts = the plot options
+ * @param aJobs = the layers to plot and their file names.  The result and the plot
+ *                time of each layer are stored in each job
+ * @param aThreadCount = the max number of threads to use, 0 to use one thread by core
+ * @return the number of plot files successfully created
+ */
+int PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                     std::vector<PLOT_LAYER_JOB>& aJobs, unsigned aThreadCount = 0 );
+
 /**
  * Function PlotOneBoardLayer
  * main function to plot one copper or technical layer.
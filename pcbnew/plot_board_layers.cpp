@@ -29,6 +29,10 @@
  */
 
 
+#include <atomic>
+#include <memory>
+#include <thread>
+
 #include <fctsys.h>
 #include <common.h>
 #include <plotter.h>
@@ -52,6 +56,7 @@
 #include <pcbnew.h>
 #include <pcbplot.h>
 #include <gbr_metadata.h>
+#include <profile.h>
 
 /*
  * Plot a solder mask layer.  Solder mask layers have a minimum thickness value and cannot be
@@ -356,6 +361,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             extraSize.x += width_adj;
             extraSize.y += width_adj;
             wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
+            wxSize padPlotsDelta = deltaSize;
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -388,7 +394,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                padPlotsDelta = delta;
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -405,30 +411,39 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aBoard->Colors().GetItemColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
+            // Plot the pad with the required plot size.  The board pad itself is never
+            // modified, because several layers can be plotted at the same time
+            // (see PlotBoardLayers()), so use a resized copy when needed.
+            D_PAD* plotPad = pad;
+            std::unique_ptr<D_PAD> resizedPad;
+
+            if( pad->GetShape() != PAD_SHAPE_CUSTOM
+                    && ( padPlotsSize != pad->GetSize() || padPlotsDelta != deltaSize ) )
+            {
+                resizedPad.reset( new D_PAD( *pad ) );
+                resizedPad->SetSize( padPlotsSize );
+                resizedPad->SetDelta( padPlotsDelta );
+                plotPad = resizedPad.get();
+            }
 
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
-
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
                     ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
+                    ( plotPad->GetSize() == pad->GetDrillSize() ) &&
                     ( pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
                     break;
 
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( plotPad, color, plotMode );
                 break;
 
             case PAD_SHAPE_TRAPEZOID:
             case PAD_SHAPE_RECT:
             case PAD_SHAPE_ROUNDRECT:
             case PAD_SHAPE_CHAMFERED_RECT:
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( plotPad, color, plotMode );
                 break;
 
             case PAD_SHAPE_CUSTOM:
@@ -457,9 +472,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             }
                 break;
             }
-
-            pad->SetSize( tmppadsize );     // Restore the pad size
-            pad->SetDelta( deltaSize );
         }
 
         aPlotter->EndBlock( NULL );
@@ -1136,3 +1148,78 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts, int aLayer,
     delete plotter;
     return NULL;
 }
+
+
+int PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                     std::vector<PLOT_LAYER_JOB>& aJobs, unsigned aThreadCount )
+{
+    LOCALE_IO toggle;   // held for all the worker threads
+
+    // Open the plot files and write their headers (and the worksheet).  This is fast,
+    // so it is done here, in the layers order.
+    std::vector<PLOTTER*> plotters( aJobs.size(), nullptr );
+
+    for( size_t ii = 0; ii < aJobs.size(); ++ii )
+    {
+        PROF_COUNTER timer;
+
+        plotters[ii] = StartPlotBoard( aBoard, aPlotOpts, aJobs[ii].m_Layer,
+                                       aJobs[ii].m_FileName, wxEmptyString );
+        aJobs[ii].m_Success = plotters[ii] != nullptr;
+        aJobs[ii].m_PlotTime = timer.msecs();
+    }
+
+    // D_PAD::GetBoundingRadius() caches its value: build the cache before sharing the pads
+    // between threads
+    for( auto module : aBoard->Modules() )
+    {
+        for( auto pad : module->Pads() )
+            pad->GetBoundingRadius();
+    }
+
+    // Plot the layers.  Each layer has its own plotter and its own file, and the board
+    // is not modified when plotting, so layers can be plotted in parallel.
+    std::atomic<size_t> nextJob( 0 );
+
+    auto plotLayers = [&]()
+    {
+        for( size_t ii = nextJob++; ii < aJobs.size(); ii = nextJob++ )
+        {
+            if( !plotters[ii] )
+                continue;
+
+            PROF_COUNTER timer;
+
+            PlotOneBoardLayer( aBoard, plotters[ii], aJobs[ii].m_Layer, *aPlotOpts );
+            plotters[ii]->EndPlot();
+            delete plotters[ii];
+
+            aJobs[ii].m_PlotTime += timer.msecs();
+        }
+    };
+
+    if( aThreadCount == 0 )
+        aThreadCount = std::max<unsigned>( std::thread::hardware_concurrency(), 1 );
+
+    aThreadCount = std::min<unsigned>( aThreadCount, aJobs.size() );
+
+    std::vector<std::thread> threads;
+
+    for( unsigned ii = 1; ii < aThreadCount; ++ii )
+        threads.emplace_back( plotLayers );
+
+    plotLayers();   // this thread is also a worker
+
+    for( auto& thread : threads )
+        thread.join();
+
+    int count = 0;
+
+    for( const auto& job : aJobs )
+    {
+        if( job.m_Success )
+            count++;
+    }
+
+    return count;
+}
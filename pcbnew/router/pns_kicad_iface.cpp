@@ -912,9 +912,8 @@ bool PNS_KICAD_IFACE::syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYE
         return false;
 
     int textWidth = aText->GetThickness();
-    std::vector<wxPoint> textShape;
-
-    aText->TransformTextShapeToSegmentList( textShape );
+    std::shared_ptr<const TEXT_SHAPE> shape = aText->GetTextShape();
+    const std::vector<wxPoint>& textShape = shape->m_Segments;
 
     if( textShape.size() < 2 )
         return false;
@@ -1083,16 +1083,16 @@ void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
     if( text == nullptr )
         return;
 
-    std::vector<wxPoint> textShape;      // a buffer to store the text shape (set of segments)
+    // the text shape (set of segments), cached by the text item
+    std::shared_ptr<const TEXT_SHAPE> shape = text->GetTextShape();
+    const std::vector<wxPoint>& textShape = shape->m_Segments;
     int textWidth = text->GetThickness();
 
-    // So far the bounding box makes up the text-area
-    text->TransformTextShapeToSegmentList( textShape );
-
     if( textShape.size() == 0 )     // Should not happen (empty text?)
         return;
 
-    EDA_RECT bbox = text->GetTextBox();
+    // So far the bounding box of the strokes makes up the text-area
+    const EDA_RECT& bbox = shape->m_BoundingBox;
     SHAPE_RECT rect_area( bbox.GetX(), bbox.GetY(), bbox.GetWidth(), bbox.GetHeight() );
 
     // Test tracks and vias
@@ -0,0 +1,182 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <common.h>
+
+#include <geometry/polygon_lod.h>
+
+#include <cmath>
+
+
+// All the values are in internal units, 5 um and 10 mm in Pcbnew
+static const int BASE_TOLERANCE = 5000;
+
+
+static SHAPE_LINE_CHAIN makeCircle( int aRadius, int aPointCount )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int ii = 0; ii < aPointCount; ++ii )
+    {
+        double angle = 2 * M_PI * ii / aPointCount;
+        chain.Append( KiROUND( aRadius * cos( angle ) ), KiROUND( aRadius * sin( angle ) ) );
+    }
+
+    chain.SetClosed( true );
+    return chain;
+}
+
+
+/**
+ * Area of the material of a polygon set, holes excluded.
+ */
+static double netArea( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aSet.CPolygon( ii );
+        area += std::abs( poly[0].Area() );
+
+        for( size_t jj = 1; jj < poly.size(); ++jj )
+            area -= std::abs( poly[jj].Area() );
+    }
+
+    return area;
+}
+
+
+/**
+ * An annulus with fine outlines, as zone fills around a round pad
+ */
+struct POLYGON_LOD_FIXTURE
+{
+    POLYGON_LOD_FIXTURE() :
+        m_lod( BASE_TOLERANCE )
+    {
+        m_source.AddOutline( makeCircle( OUTER_RADIUS, 2000 ) );
+        m_source.AddHole( makeCircle( INNER_RADIUS, 1000 ) );
+    }
+
+    static const int OUTER_RADIUS = 10000000;
+    static const int INNER_RADIUS = 5000000;
+
+    SHAPE_POLY_SET m_source;
+    POLYGON_LOD    m_lod;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PolygonLOD, POLYGON_LOD_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( LevelFromPixelSize )
+{
+    BOOST_CHECK_EQUAL( POLYGON_LOD::Level( 0.0, BASE_TOLERANCE ), 0 );
+    BOOST_CHECK_EQUAL( POLYGON_LOD::Level( 2 * BASE_TOLERANCE - 1, BASE_TOLERANCE ), 0 );
+    BOOST_CHECK_EQUAL( POLYGON_LOD::Level( 2 * BASE_TOLERANCE, BASE_TOLERANCE ), 1 );
+    BOOST_CHECK_EQUAL( POLYGON_LOD::Level( 8 * BASE_TOLERANCE, BASE_TOLERANCE ), 3 );
+    BOOST_CHECK_EQUAL( POLYGON_LOD::Level( 1e12, BASE_TOLERANCE ), POLYGON_LOD::LEVEL_COUNT - 1 );
+}
+
+
+/**
+ * The vertex count drops with the level, while the shape stays within the tolerance
+ */
+BOOST_AUTO_TEST_CASE( Simplification )
+{
+    VECTOR2I offset;
+
+    BOOST_CHECK_EQUAL( &m_lod.Get( m_source, 0, offset ), &m_source );
+
+    int lastCount = m_source.TotalVertices();
+    double sourceArea = netArea( m_source );
+    double perimeter = 2 * M_PI * ( OUTER_RADIUS + INNER_RADIUS );
+
+    for( int level = 1; level < POLYGON_LOD::LEVEL_COUNT; ++level )
+    {
+        BOOST_TEST_CONTEXT( "Level " << level )
+        {
+            const SHAPE_POLY_SET& simplified = m_lod.Get( m_source, level, offset );
+            int tolerance = BASE_TOLERANCE << ( level - 1 );
+
+            BOOST_CHECK_EQUAL( offset, VECTOR2I( 0, 0 ) );
+            BOOST_CHECK( simplified.TotalVertices() <= lastCount );
+            BOOST_CHECK( std::abs( netArea( simplified ) - sourceArea ) <= perimeter * tolerance );
+
+            if( &simplified != &m_source )
+            {
+                BOOST_CHECK( !simplified.HasHoles() );
+                BOOST_CHECK( simplified.IsTriangulationUpToDate() );
+            }
+
+            lastCount = simplified.TotalVertices();
+        }
+    }
+
+    BOOST_CHECK( lastCount < m_source.TotalVertices() / 10 );
+}
+
+
+/**
+ * The levels are kept when the source is moved, and rebuilt when its shape changes
+ */
+BOOST_AUTO_TEST_CASE( SourceChanges )
+{
+    VECTOR2I offset;
+    const SHAPE_POLY_SET& simplified = m_lod.Get( m_source, 5, offset );
+    int count = simplified.TotalVertices();
+
+    BOOST_REQUIRE( &simplified != &m_source );
+
+    m_source.Move( VECTOR2I( 1000, -2000 ) );
+
+    BOOST_CHECK_EQUAL( &m_lod.Get( m_source, 5, offset ), &simplified );
+    BOOST_CHECK_EQUAL( offset, VECTOR2I( 1000, -2000 ) );
+    BOOST_CHECK_EQUAL( simplified.TotalVertices(), count );
+
+    m_source.AddOutline( makeCircle( INNER_RADIUS / 2, 1000 ) );
+
+    const SHAPE_POLY_SET& rebuilt = m_lod.Get( m_source, 5, offset );
+    BOOST_CHECK_EQUAL( offset, VECTOR2I( 0, 0 ) );
+    BOOST_CHECK( rebuilt.TotalVertices() > count );
+}
+
+
+/**
+ * Small polygon sets are not worth simplifying
+ */
+BOOST_AUTO_TEST_CASE( SmallPolygons )
+{
+    SHAPE_POLY_SET small;
+    small.AddOutline( makeCircle( OUTER_RADIUS, POLYGON_LOD::MIN_VERTEX_COUNT - 1 ) );
+
+    VECTOR2I offset;
+
+    BOOST_CHECK_EQUAL( &m_lod.Get( small, POLYGON_LOD::LEVEL_COUNT - 1, offset ), &small );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,248 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_3d_model_file.cpp
+ * Test suite for the memory mapped model files of the 3D cache
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <3d_cache/3d_model_file.h>
+
+
+/**
+ * A model with a mesh having all of the optional arrays, and one without them.
+ */
+class MODEL_FILE_FIXTURE
+{
+public:
+    MODEL_FILE_FIXTURE()
+    {
+        m_positions = { SFVEC3F( 0, 0, 0 ), SFVEC3F( 1, 0, 0 ), SFVEC3F( 0, 1, 0 ),
+                        SFVEC3F( 1, 1, 0.5f ) };
+        m_normals = { SFVEC3F( 0, 0, 1 ), SFVEC3F( 0, 0, 1 ), SFVEC3F( 0, 0, 1 ),
+                      SFVEC3F( 0, 0.6f, 0.8f ) };
+        m_texcoords = { SFVEC2F( 0, 0 ), SFVEC2F( 1, 0 ), SFVEC2F( 0, 1 ), SFVEC2F( 1, 1 ) };
+        m_colors = { SFVEC3F( 1, 0, 0 ), SFVEC3F( 0, 1, 0 ), SFVEC3F( 0, 0, 1 ),
+                     SFVEC3F( 1, 1, 1 ) };
+        m_faces = { 0, 1, 2, 2, 1, 3 };
+
+        m_materials.resize( 2 );
+        m_materials[0] = {};
+        m_materials[0].m_Diffuse = SFVEC3F( 0.2f, 0.4f, 0.6f );
+        m_materials[0].m_Shininess = 0.5f;
+        m_materials[1] = {};
+        m_materials[1].m_Transparency = 0.25f;
+
+        m_meshes.resize( 2 );
+        m_meshes[0] = { 4, m_positions.data(), m_normals.data(), m_texcoords.data(),
+                        m_colors.data(), 6, m_faces.data(), 1 };
+        m_meshes[1] = { 3, m_positions.data(), m_normals.data(), nullptr, nullptr, 3,
+                        m_faces.data(), 0 };
+
+        m_model.m_MeshesSize = m_meshes.size();
+        m_model.m_Meshes = m_meshes.data();
+        m_model.m_MaterialsSize = m_materials.size();
+        m_model.m_Materials = m_materials.data();
+
+        m_fileName = wxFileName::CreateTempFileName( "model_file" );
+    }
+
+    ~MODEL_FILE_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    std::string ReadFile()
+    {
+        std::ifstream file( m_fileName.fn_str(), std::ios::binary );
+
+        return std::string( ( std::istreambuf_iterator<char>( file ) ),
+                            std::istreambuf_iterator<char>() );
+    }
+
+    void WriteFile( const std::string& aContent )
+    {
+        std::ofstream file( m_fileName.fn_str(), std::ios::binary | std::ios::trunc );
+        file.write( aContent.data(), aContent.size() );
+    }
+
+    std::vector<SFVEC3F>      m_positions;
+    std::vector<SFVEC3F>      m_normals;
+    std::vector<SFVEC2F>      m_texcoords;
+    std::vector<SFVEC3F>      m_colors;
+    std::vector<unsigned int> m_faces;
+    std::vector<SMATERIAL>    m_materials;
+    std::vector<SMESH>        m_meshes;
+    S3DMODEL                  m_model;
+
+    wxString                  m_fileName;
+};
+
+
+/**
+ * Check that a mesh array read from a file has the values of the written one.
+ */
+template <typename T>
+static void checkArray( const T* aResult, const T* aExpected, unsigned int aSize )
+{
+    BOOST_REQUIRE_EQUAL( aResult == nullptr, aExpected == nullptr );
+
+    for( unsigned int ii = 0; aExpected && ii < aSize; ii++ )
+        BOOST_CHECK( aResult[ii] == aExpected[ii] );
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( ModelFile, MODEL_FILE_FIXTURE )
+
+
+/**
+ * A written model must be read back with the same meshes, materials and plugin tag.
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    BOOST_REQUIRE( S3D_MODEL_FILE::Write( m_fileName, m_model, "PLUGIN_VRML:2.0.0.0" ) );
+
+    S3D_MODEL_FILE file;
+    BOOST_REQUIRE( file.Open( m_fileName ) );
+    BOOST_CHECK_EQUAL( file.GetPluginInfo(), "PLUGIN_VRML:2.0.0.0" );
+
+    const S3DMODEL* model = file.GetModel();
+    BOOST_REQUIRE( model );
+    BOOST_REQUIRE_EQUAL( model->m_MeshesSize, m_model.m_MeshesSize );
+    BOOST_REQUIRE_EQUAL( model->m_MaterialsSize, m_model.m_MaterialsSize );
+
+    for( unsigned int ii = 0; ii < model->m_MaterialsSize; ii++ )
+    {
+        BOOST_TEST_CONTEXT( "Material " << ii )
+        {
+            const SMATERIAL& result = model->m_Materials[ii];
+            const SMATERIAL& expected = m_model.m_Materials[ii];
+
+            BOOST_CHECK( result.m_Diffuse == expected.m_Diffuse );
+            BOOST_CHECK_EQUAL( result.m_Shininess, expected.m_Shininess );
+            BOOST_CHECK_EQUAL( result.m_Transparency, expected.m_Transparency );
+        }
+    }
+
+    for( unsigned int ii = 0; ii < model->m_MeshesSize; ii++ )
+    {
+        BOOST_TEST_CONTEXT( "Mesh " << ii )
+        {
+            const SMESH& result = model->m_Meshes[ii];
+            const SMESH& expected = m_model.m_Meshes[ii];
+
+            BOOST_REQUIRE_EQUAL( result.m_VertexSize, expected.m_VertexSize );
+            BOOST_REQUIRE_EQUAL( result.m_FaceIdxSize, expected.m_FaceIdxSize );
+            BOOST_CHECK_EQUAL( result.m_MaterialIdx, expected.m_MaterialIdx );
+
+            checkArray( result.m_Positions, expected.m_Positions, expected.m_VertexSize );
+            checkArray( result.m_Normals, expected.m_Normals, expected.m_VertexSize );
+            checkArray( result.m_Texcoords, expected.m_Texcoords, expected.m_VertexSize );
+            checkArray( result.m_Color, expected.m_Color, expected.m_VertexSize );
+            checkArray( result.m_FaceIdx, expected.m_FaceIdx, expected.m_FaceIdxSize );
+        }
+    }
+}
+
+
+/**
+ * A model without a plugin tag, or with an incomplete mesh, must not be written.
+ */
+BOOST_AUTO_TEST_CASE( InvalidModel )
+{
+    BOOST_CHECK( !S3D_MODEL_FILE::Write( m_fileName, m_model, "" ) );
+    BOOST_CHECK( !S3D_MODEL_FILE::Write( m_fileName, m_model, std::string( 200, 'x' ) ) );
+
+    m_meshes[1].m_Normals = nullptr;
+    BOOST_CHECK( !S3D_MODEL_FILE::Write( m_fileName, m_model, "PLUGIN_VRML:2.0.0.0" ) );
+}
+
+
+/**
+ * Truncated files must be rejected, whether the cut is in the header or the arrays.
+ */
+BOOST_AUTO_TEST_CASE( TruncatedFile )
+{
+    BOOST_REQUIRE( S3D_MODEL_FILE::Write( m_fileName, m_model, "PLUGIN_VRML:2.0.0.0" ) );
+
+    const std::string content = ReadFile();
+    S3D_MODEL_FILE    file;
+
+    for( size_t size : { (size_t) 0, (size_t) 16, content.size() / 2, content.size() - 1 } )
+    {
+        BOOST_TEST_CONTEXT( "Size " << size )
+        {
+            WriteFile( content.substr( 0, size ) );
+
+            BOOST_CHECK( !file.Open( m_fileName ) );
+            BOOST_CHECK( file.GetModel() == nullptr );
+        }
+    }
+
+    // And the complete file is still fine
+    WriteFile( content );
+    BOOST_CHECK( file.Open( m_fileName ) );
+}
+
+
+/**
+ * Files of another version, or which are not model files, must be rejected.
+ */
+BOOST_AUTO_TEST_CASE( WrongVersion )
+{
+    BOOST_REQUIRE( S3D_MODEL_FILE::Write( m_fileName, m_model, "PLUGIN_VRML:2.0.0.0" ) );
+
+    const std::string content = ReadFile();
+    S3D_MODEL_FILE    file;
+
+    // The version follows the 8 byte magic
+    const uint32_t    versions[] = { 0, 1, 3 };
+
+    for( uint32_t version : versions )
+    {
+        BOOST_TEST_CONTEXT( "Version " << version )
+        {
+            std::string other = content;
+            memcpy( &other[8], &version, sizeof( version ) );
+            WriteFile( other );
+
+            BOOST_CHECK( !file.Open( m_fileName ) );
+        }
+    }
+
+    std::string badMagic = content;
+    badMagic[0] = 'X';
+    WriteFile( badMagic );
+    BOOST_CHECK( !file.Open( m_fileName ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the text shape cache of EDA_TEXT.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <eda_text.h>
+
+
+BOOST_AUTO_TEST_SUITE( EdaTextShape )
+
+
+/**
+ * Check the shape is built once, and rebuilt when the text or its effects change
+ */
+BOOST_AUTO_TEST_CASE( CacheHitsAndMisses )
+{
+    EDA_TEXT text( "R12" );
+    EDA_TEXT::ResetShapeCacheStats();
+
+    std::shared_ptr<const TEXT_SHAPE> shape = text.GetTextShape();
+
+    BOOST_CHECK( !shape->m_Segments.empty() );
+    BOOST_CHECK_EQUAL( shape->m_Segments.size() % 2, 0 );
+    BOOST_CHECK_EQUAL( EDA_TEXT::GetShapeCacheMisses(), 1 );
+    BOOST_CHECK_EQUAL( EDA_TEXT::GetShapeCacheHits(), 0 );
+
+    BOOST_CHECK( text.GetTextShape() == shape );
+    BOOST_CHECK_EQUAL( EDA_TEXT::GetShapeCacheHits(), 1 );
+
+    text.SetText( "R13" );
+    std::shared_ptr<const TEXT_SHAPE> changed = text.GetTextShape();
+    BOOST_CHECK( changed != shape );
+
+    text.SetTextPos( wxPoint( 1000, 0 ) );
+    std::shared_ptr<const TEXT_SHAPE> moved = text.GetTextShape();
+    BOOST_CHECK_EQUAL( moved->m_BoundingBox.GetX(), changed->m_BoundingBox.GetX() + 1000 );
+
+    // The text angle is 0: same shape
+    BOOST_CHECK( text.GetTextShape( 0.0 ) == moved );
+
+    BOOST_CHECK_EQUAL( EDA_TEXT::GetShapeCacheMisses(), 3 );
+    BOOST_CHECK_EQUAL( EDA_TEXT::GetShapeCacheHits(), 2 );
+
+    // A copy shares the shape of its source
+    EDA_TEXT copy( text );
+    BOOST_CHECK( copy.GetTextShape() == moved );
+}
+
+
+/**
+ * Check the shape and its bounding box follow the draw rotation
+ */
+BOOST_AUTO_TEST_CASE( Rotation )
+{
+    EDA_TEXT text( "WIDE TEXT" );
+    text.SetThickness( 100 );
+
+    EDA_RECT horizontal = text.GetTextShape()->m_BoundingBox;
+    EDA_RECT vertical = text.GetTextShape( 900.0 )->m_BoundingBox;
+
+    BOOST_CHECK_GT( horizontal.GetWidth(), horizontal.GetHeight() );
+    BOOST_CHECK_GT( vertical.GetHeight(), vertical.GetWidth() );
+
+    // The box includes the pen width
+    for( const wxPoint& pt : text.GetTextShape()->m_Segments )
+    {
+        BOOST_CHECK_GE( pt.x - 50, horizontal.GetLeft() );
+        BOOST_CHECK_LE( pt.x + 50, horizontal.GetRight() );
+    }
+
+    std::vector<wxPoint> segments;
+    text.TransformTextShapeToSegmentList( segments );
+    BOOST_CHECK( segments == text.GetTextShape()->m_Segments );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,85 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the aperture list of GERBER_PLOTTER.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <plotter.h>
+
+
+BOOST_AUTO_TEST_SUITE( GerberApertures )
+
+
+/**
+ * Check that new apertures get consecutive D codes, and existing ones are found again
+ */
+BOOST_AUTO_TEST_CASE( FindOrCreate )
+{
+    GERBER_PLOTTER plotter;
+
+    int circle = plotter.GetOrCreateAperture( wxSize( 100, 100 ), APERTURE::AT_CIRCLE, 0 );
+    int rect = plotter.GetOrCreateAperture( wxSize( 100, 100 ), APERTURE::AT_RECT, 0 );
+    int circleAttr = plotter.GetOrCreateAperture( wxSize( 100, 100 ), APERTURE::AT_CIRCLE, 2 );
+    int oval = plotter.GetOrCreateAperture( wxSize( 200, 100 ), APERTURE::AT_OVAL, 0 );
+
+    BOOST_CHECK_EQUAL( circle, 0 );
+    BOOST_CHECK_EQUAL( rect, 1 );
+    BOOST_CHECK_EQUAL( circleAttr, 2 );
+    BOOST_CHECK_EQUAL( oval, 3 );
+
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 100, 100 ), APERTURE::AT_RECT, 0 ),
+                       rect );
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 100, 100 ), APERTURE::AT_CIRCLE, 2 ),
+                       circleAttr );
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 100, 200 ), APERTURE::AT_OVAL, 0 ),
+                       4 );
+}
+
+
+/**
+ * Check that regular polygons with different rotations are different apertures
+ */
+BOOST_AUTO_TEST_CASE( RegularPolygonRotation )
+{
+    GERBER_PLOTTER plotter;
+
+    // for regular polygons, the size contains the diameter and the rotation in 1/1000 deg
+    int poly0 = plotter.GetOrCreateAperture( wxSize( 500, 0 ), APERTURE::AT_REGULAR_POLY6, 0 );
+    int poly45 = plotter.GetOrCreateAperture( wxSize( 500, 45000 ),
+                                              APERTURE::AT_REGULAR_POLY6, 0 );
+    int poly8 = plotter.GetOrCreateAperture( wxSize( 500, 0 ), APERTURE::AT_REGULAR_POLY8, 0 );
+
+    BOOST_CHECK_NE( poly0, poly45 );
+    BOOST_CHECK_NE( poly0, poly8 );
+    BOOST_CHECK_EQUAL( plotter.GetOrCreateAperture( wxSize( 500, 45000 ),
+                                                    APERTURE::AT_REGULAR_POLY6, 0 ),
+                       poly45 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for ParallelFor()
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <parallel_for.h>
+
+#include <stdexcept>
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( ParallelLoops )
+
+
+/**
+ * Check that every item is run exactly once, whatever the number of threads
+ */
+BOOST_AUTO_TEST_CASE( RunsEachItemOnce )
+{
+    for( size_t threadCount : { 0, 1, 2, 7 } )
+    {
+        BOOST_TEST_CONTEXT( "Threads: " << threadCount )
+        {
+            std::vector<std::atomic<int>> runs( 1000 );
+
+            for( auto& run : runs )
+                run = 0;
+
+            ParallelFor( runs.size(), [&]( size_t aIdx ) { runs[aIdx]++; }, threadCount );
+
+            for( const auto& run : runs )
+                BOOST_CHECK_EQUAL( run.load(), 1 );
+        }
+    }
+
+    // Nothing to run
+    ParallelFor( 0, []( size_t ) { BOOST_ERROR( "No item to run" ); } );
+}
+
+
+/**
+ * Check that an exception thrown by an item is rethrown to the caller, after the threads
+ * are joined
+ */
+BOOST_AUTO_TEST_CASE( RethrowsException )
+{
+    std::atomic<int> runs( 0 );
+
+    auto func = [&]( size_t aIdx )
+    {
+        runs++;
+
+        if( aIdx == 10 )
+            throw std::runtime_error( "item failed" );
+    };
+
+    BOOST_CHECK_THROW( ParallelFor( 100000, func, 4 ), std::runtime_error );
+
+    // The items not started yet when the exception was thrown are skipped
+    BOOST_CHECK_LT( runs.load(), 100000 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_pdf_plotter.cpp
+ * Test suite for the page content streams of PDF_PLOTTER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <fstream>
+#include <iterator>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/mstream.h>
+#include <wx/zstream.h>
+
+#include <common.h>
+#include <eda_text.h>
+#include <gal/color4d.h>
+#include <plotter.h>
+
+
+/**
+ * Plot a text item on each of \a aPageCount pages of a PDF file.
+ */
+static void plotTextPages( const wxString& aFileName, int aPageCount, bool aThreaded )
+{
+    LOCALE_IO   toggle;
+    PDF_PLOTTER plotter;
+
+    plotter.SetPageSettings( PAGE_INFO( PAGE_INFO::A4 ) );
+    plotter.SetViewport( wxPoint( 0, 0 ), 1.0, 1.0, false );
+    plotter.SetThreadedCompression( aThreaded );
+
+    BOOST_REQUIRE( plotter.OpenFile( aFileName ) );
+    BOOST_REQUIRE( plotter.StartPlot() );
+
+    for( int page = 1; page <= aPageCount; page++ )
+    {
+        if( page > 1 )
+        {
+            plotter.ClosePage();
+            plotter.StartPage();
+        }
+
+        plotter.Text( wxPoint( 10000, 10000 ), COLOR4D( BLACK ),
+                      wxString::Format( "Page %d (x\\y)", page ), 0.0, wxSize( 500, 500 ),
+                      GR_TEXT_HJUSTIFY_LEFT, GR_TEXT_VJUSTIFY_BOTTOM, 50, false, false );
+    }
+
+    plotter.EndPlot();
+}
+
+
+/**
+ * Read the content streams of a PDF file plotted by PDF_PLOTTER, in file order, and
+ * inflate them.
+ */
+static std::vector<std::string> readPageStreams( const wxString& aFileName )
+{
+    const std::string streamStart = "/Filter /FlateDecode >>\nstream\n";
+    const std::string streamEnd = "endstream\n";
+
+    std::ifstream file( aFileName.fn_str(), std::ios::binary );
+    BOOST_REQUIRE( file );
+
+    std::string              pdf( ( std::istreambuf_iterator<char>( file ) ),
+                                  std::istreambuf_iterator<char>() );
+    std::vector<std::string> streams;
+
+    for( size_t start = pdf.find( streamStart ); start != std::string::npos;
+         start = pdf.find( streamStart, start ) )
+    {
+        start += streamStart.size();
+
+        size_t end = pdf.find( streamEnd, start );
+        BOOST_REQUIRE( end != std::string::npos );
+
+        wxMemoryInputStream memis( pdf.data() + start, end - start );
+        wxZlibInputStream   zis( memis, wxZLIB_ZLIB );
+        std::string         inflated;
+        char                buffer[4096];
+
+        while( zis.Read( buffer, sizeof( buffer ) ).LastRead() > 0 )
+            inflated.append( buffer, zis.LastRead() );
+
+        streams.push_back( inflated );
+        start = end;
+    }
+
+    return streams;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PdfPlotter )
+
+
+/**
+ * The text strings must be escaped in the page streams, and the streams compressed by
+ * worker threads must be written in page order.
+ */
+BOOST_AUTO_TEST_CASE( TextInPageStreams )
+{
+    const int pageCount = 3;
+
+    for( bool threaded : { false, true } )
+    {
+        BOOST_TEST_CONTEXT( ( threaded ? "Threaded" : "Inline" ) << " compression" )
+        {
+            wxString fileName = wxFileName::CreateTempFileName( "pdf_plotter" );
+
+            plotTextPages( fileName, pageCount, threaded );
+
+            std::vector<std::string> streams = readPageStreams( fileName );
+            BOOST_REQUIRE_EQUAL( streams.size(), (size_t) pageCount );
+
+            for( int page = 1; page <= pageCount; page++ )
+            {
+                std::string expected = "(Page " + std::to_string( page ) + " \\(x\\\\y\\)) Tj";
+
+                BOOST_CHECK_MESSAGE( streams[page - 1].find( expected ) != std::string::npos,
+                                     "Page " << page << " has no " << expected );
+            }
+
+            wxRemoveFile( fileName );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
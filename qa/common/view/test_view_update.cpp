@@ -0,0 +1,375 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for VIEW::UpdateItems(): items drawn by worker threads through
+ * RECORDING_GAL must end in the GAL cache exactly as when drawn by the main thread.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <view/view.h>
+#include <gal/recording_gal.h>
+
+#include <base_struct.h>
+#include <gal/gal_display_options.h>
+#include <painter.h>
+
+#include <map>
+#include <sstream>
+
+using namespace KIGFX;
+
+
+/// The display options must be built before the GAL subscribing to them
+struct MOCK_GAL_OPTIONS
+{
+    GAL_DISPLAY_OPTIONS m_options;
+};
+
+
+/**
+ * A GAL keeping a text log of the drawing commands of each group
+ */
+class MOCK_GAL : private MOCK_GAL_OPTIONS, public GAL
+{
+public:
+    MOCK_GAL() :
+        GAL( m_options ),
+        m_nextGroup( 0 ),
+        m_currentGroup( -1 )
+    {}
+
+    int BeginGroup() override
+    {
+        m_currentGroup = m_nextGroup++;
+        m_groups[m_currentGroup];
+        return m_currentGroup;
+    }
+
+    void EndGroup() override { m_currentGroup = -1; }
+
+    void DeleteGroup( int aGroup ) override { m_groups.erase( aGroup ); }
+
+    void DrawLine( const VECTOR2D& aStart, const VECTOR2D& aEnd ) override
+    {
+        log() << "line " << aStart.x << "," << aStart.y << " " << aEnd.x << "," << aEnd.y;
+    }
+
+    void DrawCircle( const VECTOR2D& aCenter, double aRadius ) override
+    {
+        log() << "circle " << aCenter.x << "," << aCenter.y << " " << aRadius;
+    }
+
+    void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override
+    {
+        std::ostream& out = log() << "polyline";
+
+        for( const VECTOR2D& pt : aPointList )
+            out << " " << pt.x << "," << pt.y;
+    }
+
+    void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override
+    {
+        DrawPolyline( std::deque<VECTOR2D>( aPointList, aPointList + aListSize ) );
+    }
+
+    void SetStrokeColor( const COLOR4D& aColor ) override
+    {
+        GAL::SetStrokeColor( aColor );
+        log() << "stroke color " << aColor.r << " " << aColor.g << " " << aColor.b;
+    }
+
+    void SetLineWidth( float aWidth ) override
+    {
+        GAL::SetLineWidth( aWidth );
+        log() << "line width " << aWidth;
+    }
+
+    void Save() override { log() << "save"; }
+    void Restore() override { log() << "restore"; }
+    void Rotate( double aAngle ) override { log() << "rotate " << aAngle; }
+
+    void Translate( const VECTOR2D& aVec ) override
+    {
+        log() << "translate " << aVec.x << "," << aVec.y;
+    }
+
+    /// Return the drawings of all the groups, in the order of the groups
+    std::vector<std::string> GetGroups() const
+    {
+        std::vector<std::string> groups;
+
+        for( const auto& group : m_groups )
+            groups.push_back( group.second.str() );
+
+        return groups;
+    }
+
+private:
+    std::ostream& log()
+    {
+        BOOST_REQUIRE( m_currentGroup >= 0 );
+        std::ostringstream& out = m_groups[m_currentGroup];
+        out << "\n";
+        return out;
+    }
+
+    int                                m_nextGroup;
+    int                                m_currentGroup;
+    std::map<int, std::ostringstream>  m_groups;
+};
+
+
+class MOCK_ITEM : public EDA_ITEM
+{
+public:
+    MOCK_ITEM( int aIndex ) :
+        EDA_ITEM( NOT_USED ),
+        m_index( aIndex )
+    {}
+
+    wxString GetClass() const override
+    {
+        return wxT( "MockItem" );
+    }
+
+#ifdef DEBUG
+    void Show( int nestLevel, std::ostream& os ) const override {}
+#endif
+
+    const BOX2I ViewBBox() const override
+    {
+        return BOX2I( VECTOR2I( m_index * 100, 0 ), VECTOR2I( 100, 100 ) );
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = 1;
+        aLayers[1] = 2;
+        aCount = 2;
+    }
+
+    int m_index;
+};
+
+
+class MOCK_RENDER_SETTINGS : public RENDER_SETTINGS
+{
+public:
+    const COLOR4D& GetColor( const VIEW_ITEM* aItem, int aLayer ) const override
+    {
+        return m_color;
+    }
+
+    const COLOR4D& GetBackgroundColor() override { return m_color; }
+    void SetBackgroundColor( const COLOR4D& aColor ) override {}
+    const COLOR4D& GetGridColor() override { return m_color; }
+    const COLOR4D& GetCursorColor() override { return m_color; }
+
+    COLOR4D m_color;
+};
+
+
+/**
+ * A painter drawing the mock items with primitives, transforms and stroke texts
+ */
+class MOCK_PAINTER : public PAINTER
+{
+public:
+    MOCK_PAINTER( GAL* aGal, bool aCanClone ) :
+        PAINTER( aGal ),
+        m_canClone( aCanClone ),
+        m_cloneCount( 0 )
+    {}
+
+    void ApplySettings( const RENDER_SETTINGS* aSettings ) override
+    {
+        m_settings = *static_cast<const MOCK_RENDER_SETTINGS*>( aSettings );
+    }
+
+    RENDER_SETTINGS* GetSettings() override { return &m_settings; }
+
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        const MOCK_ITEM* item = static_cast<const MOCK_ITEM*>( aItem );
+        double x = item->m_index * 100.0;
+
+        // Every tenth item is drawn by the main thread
+        if( item->m_index % 10 == 9 )
+            return false;
+
+        m_gal->SetStrokeColor( COLOR4D( aLayer / 4.0, 0.5, item->m_index / 10000.0, 1.0 ) );
+        m_gal->SetLineWidth( 2.0f + aLayer );
+
+        if( aLayer == 1 )
+        {
+            m_gal->DrawLine( VECTOR2D( x, 0 ), VECTOR2D( x + 100, 100 ) );
+            m_gal->DrawCircle( VECTOR2D( x + 50, 50 ), 25 );
+        }
+        else
+        {
+            m_gal->Save();
+            m_gal->Translate( VECTOR2D( x, 0 ) );
+            m_gal->Rotate( 0.5 );
+            m_gal->SetGlyphSize( VECTOR2D( 40, 40 ) );
+            m_gal->StrokeText( wxString::Format( "R%d", item->m_index ), VECTOR2D( 0, 0 ), 0.0 );
+            m_gal->Restore();
+        }
+
+        return true;
+    }
+
+    PAINTER* Clone( GAL* aGal ) override
+    {
+        if( !m_canClone )
+            return nullptr;
+
+        MOCK_PAINTER* painter = new MOCK_PAINTER( aGal, true );
+        painter->ApplySettings( &m_settings );
+        m_cloneCount++;
+        return painter;
+    }
+
+    /// The number of painters cloned, one per worker thread
+    int GetCloneCount() const { return m_cloneCount; }
+
+private:
+    bool                 m_canClone;
+    int                  m_cloneCount;
+    MOCK_RENDER_SETTINGS m_settings;
+};
+
+
+class MAIN_THREAD_DRAWN_ITEM : public MOCK_ITEM
+{
+public:
+    MAIN_THREAD_DRAWN_ITEM( int aIndex ) :
+        MOCK_ITEM( aIndex )
+    {}
+
+    void ViewDraw( int aLayer, VIEW* aView ) const override
+    {
+        aView->GetGAL()->DrawCircle( VECTOR2D( m_index, aLayer ), 1 );
+    }
+};
+
+
+/**
+ * Draw aCount items in a view and return the cached drawing of each item layer
+ */
+static std::vector<std::string> drawItems( int aCount, unsigned aThreadCount )
+{
+    MOCK_GAL gal;
+    MOCK_PAINTER painter( &gal, true );
+    VIEW view;
+
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+    view.SetUpdateThreadCount( aThreadCount );
+
+    std::vector<std::unique_ptr<MOCK_ITEM>> items;
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        if( ii % 10 == 9 )
+            items.emplace_back( new MAIN_THREAD_DRAWN_ITEM( ii ) );
+        else
+            items.emplace_back( new MOCK_ITEM( ii ) );
+
+        view.Add( items.back().get() );
+    }
+
+    view.UpdateItems();
+
+    // Check the items were drawn by the workers whatever the number of cores
+    BOOST_CHECK_EQUAL( painter.GetCloneCount(), aThreadCount > 1 ? (int) aThreadCount : 0 );
+
+    std::vector<std::string> groups = gal.GetGroups();
+
+    for( auto& item : items )
+        view.Remove( item.get() );
+
+    return groups;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ViewUpdate )
+
+
+/**
+ * Check that a display list replays the recorded commands, with the text laid out
+ */
+BOOST_AUTO_TEST_CASE( RecordAndReplay )
+{
+    MOCK_GAL direct;
+    MOCK_GAL replayed;
+    RECORDING_GAL recorder( &replayed );
+    MOCK_PAINTER directPainter( &direct, false );
+    MOCK_PAINTER recordingPainter( &recorder, false );
+    MOCK_ITEM item( 3 );
+
+    for( int layer = 1; layer <= 2; ++layer )
+    {
+        direct.BeginGroup();
+        BOOST_REQUIRE( directPainter.Draw( &item, layer ) );
+        direct.EndGroup();
+
+        BOOST_REQUIRE( recordingPainter.Draw( &item, layer ) );
+        std::unique_ptr<GAL_DISPLAY_LIST> list = recorder.TakeDisplayList();
+
+        BOOST_CHECK( !list->Empty() );
+
+        replayed.BeginGroup();
+        list->Replay( replayed );
+        replayed.EndGroup();
+    }
+
+    BOOST_CHECK( recorder.TakeDisplayList()->Empty() );
+    BOOST_CHECK( direct.GetGroups() == replayed.GetGroups() );
+}
+
+
+/**
+ * Check that the items drawn by worker threads are cached as the ones drawn
+ * by the main thread, in the same order
+ */
+BOOST_AUTO_TEST_CASE( ParallelMatchesSerial )
+{
+    // Enough items for several batches of worker threads
+    const int count = 5000;
+
+    std::vector<std::string> serial = drawItems( count, 1 );
+    std::vector<std::string> parallel = drawItems( count, 4 );
+
+    BOOST_CHECK_EQUAL( serial.size(), 2 * count );
+    BOOST_REQUIRE_EQUAL( parallel.size(), serial.size() );
+
+    for( size_t ii = 0; ii < serial.size(); ++ii )
+        BOOST_CHECK_EQUAL( parallel[ii], serial[ii] );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
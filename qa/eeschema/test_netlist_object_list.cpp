@@ -0,0 +1,301 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the pin lookups of NETLIST_OBJECT_LIST used by ERC
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <array>
+#include <chrono>
+
+#include <erc.h>
+#include <kiway.h>
+#include <netlist_object.h>
+#include <pgm_base.h>
+#include <sch_component.h>
+#include <sch_marker.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+
+
+/**
+ * A small sheet with a two unit component U1 whose units share pins 1 and 2 (the
+ * duplicated pins ERC looks up), a resistor and a driver.
+ */
+class NETLIST_PINS_FIXTURE
+{
+public:
+    NETLIST_PINS_FIXTURE() :
+            m_kiway( &Pgm(), KFCTL_STANDALONE )
+    {
+        m_sheet.SetScreen( new SCH_SCREEN( &m_kiway ) );
+        m_path.push_back( &m_sheet );
+
+        for( size_t ii = 0; ii < m_comps.size(); ++ii )
+            m_comps[ii].SetTimeStamp( (timestamp_t) ii + 1 );
+
+        m_comps[U1A].SetRef( &m_path, "U1" );
+        m_comps[U1B].SetRef( &m_path, "U1" );
+        m_comps[R1].SetRef( &m_path, "R1" );
+        m_comps[U2].SetRef( &m_path, "U2" );
+    }
+
+    /**
+     * Append the pins of the sheet to \a aList, in the reverse order of their nets so
+     * sorting by net code moves every item.
+     */
+    void FillList( NETLIST_OBJECT_LIST& aList )
+    {
+        addPin( aList, R1, "2", PIN_PASSIVE, 6 );
+        addPin( aList, U2, "2", PIN_INPUT, 6 );
+        addPin( aList, R1, "1", PIN_PASSIVE, 5 );
+        addPin( aList, U1B, "2", PIN_INPUT, 4 );
+        addPin( aList, U1A, "2", PIN_INPUT, 3 );
+        addPin( aList, U2, "1", PIN_INPUT, 3 );
+        addPin( aList, U1B, "1", PIN_INPUT, 2 );
+        addPin( aList, U2, "3", PIN_OUTPUT, 2 );
+        addPin( aList, U1A, "1", PIN_INPUT, 1 );
+    }
+
+    void AddPin( NETLIST_OBJECT_LIST& aList, const wxString& aPinNum, int aNet )
+    {
+        addPin( aList, U1B, aPinNum, PIN_INPUT, aNet );
+    }
+
+    /**
+     * Run the pin tests of ERC the way DIALOG_ERC::TestErc() does, on a list sorted by
+     * net code, and return the messages of the markers it created.
+     */
+    std::vector<std::string> RunPinErc( NETLIST_OBJECT_LIST& aList )
+    {
+        SCH_SCREEN* screen = m_path.LastScreen();
+        int         minConn = NOC;
+        unsigned    netStart = 0;
+
+        screen->DeleteAllMarkers( MARKER_BASE::MARKER_ERC );
+        aList.ResetConnectionsType();
+
+        for( unsigned ii = 0; ii < aList.size(); ii++ )
+        {
+            if( ii > 0 && aList.GetItemNet( ii ) != aList.GetItemNet( ii - 1 ) )
+            {
+                minConn = NOC;
+                netStart = ii;
+            }
+
+            if( aList.GetItemType( ii ) == NET_PIN )
+                TestOthersItems( &aList, ii, netStart, &minConn );
+        }
+
+        std::vector<std::string> messages;
+
+        for( SCH_ITEM* item = screen->GetDrawItems(); item; item = item->Next() )
+        {
+            if( item->Type() == SCH_MARKER_T )
+            {
+                SCH_MARKER* marker = static_cast<SCH_MARKER*>( item );
+                messages.push_back( marker->GetReporter().GetMainText().ToStdString() );
+            }
+        }
+
+        std::sort( messages.begin(), messages.end() );
+        return messages;
+    }
+
+private:
+    enum COMP
+    {
+        U1A,
+        U1B,
+        R1,
+        U2,
+        COMP_COUNT
+    };
+
+    void addPin( NETLIST_OBJECT_LIST& aList, COMP aComp, const wxString& aPinNum,
+                 ELECTRICAL_PINTYPE aType, int aNet )
+    {
+        NETLIST_OBJECT* item = new NETLIST_OBJECT();
+
+        item->m_Type = NET_PIN;
+        item->m_Link = &m_comps[aComp];
+        item->m_Comp = &m_comps[aComp];
+        item->m_SheetPath = m_path;
+        item->m_PinNum = aPinNum;
+        item->m_ElectricalPinType = aType;
+        item->m_Start = item->m_End = wxPoint( 100 * (int) aList.size(), 100 * aComp );
+        item->SetNet( aNet );
+
+        aList.push_back( item );
+    }
+
+    KIWAY                                 m_kiway;
+    SCH_SHEET                             m_sheet;
+    SCH_SHEET_PATH                        m_path;
+    std::array<SCH_COMPONENT, COMP_COUNT> m_comps;
+};
+
+
+/**
+ * The lookup ERC did before the pin index: scan the whole list for the pins having the
+ * same reference and pin number.
+ */
+static std::vector<unsigned> findPinInstances( NETLIST_OBJECT_LIST& aList,
+                                               const wxString& aReference,
+                                               const wxString& aPinNum )
+{
+    std::vector<unsigned> found;
+
+    for( unsigned ii = 0; ii < aList.size(); ii++ )
+    {
+        NETLIST_OBJECT* item = aList.GetItem( ii );
+
+        if( item->m_Type != NET_PIN || item->m_PinNum != aPinNum )
+            continue;
+
+        if( ( (SCH_COMPONENT*) item->m_Link )->GetRef( &item->m_SheetPath ) == aReference )
+            found.push_back( ii );
+    }
+
+    return found;
+}
+
+
+/**
+ * Check GetPinInstances() against the scan of the list, for every pin of the list.
+ */
+static void checkPinInstances( NETLIST_OBJECT_LIST& aList )
+{
+    for( unsigned ii = 0; ii < aList.size(); ii++ )
+    {
+        NETLIST_OBJECT* pin = aList.GetItem( ii );
+        wxString        ref = ( (SCH_COMPONENT*) pin->m_Link )->GetRef( &pin->m_SheetPath );
+
+        BOOST_TEST_CONTEXT( ref + " pin " + pin->m_PinNum )
+        {
+            const std::vector<unsigned>  expected = findPinInstances( aList, ref, pin->m_PinNum );
+            const std::vector<unsigned>& result = aList.GetPinInstances( ref, pin->m_PinNum );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS( result.begin(), result.end(), expected.begin(),
+                                           expected.end() );
+        }
+    }
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( NetlistObjectList, NETLIST_PINS_FIXTURE )
+
+
+/**
+ * The pin index must follow the list when it is sorted or grows after the first lookup.
+ */
+BOOST_AUTO_TEST_CASE( PinInstancesFollowList )
+{
+    NETLIST_OBJECT_LIST list;
+    FillList( list );
+
+    checkPinInstances( list );
+    BOOST_CHECK_EQUAL( list.GetPinInstances( "U1", "2" ).size(), 2 );
+
+    list.SortListbyNetcode();
+    checkPinInstances( list );
+
+    list.SortListbySheet();
+    checkPinInstances( list );
+
+    AddPin( list, "2", 7 );
+    checkPinInstances( list );
+    BOOST_CHECK_EQUAL( list.GetPinInstances( "U1", "2" ).size(), 3 );
+
+    list.Clear();
+    BOOST_CHECK( list.GetPinInstances( "U1", "2" ).empty() );
+}
+
+
+/**
+ * ERC must give the same markers whether or not the pin index was built before the
+ * list was sorted by net code.
+ */
+BOOST_AUTO_TEST_CASE( ErcIgnoresStalePinIndex )
+{
+    NETLIST_OBJECT_LIST fresh;
+    FillList( fresh );
+    fresh.SortListbyNetcode();
+
+    const std::vector<std::string> expected = RunPinErc( fresh );
+
+    NETLIST_OBJECT_LIST primed;
+    FillList( primed );
+    primed.GetPinInstances( "U1", "1" );
+    primed.SortListbyNetcode();
+
+    const std::vector<std::string> result = RunPinErc( primed );
+
+    // Only net 3 has no driver, its two inputs give one marker.
+    BOOST_CHECK_EQUAL( expected.size(), 1 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( result.begin(), result.end(), expected.begin(),
+                                   expected.end() );
+}
+
+
+/**
+ * Look up every pin of a 50000 pin list.  Scanning the list for each pin, as ERC did
+ * before the index, takes minutes on such a list.
+ */
+BOOST_AUTO_TEST_CASE( ManyPins )
+{
+    const int           pinCount = 25000;
+    NETLIST_OBJECT_LIST list;
+
+    for( int ii = 0; ii < pinCount; ii++ )
+    {
+        AddPin( list, wxString::Format( "%d", ii ), ii + 1 );
+        AddPin( list, wxString::Format( "%d", ii ), pinCount + ii + 1 );
+    }
+
+    list.SortListbyNetcode();
+
+    const auto start = std::chrono::steady_clock::now();
+    bool       allFound = true;
+
+    for( unsigned ii = 0; ii < list.size(); ii++ )
+    {
+        NETLIST_OBJECT* pin = list.GetItem( ii );
+
+        if( list.GetPinInstances( "U1", pin->m_PinNum ).size() != 2 )
+            allFound = false;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start );
+
+    BOOST_TEST_MESSAGE( "Looked up " << list.size() << " pins in " << elapsed.count()
+                                     << " ms" );
+    BOOST_CHECK( allFound );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the netlist tree writers: the streamed output must be the same
+ * as the output of the XNODE tree they replace.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <netlist_exporters/netlist_tree_writer.h>
+
+#include <richio.h>
+#include <xnode.h>
+
+#include <wx/mstream.h>
+
+
+/**
+ * Write the tree of aNode with aWriter, in the same order as it is serialized.
+ */
+static void writeTree( NETLIST_TREE_WRITER& aWriter, XNODE* aNode )
+{
+    aWriter.StartNode( aNode->GetName() );
+
+    for( wxXmlAttribute* attr = aNode->GetAttributes(); attr; attr = attr->GetNext() )
+        aWriter.AddAttribute( attr->GetName(), attr->GetValue() );
+
+    for( XNODE* kid = aNode->GetChildren(); kid; kid = kid->GetNext() )
+    {
+        if( kid->GetType() == wxXML_TEXT_NODE )
+            aWriter.AddText( kid->GetContent() );
+        else
+            writeTree( aWriter, kid );
+    }
+
+    aWriter.EndNode();
+}
+
+
+static XNODE* node( XNODE* aParent, const wxString& aName, const wxString& aText = wxEmptyString )
+{
+    XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
+
+    if( aText.Len() > 0 )
+        n->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aText ) );
+
+    if( aParent )
+        aParent->AddChild( n );
+
+    return n;
+}
+
+
+/**
+ * Build a tree looking like a generic netlist, with the constructs used by the
+ * exporters: empty elements, text elements with attributes, and special chars.
+ */
+static XNODE* makeTestTree()
+{
+    XNODE* root = node( nullptr, "export" );
+    root->AddAttribute( "version", "D" );
+
+    XNODE* design = node( root, "design" );
+    node( design, "source", "/home/<user>/a&b.sch" );
+    node( design, "date" );
+
+    XNODE* comps = node( root, "components" );
+    XNODE* comp = node( comps, "comp" );
+    comp->AddAttribute( "ref", "R1" );
+    node( comp, "value", "10k" );
+
+    XNODE* fields = node( comp, "fields" );
+    XNODE* field = node( fields, "field", "say \"hi\"" );
+    field->AddAttribute( "name", "Note\t1" );
+
+    XNODE* libsource = node( comp, "libsource" );
+    libsource->AddAttribute( "lib", "device" );
+    libsource->AddAttribute( "description", "two\nlines \"quoted\" > 1" );
+
+    node( root, "libparts" );
+
+    XNODE* nets = node( root, "nets" );
+    XNODE* net = node( nets, "net" );
+    net->AddAttribute( "code", "1" );
+    net->AddAttribute( "name", "/a" );
+    node( net, "node" )->AddAttribute( "ref", "R1" );
+    node( net, "node" )->AddAttribute( "ref", "R2" );
+
+    return root;
+}
+
+
+BOOST_AUTO_TEST_SUITE( NetlistTreeWriter )
+
+
+BOOST_AUTO_TEST_CASE( SexprMatchesXnode )
+{
+    std::unique_ptr<XNODE> root( makeTestTree() );
+
+    STRING_FORMATTER expected;
+    root->Format( &expected, 0 );
+
+    STRING_FORMATTER streamed;
+    NETLIST_SEXPR_WRITER writer( &streamed );
+    writeTree( writer, root.get() );
+
+    BOOST_CHECK_EQUAL( streamed.GetString(), expected.GetString() );
+}
+
+
+BOOST_AUTO_TEST_CASE( XmlMatchesXmlDocument )
+{
+    wxXmlDocument doc;
+    doc.SetRoot( makeTestTree() );
+
+    wxMemoryOutputStream stream;
+    BOOST_REQUIRE( doc.Save( stream, 2 ) );
+
+    wxStreamBuffer* buffer = stream.GetOutputStreamBuffer();
+    std::string expected( (const char*) buffer->GetBufferStart(), buffer->GetIntPosition() );
+
+    STRING_FORMATTER streamed;
+    NETLIST_XML_WRITER writer( &streamed );
+    writer.StartDocument();
+    writeTree( writer, (XNODE*) doc.GetRoot() );
+    writer.EndDocument();
+
+    BOOST_CHECK_EQUAL( streamed.GetString(), expected );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
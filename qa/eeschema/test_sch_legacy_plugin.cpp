@@ -0,0 +1,228 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for SCH_LEGACY_PLUGIN symbol libraries and schematic hierarchies
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <sch_io_mgr.h>
+#include <sch_legacy_plugin.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <class_libentry.h>
+#include <symbol_lib_table.h>
+#include <kiway.h>
+#include <pgm_base.h>
+#include <properties.h>
+#include <wildcards_and_files_ext.h>
+
+#include "eeschema_test_utils.h"
+
+
+/**
+ * Get a symbol library file from the test data legacy_libs subdir
+ */
+static wxString getLegacyTestLibrary( const wxString& aLibFile )
+{
+    wxFileName fn = KI_TEST::GetEeschemaTestDataDir();
+    fn.AppendDir( "legacy_libs" );
+    fn.SetFullName( aLibFile );
+    fn.MakeAbsolute();
+
+    return fn.GetFullPath();
+}
+
+
+/**
+ * Describe each sheet path of a hierarchy: its file and the items of its screen.
+ */
+static std::vector<std::string> describeHierarchy( SCH_SHEET* aRootSheet )
+{
+    std::vector<std::string> desc;
+
+    for( const SCH_SHEET_PATH& path : SCH_SHEET_LIST( aRootSheet ) )
+    {
+        SCH_SCREEN* screen = path.LastScreen();
+        wxString    line = path.PathHumanReadable() + " "
+                           + wxFileName( screen->GetFileName() ).GetFullName();
+
+        for( SCH_ITEM* item = screen->GetDrawItems(); item; item = item->Next() )
+        {
+            line << wxString::Format( " %s(%d,%d)", item->GetClass(), item->GetPosition().x,
+                                      item->GetPosition().y );
+        }
+
+        desc.push_back( line.ToStdString() );
+    }
+
+    return desc;
+}
+
+
+/**
+ * Load the hierarchy test schematic, parsing its sheet files with the given number of
+ * prefetch threads.
+ */
+static std::unique_ptr<SCH_SHEET> loadHierarchy( KIWAY& aKiway, int aThreadCount )
+{
+    wxFileName fn = KI_TEST::GetEeschemaTestDataDir();
+    fn.AppendDir( "hierarchy" );
+    fn.SetFullName( "hierarchy.sch" );
+    fn.MakeAbsolute();
+
+    wxFileName projectFn = fn;
+    projectFn.SetExt( ProjectFileExtension );
+    aKiway.Prj().SetProjectFullName( projectFn.GetFullPath() );
+
+    PROPERTIES props;
+    props[ SCH_LEGACY_PLUGIN::PropPrefetchThreads ] = std::to_string( aThreadCount );
+
+    SCH_LEGACY_PLUGIN plugin;
+    std::unique_ptr<SCH_SHEET> root( plugin.Load( fn.GetFullPath(), &aKiway, nullptr,
+                                                  &props ) );
+
+    BOOST_CHECK_MESSAGE( plugin.GetError().IsEmpty(), plugin.GetError() );
+
+    return root;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SchLegacyPlugin )
+
+
+/**
+ * Check that enumerating the symbol names finds the root symbols and the aliases in
+ * name order.
+ */
+BOOST_AUTO_TEST_CASE( EnumerateSymbolNames )
+{
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+    wxArrayString names;
+
+    pi->EnumerateSymbolLib( names, getLegacyTestLibrary( "lazy_load.lib" ) );
+
+    const std::vector<wxString> expected = { "+5V", "74HC04", "74HC14", "74LS04", "R" };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( names.begin(), names.end(), expected.begin(),
+                                   expected.end() );
+
+    PROPERTIES props;
+    props[ SYMBOL_LIB_TABLE::PropPowerSymsOnly ] = "";
+
+    wxArrayString powerNames;
+    pi->EnumerateSymbolLib( powerNames, getLegacyTestLibrary( "lazy_load.lib" ), &props );
+
+    BOOST_REQUIRE_EQUAL( powerNames.size(), 1 );
+    BOOST_CHECK_EQUAL( powerNames[0], "+5V" );
+}
+
+
+/**
+ * Check that symbols and aliases parsed on demand are complete, including the information
+ * from the document file.
+ */
+BOOST_AUTO_TEST_CASE( LoadSymbolOnDemand )
+{
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+    const wxString libPath = getLegacyTestLibrary( "lazy_load.lib" );
+
+    LIB_PART* alias = pi->LoadSymbol( libPath, "74HC14" );
+
+    BOOST_REQUIRE( alias != nullptr );
+    BOOST_CHECK( alias->IsAlias() );
+    BOOST_CHECK_EQUAL( alias->GetDescription(), "Hex schmitt trigger inverter" );
+    BOOST_CHECK_EQUAL( alias->GetKeyWords(), "HCMOS not inverter" );
+
+    // The root symbol was parsed along with the alias.
+    LIB_PART* root = pi->LoadSymbol( libPath, "74HC04" );
+
+    BOOST_REQUIRE( root != nullptr );
+    BOOST_CHECK( root->IsRoot() );
+    BOOST_CHECK( alias->GetParent().lock() == root->SharedPtr() );
+    BOOST_CHECK_EQUAL( root->GetUnitCount(), 2 );
+
+    LIB_PINS pins;
+    root->GetPins( pins );
+    BOOST_CHECK_EQUAL( pins.size(), 6 );
+
+    LIB_PART* resistor = pi->LoadSymbol( libPath, "R" );
+
+    BOOST_REQUIRE( resistor != nullptr );
+    BOOST_CHECK_EQUAL( resistor->GetDescription(), "Resistor" );
+    BOOST_CHECK( !resistor->IsPower() );
+
+    BOOST_CHECK( pi->LoadSymbol( libPath, "not_in_library" ) == nullptr );
+
+    // Loading everything must return the same objects already handed out.
+    std::vector<LIB_PART*> symbols;
+    pi->EnumerateSymbolLib( symbols, libPath );
+
+    BOOST_CHECK_EQUAL( symbols.size(), 5 );
+    BOOST_CHECK( std::find( symbols.begin(), symbols.end(), alias ) != symbols.end() );
+    BOOST_CHECK( std::find( symbols.begin(), symbols.end(), root ) != symbols.end() );
+}
+
+
+/**
+ * Check that parsing the sheet files of a hierarchy on worker threads loads the same
+ * hierarchy as parsing them one after the other, including the screens shared by sheets.
+ */
+BOOST_AUTO_TEST_CASE( PrefetchedHierarchyMatchesSerial )
+{
+    KIWAY kiway( &Pgm(), KFCTL_STANDALONE );
+
+    std::unique_ptr<SCH_SHEET> serial = loadHierarchy( kiway, 0 );
+    std::unique_ptr<SCH_SHEET> parallel = loadHierarchy( kiway, 4 );
+
+    BOOST_REQUIRE( serial && parallel );
+
+    const std::vector<std::string> expected = describeHierarchy( serial.get() );
+    const std::vector<std::string> result = describeHierarchy( parallel.get() );
+
+    // The root, left, its shared copy, right, deep, its shared copy and the top shared one.
+    BOOST_CHECK_EQUAL( expected.size(), 7 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( result.begin(), result.end(), expected.begin(),
+                                   expected.end() );
+
+    // shared.sch is used by three sheets, they must all get the same screen.
+    SCH_SCREENS screens( parallel.get() );
+    int         sharedCount = 0;
+
+    for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+    {
+        if( wxFileName( screen->GetFileName() ).GetFullName() == "shared.sch" )
+        {
+            BOOST_CHECK_EQUAL( screen->GetRefCount(), 3 );
+            sharedCount++;
+        }
+    }
+
+    BOOST_CHECK_EQUAL( screens.GetCount(), 5 );
+    BOOST_CHECK_EQUAL( sharedCount, 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_plot_board_layers.cpp
+ * Test suite for plotting board layers on several threads
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/textfile.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <pcb_plot_params.h>
+#include <pcbplot.h>
+
+
+/**
+ * Make a board with many rectangular and trapezoidal pads, on both sides, at several
+ * orientations: these are the shapes plotted through a buffer of corners.
+ */
+static std::unique_ptr<BOARD> makePadsBoard()
+{
+    auto board = std::make_unique<BOARD>();
+
+    for( int mod = 0; mod < 40; mod++ )
+    {
+        auto module = std::make_unique<MODULE>( board.get() );
+
+        for( int ii = 0; ii < 20; ii++ )
+        {
+            auto    pad = std::make_unique<D_PAD>( module.get() );
+            wxPoint pos( Millimeter2iu( ii * 1.5 ), 0 );
+
+            pad->SetName( wxString::Format( "%d", ii + 1 ) );
+            pad->SetPosition( pos );
+            pad->SetPos0( pos );
+            pad->SetSize( wxSize( Millimeter2iu( 1.0 ), Millimeter2iu( 1.8 ) ) );
+
+            if( ii % 2 )
+            {
+                pad->SetShape( PAD_SHAPE_TRAPEZOID );
+                pad->SetDelta( wxSize( 0, Millimeter2iu( 0.3 ) ) );
+            }
+            else
+            {
+                pad->SetShape( PAD_SHAPE_RECT );
+            }
+
+            if( ii % 3 )
+            {
+                pad->SetAttribute( PAD_ATTRIB_SMD );
+                pad->SetLayerSet( D_PAD::SMDMask() );
+            }
+            else
+            {
+                pad->SetAttribute( PAD_ATTRIB_STANDARD );
+                pad->SetLayerSet( D_PAD::StandardMask() );
+                pad->SetDrillSize( wxSize( Millimeter2iu( 0.6 ), Millimeter2iu( 0.6 ) ) );
+            }
+
+            module->Add( pad.release() );
+        }
+
+        module->SetReference( wxString::Format( "U%d", mod + 1 ) );
+        module->SetPosition( wxPoint( Millimeter2iu( 10 + ( mod % 5 ) * 40 ),
+                                      Millimeter2iu( 10 + ( mod / 5 ) * 10 ) ) );
+        module->SetOrientation( ( mod % 8 ) * 450 + 150 );
+
+        if( mod % 2 )
+            module->Flip( module->GetPosition(), false );
+
+        board->Add( module.release() );
+    }
+
+    return board;
+}
+
+
+/**
+ * Read the lines of a plot file, without the ones holding the creation date.
+ */
+static std::vector<wxString> readPlotFile( const wxString& aFileName )
+{
+    std::vector<wxString> lines;
+    wxTextFile            file;
+
+    BOOST_REQUIRE( file.Open( aFileName ) );
+
+    for( size_t ii = 0; ii < file.GetLineCount(); ii++ )
+    {
+        if( !file[ii].Contains( "CreationDate" ) )
+            lines.push_back( file[ii] );
+    }
+
+    return lines;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PlotBoardLayers )
+
+
+/**
+ * Check that plotting a set of layers on several threads gives the same files as plotting
+ * them one after the other.
+ */
+BOOST_AUTO_TEST_CASE( ParallelMatchesSerial )
+{
+    const std::vector<PCB_LAYER_ID> layers = { F_Cu, B_Cu, F_Mask, B_Mask, F_Paste, B_Paste };
+    const unsigned threadCount = 4;
+
+    std::unique_ptr<BOARD> board = makePadsBoard();
+
+    PCB_PLOT_PARAMS plotOpts;
+    plotOpts.SetFormat( PLOT_FORMAT_POST );
+
+    wxString dir = wxFileName::CreateTempFileName( "plot_board_layers" );
+    wxRemoveFile( dir );
+    BOOST_REQUIRE( wxFileName::Mkdir( dir ) );
+
+    auto plot = [&]( unsigned aThreadCount, const wxString& aSuffix )
+    {
+        std::vector<PLOT_LAYER_JOB> jobs;
+
+        for( PCB_LAYER_ID layer : layers )
+        {
+            wxFileName fn( dir, LSET::Name( layer ) + aSuffix, "ps" );
+            jobs.emplace_back( layer, fn.GetFullPath() );
+        }
+
+        BOOST_REQUIRE_EQUAL( PlotBoardLayers( board.get(), &plotOpts, jobs, aThreadCount ),
+                             (int) layers.size() );
+
+        return jobs;
+    };
+
+    std::vector<PLOT_LAYER_JOB> serial = plot( 1, "_serial" );
+
+    // Several runs give the threads more chances to plot the same shapes at the same time.
+    for( int run = 0; run < 4; run++ )
+    {
+        std::vector<PLOT_LAYER_JOB> parallel = plot( threadCount, "_parallel" );
+
+        for( size_t ii = 0; ii < layers.size(); ii++ )
+        {
+            BOOST_TEST_CONTEXT( "Layer " << LSET::Name( layers[ii] ) << ", run " << run )
+            {
+                const std::vector<wxString> expected = readPlotFile( serial[ii].m_FileName );
+                const std::vector<wxString> result = readPlotFile( parallel[ii].m_FileName );
+
+                BOOST_CHECK( result == expected );
+            }
+        }
+    }
+
+    wxFileName::Rmdir( dir, wxPATH_RMDIR_RECURSIVE );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
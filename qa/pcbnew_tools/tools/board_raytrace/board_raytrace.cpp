@@ -0,0 +1,346 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <GL/glew.h>    // Must be included first
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+#include <project.h>
+#include <reporter.h>
+#include <wildcards_and_files_ext.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+#include <wx/imagpng.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+
+#include <3d_canvas/cinfo3d_visu.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+#include <3d_rendering/3d_render_raytracing/shapes3D/cobject.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the progress and rendering information" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "PNG file to write the image to" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "size",
+            _( "image size in pixels, as WIDTHxHEIGHT (default 1600x1200)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "rotate",
+            _( "camera rotation around the X, Y and Z axes in degrees, as X,Y,Z "
+               "(default: top view)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "z",
+            "zoom",
+            _( "zoom factor, 1 shows the whole board (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            nullptr,
+            "ortho",
+            _( "use an orthographic projection instead of the perspective one" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            nullptr,
+            "no-models",
+            _( "do not load the 3D models of the footprints" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "c",
+            "copies",
+            _( "add this number of copies of each footprint having 3D models, to measure "
+               "how the scene grows with repeated models (default 0)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "frames",
+            _( "number of frames to render, and print the timings of (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum RAYTRACE_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    SAVE_FAILED,
+};
+
+
+/**
+ * Add \a aCopies copies of each footprint having 3D models, side by side on its right,
+ * so the same models are placed many times.
+ */
+static void addModelCopies( BOARD& aBoard, long aCopies )
+{
+    std::vector<MODULE*> modules;
+
+    for( MODULE* module : aBoard.Modules() )
+    {
+        if( !module->Models().empty() )
+            modules.push_back( module );
+    }
+
+    for( MODULE* module : modules )
+    {
+        const int step = module->GetFootprintRect().GetWidth();
+
+        for( long ii = 1; ii <= aCopies; ++ii )
+        {
+            MODULE* copy = new MODULE( *module );
+            copy->Move( wxPoint( step * ii, 0 ) );
+            aBoard.Add( copy );
+        }
+    }
+}
+
+
+int raytrace_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program raytraces a PCB file to an image on the CPU, without OpenGL. "
+               "It can render several frames, to measure the raytracing performance." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    wxString text;
+    long     width = 1600;
+    long     height = 1200;
+
+    if( cl_parser.Found( "size", &text )
+            && ( !text.BeforeFirst( 'x' ).ToLong( &width )
+                    || !text.AfterFirst( 'x' ).ToLong( &height ) || width < 1 || height < 1 ) )
+    {
+        std::cerr << "Invalid image size: " << text << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    double rotation[3] = { 0.0, 0.0, 0.0 };
+
+    if( cl_parser.Found( "rotate", &text ) )
+    {
+        wxArrayString angles = wxSplit( text, ',' );
+
+        if( angles.size() != 3 || !angles[0].ToDouble( &rotation[0] )
+                || !angles[1].ToDouble( &rotation[1] ) || !angles[2].ToDouble( &rotation[2] ) )
+        {
+            std::cerr << "Invalid camera rotation: " << text << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+    }
+
+    double zoom = 1.0;
+    cl_parser.Found( "zoom", &zoom );
+
+    long frames = 1;
+    cl_parser.Found( "frames", &frames );
+
+    long copies = 0;
+    cl_parser.Found( "copies", &copies );
+
+    if( zoom <= 0.0 || frames < 1 || copies < 0 )
+    {
+        std::cerr << "The zoom factor and the frame count must be positive" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RAYTRACE_RET_CODES::LOAD_FAILED;
+
+    if( copies > 0 )
+        addModelCopies( *board, copies );
+
+    REPORTER* reporter = verbose ? &STDOUT_REPORTER::GetInstance() : nullptr;
+
+    // The 3D settings, as the 3D viewer defaults
+    CINFO3D_VISU settings;
+
+    settings.SetBoard( board.get() );
+    settings.RenderEngineSet( RENDER_ENGINE_RAYTRACING );
+    settings.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_REFRACTIONS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_REFLECTIONS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, true );
+
+    // The models are found from the board directory, as in a project
+    PROJECT project;
+
+    if( !filename.empty() && !cl_parser.Found( "no-models" ) )
+    {
+        wxFileName projectFile( filename );
+        projectFile.MakeAbsolute();
+        projectFile.SetExt( ProjectFileExtension );
+
+        project.SetProjectFullName( projectFile.GetFullPath() );
+        settings.Set3DCacheManager( project.Get3DCacheManager() );
+    }
+
+    const wxSize size( width, height );
+    CCAMERA&     camera = settings.CameraGet();
+
+    camera.SetCurWindowSize( size );
+    camera.SetProjection( cl_parser.Found( "ortho" ) ? PROJECTION_ORTHO : PROJECTION_PERSPECTIVE );
+    camera.RotateX( glm::radians( rotation[0] ) );
+    camera.RotateY( glm::radians( rotation[1] ) );
+    camera.RotateZ( glm::radians( rotation[2] ) );
+    camera.Zoom( zoom );
+
+    C3D_RENDER_RAYTRACING raytracer( settings );
+
+    PROF_COUNTER sceneTimer;
+    raytracer.PrepareScene( reporter );
+    sceneTimer.Stop();
+
+    // The counters are reset when the scene is built
+    const COBJECT3D_STATS& stats = COBJECT3D_STATS::Instance();
+    unsigned int           objectCount = 0;
+
+    for( unsigned int ii = 0; ii < OBJ3D_MAX; ++ii )
+        objectCount += stats.GetCountOf( (OBJECT3D_TYPE) ii );
+
+    wxImage image;
+    std::vector<double> times;
+
+    for( long ii = 0; ii < frames; ++ii )
+    {
+        PROF_COUNTER timer;
+        image = raytracer.RenderImage( size, reporter );
+        timer.Stop();
+
+        times.push_back( timer.msecs() );
+    }
+
+    if( verbose || frames > 1 )
+    {
+        std::sort( times.begin(), times.end() );
+
+        double total = 0.0;
+
+        for( double time : times )
+            total += time;
+
+        const SFVEC2UI traced = raytracer.GetTracedSize();
+        const double   pixels = (double) traced.x * traced.y;
+
+        printf( "Scene build: %.2f ms, %u objects, %u of them triangles\n", sceneTimer.msecs(),
+                objectCount, stats.GetCountOf( OBJ3D_TRIANGLE ) );
+        printf( "Render: %ld frames, min %.2f ms, median %.2f ms, mean %.2f ms, max %.2f ms\n",
+                frames, times.front(), times[times.size() / 2], total / times.size(),
+                times.back() );
+        printf( "Throughput: %.3f Mpixels/s (%ux%u traced pixels per frame)\n",
+                pixels * frames / total / 1000.0, traced.x, traced.y );
+    }
+
+    if( cl_parser.Found( "output", &text ) )
+    {
+        wxImage::AddHandler( new wxPNGHandler );
+
+        if( !image.SaveFile( text, wxBITMAP_TYPE_PNG ) )
+        {
+            std::cerr << "Could not write the image to " << text << std::endl;
+            return RAYTRACE_RET_CODES::SAVE_FAILED;
+        }
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "raytrace",
+        "Raytrace a PCB to an image, or measure the raytracing time", raytrace_main_func } );
@@ -0,0 +1,343 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <convert_to_biu.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+#include <wx/imagpng.h>
+#include <wx/tokenzr.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <class_marker_pcb.h>
+#include <pcb_view.h>
+#include <pcb_painter.h>
+#include <gal/cairo/cairo_gal.h>
+#include <gal/gal_display_options.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print rendering information" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "PNG file to write the image to" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "size",
+            _( "image size in pixels, as WIDTHxHEIGHT (default 1600x1200)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "l",
+            "layers",
+            _( "comma separated board layers to show, e.g. F.Cu,Edge.Cuts "
+               "(default: the enabled layers)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "c",
+            "center",
+            _( "view center in mm, as X,Y (default: the board center)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "z",
+            "zoom",
+            _( "zoom factor, 1 shows the whole board (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "frames",
+            _( "number of frames to draw, and print the redraw timings of (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum RENDER_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    SAVE_FAILED,
+};
+
+
+/**
+ * Parse a pair of numbers separated by aSeparator, e.g. "1600x1200"
+ */
+static bool parsePair( const wxString& aText, wxChar aSeparator, double& aFirst, double& aSecond )
+{
+    return aText.BeforeFirst( aSeparator ).ToDouble( &aFirst )
+           && aText.AfterFirst( aSeparator ).ToDouble( &aSecond );
+}
+
+
+/**
+ * Add the items of a board to a view, as PCB_DRAW_PANEL_GAL::DisplayBoard() does
+ */
+static void addBoardItems( BOARD& aBoard, KIGFX::VIEW& aView )
+{
+    for( auto drawing : aBoard.Drawings() )
+        aView.Add( drawing );
+
+    for( auto track : aBoard.Tracks() )
+        aView.Add( track );
+
+    for( auto module : aBoard.Modules() )
+        aView.Add( module );
+
+    for( int ii = 0; ii < aBoard.GetMARKERCount(); ++ii )
+        aView.Add( aBoard.GetMARKER( ii ) );
+
+    for( auto zone : aBoard.Zones() )
+        aView.Add( zone );
+}
+
+
+int render_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders a PCB file to an image with the Cairo GAL, without "
+               "a display. It can draw several frames, to measure the drawing performance." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    wxString text;
+    double   width = 1600;
+    double   height = 1200;
+
+    if( cl_parser.Found( "size", &text )
+            && ( !parsePair( text, 'x', width, height ) || width < 1 || height < 1 ) )
+    {
+        std::cerr << "Invalid image size: " << text << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    double zoom = 1.0;
+    cl_parser.Found( "zoom", &zoom );
+
+    long frames = 1;
+    cl_parser.Found( "frames", &frames );
+
+    if( zoom <= 0.0 || frames < 1 )
+    {
+        std::cerr << "The zoom factor and the frame count must be positive" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RENDER_RET_CODES::LOAD_FAILED;
+
+    LSET layers = board->GetEnabledLayers();
+
+    if( cl_parser.Found( "layers", &text ) )
+    {
+        layers.reset();
+
+        wxStringTokenizer tokenizer( text, "," );
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            wxString     name = tokenizer.GetNextToken().Trim().Trim( false );
+            PCB_LAYER_ID layer = board->GetLayerID( name );
+
+            if( layer == UNDEFINED_LAYER )
+            {
+                std::cerr << "Unknown layer: " << name << std::endl;
+                return KI_TEST::RET_CODES::BAD_CMDLINE;
+            }
+
+            layers.set( layer );
+        }
+    }
+
+    // Set up the view as the board editor does, drawing in memory
+    KIGFX::GAL_DISPLAY_OPTIONS options;
+    KIGFX::CAIRO_IMAGE_GAL     gal( options, KiROUND( width ), KiROUND( height ) );
+    KIGFX::PCB_VIEW            view( true );
+    KIGFX::PCB_PAINTER         painter( &gal );
+
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+    view.SetDefaultLayerOrder();
+    view.SetDefaultLayerDeps( false );
+
+    for( LAYER_NUM layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+        view.SetLayerVisible( layer, layers.test( layer ) );
+
+    addBoardItems( *board, view );
+
+    EDA_RECT bbox = board->ComputeBoundingBox();
+
+    // An empty board shows the 100 mm square at the origin
+    if( bbox.GetWidth() <= 0 || bbox.GetHeight() <= 0 )
+        bbox = EDA_RECT( wxPoint( 0, 0 ), wxSize( Millimeter2iu( 100 ), Millimeter2iu( 100 ) ) );
+
+    view.SetViewport( BOX2D( bbox.GetOrigin(), bbox.GetSize() ) );
+    view.SetScale( view.GetScale() * zoom );
+
+    if( cl_parser.Found( "center", &text ) )
+    {
+        double x, y;
+
+        if( !parsePair( text, ',', x, y ) )
+        {
+            std::cerr << "Invalid view center: " << text << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        view.SetCenter( VECTOR2D( Millimeter2iu( x ), Millimeter2iu( y ) ) );
+    }
+
+    PROF_COUNTER updateTimer;
+    view.UpdateItems();
+    updateTimer.Stop();
+
+    KIGFX::RENDER_SETTINGS* settings = painter.GetSettings();
+    std::vector<double> times;
+
+    for( long ii = 0; ii < frames; ++ii )
+    {
+        view.MarkDirty();
+
+        PROF_COUNTER timer;
+
+        {
+            KIGFX::GAL_DRAWING_CONTEXT ctx( &gal );
+
+            gal.SetClearColor( settings->GetBackgroundColor() );
+            gal.ClearScreen();
+            view.ClearTargets();
+            view.Redraw();
+        }
+
+        timer.Stop();
+        times.push_back( timer.msecs() );
+    }
+
+    if( verbose )
+    {
+        std::cout << "Board: " << filename << ", " << board->Modules().size() << " footprints, "
+                  << board->Tracks().size() << " tracks, " << board->Zones().size() << " zones"
+                  << std::endl;
+        std::cout << "Image: " << gal.GetScreenPixelSize().x << "x"
+                  << gal.GetScreenPixelSize().y << ", scale " << view.GetScale() << std::endl;
+    }
+
+    if( verbose || frames > 1 )
+    {
+        std::sort( times.begin(), times.end() );
+
+        double total = 0.0;
+
+        for( double time : times )
+            total += time;
+
+        printf( "Items update: %.2f ms\n", updateTimer.msecs() );
+        printf( "Redraw: %ld frames, min %.2f ms, median %.2f ms, mean %.2f ms, max %.2f ms\n",
+                frames, times.front(), times[times.size() / 2], total / times.size(),
+                times.back() );
+    }
+
+    if( cl_parser.Found( "output", &text ) )
+    {
+        wxImage::AddHandler( new wxPNGHandler );
+
+        if( !gal.GetImage().SaveFile( text, wxBITMAP_TYPE_PNG ) )
+        {
+            std::cerr << "Could not write the image to " << text << std::endl;
+            return RENDER_RET_CODES::SAVE_FAILED;
+        }
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register(
+        { "render", "Render a PCB to an image, or measure the drawing time", render_main_func } );
@@ -0,0 +1,260 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <3d_canvas/cinfo3d_visu.h>
+#include <3d_rendering/ctrack_ball.h>
+#include <3d_rendering/3d_render_raytracing/accelerators/cbvh_pbrt.h>
+#include <3d_rendering/3d_render_raytracing/accelerators/ccontainer.h>
+#include <3d_rendering/3d_render_raytracing/shapes3D/ctriangle.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "t",
+            "triangles",
+            _( "number of triangles of the scene (default 1000000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "builds",
+            _( "number of builds with each thread count, the fastest is kept (default 3)" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "j",
+            "threads",
+            _( "highest thread count to measure (default the number of cores)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum BVH_BENCH_RET_CODES
+{
+    HITS_MISMATCH = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+/**
+ * Small triangles in random places and directions, as the parts of many models
+ */
+static void buildSoup( CCONTAINER& aObjects, int aTriangles, const CMATERIAL* aMaterial )
+{
+    std::mt19937                          rng( 1 );
+    std::uniform_real_distribution<float> position( -RANGE_SCALE_3D / 2.0f,
+                                                    RANGE_SCALE_3D / 2.0f );
+    std::uniform_real_distribution<float> offset( -0.05f, 0.05f );
+
+    for( int i = 0; i < aTriangles; ++i )
+    {
+        const SFVEC3F center( position( rng ), position( rng ), 0.02f * position( rng ) );
+
+        CTRIANGLE* triangle = new CTRIANGLE(
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ),
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ),
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ) );
+
+        triangle->SetMaterial( aMaterial );
+        aObjects.Add( triangle );
+    }
+}
+
+
+/**
+ * Trace one ray per pixel and keep the hit objects, to compare the trees
+ */
+static void traceFrame( const CBVH_PBRT& aAccelerator, const CCAMERA& aCamera,
+                        const wxSize& aSize, std::vector<const COBJECT*>& aObjects )
+{
+    aObjects.clear();
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        for( int x = 0; x < aSize.x; ++x )
+        {
+            SFVEC3F origin, direction;
+            aCamera.MakeRay( SFVEC2I( x, y ), origin, direction );
+
+            RAY ray;
+            ray.Init( origin, direction );
+
+            HITINFO hit;
+            hit.m_tHit = std::numeric_limits<float>::infinity();
+            hit.m_acc_node_info = 0;
+            hit.pHitObject = nullptr;
+
+            aObjects.push_back( aAccelerator.Intersect( ray, hit ) ? hit.pHitObject : nullptr );
+        }
+    }
+}
+
+
+/**
+ * Build the tree with each thread count and print the times
+ * @return false if a tree does not find the same hits as the single thread one
+ */
+static bool benchBuild( const CCONTAINER& aObjects, SPLITMETHOD aSplit,
+                        const std::vector<long>& aThreadCounts, long aBuilds,
+                        const CCAMERA& aCamera, const wxSize& aSize )
+{
+    printf( "%s build of %u triangles\n", aSplit == SPLIT_SAH ? "SAH" : "HLBVH",
+            (unsigned int) aObjects.GetList().size() );
+
+    std::vector<const COBJECT*> refObjects, hitObjects;
+    double                      singleThreadTime = 0.0;
+    bool                        mismatch = false;
+
+    for( long threads : aThreadCounts )
+    {
+        double                     bestTime = std::numeric_limits<double>::max();
+        std::unique_ptr<CBVH_PBRT> accelerator;
+
+        for( long ii = 0; ii < aBuilds; ++ii )
+        {
+            accelerator.reset();
+
+            PROF_COUNTER timer;
+            accelerator.reset( new CBVH_PBRT( aObjects, 4, aSplit, threads ) );
+            timer.Stop();
+
+            bestTime = std::min( bestTime, timer.msecs() );
+        }
+
+        if( threads == 1 )
+            singleThreadTime = bestTime;
+
+        printf( "  %3ld threads: %.2f ms, speedup %.2f", threads, bestTime,
+                singleThreadTime / bestTime );
+
+        traceFrame( *accelerator, aCamera, aSize, hitObjects );
+
+        if( threads == 1 )
+        {
+            refObjects = hitObjects;
+        }
+        else if( hitObjects != refObjects )
+        {
+            printf( ", DIFFERENT hits from the single thread tree" );
+            mismatch = true;
+        }
+
+        printf( "\n" );
+    }
+
+    return !mismatch;
+}
+
+
+int bvh_bench_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program measures the SAH and HLBVH builds of the raytracer with 1 to N "
+               "threads, and checks the trees find the same hits." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long triangles = 1000000;
+    cl_parser.Found( "triangles", &triangles );
+
+    long builds = 3;
+    cl_parser.Found( "builds", &builds );
+
+    long maxThreads = std::max<long>( std::thread::hardware_concurrency(), 1 );
+    cl_parser.Found( "threads", &maxThreads );
+
+    if( triangles < 1 || builds < 1 || maxThreads < 1 )
+    {
+        std::cerr << "The triangle, build and thread counts must be positive" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const wxSize size( 256, 256 );
+
+    CTRACK_BALL camera( RANGE_SCALE_3D );
+    camera.SetCurWindowSize( size );
+
+    CBLINN_PHONG_MATERIAL material;
+    CCONTAINER            objects;
+
+    buildSoup( objects, triangles, &material );
+
+    // 1, 2, 4... threads, and the highest count
+    std::vector<long> threadCounts;
+
+    for( long threads = 1; threads < maxThreads; threads *= 2 )
+        threadCounts.push_back( threads );
+
+    threadCounts.push_back( maxThreads );
+
+    bool mismatch = false;
+
+    for( SPLITMETHOD split : { SPLIT_SAH, SPLIT_HLBVH } )
+        mismatch |= !benchBuild( objects, split, threadCounts, builds, camera, size );
+
+    return mismatch ? BVH_BENCH_RET_CODES::HITS_MISMATCH : KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "bvh_build",
+        "Measure the parallel BVH builds of the raytracer", bvh_bench_main_func } );
@@ -0,0 +1,316 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <3d_canvas/cinfo3d_visu.h>
+#include <3d_rendering/ctrack_ball.h>
+#include <3d_rendering/3d_render_raytracing/accelerators/cbvh_pbrt.h>
+#include <3d_rendering/3d_render_raytracing/accelerators/ccontainer.h>
+#include <3d_rendering/3d_render_raytracing/raypacket_simd.h>
+#include <3d_rendering/3d_render_raytracing/shapes3D/ctriangle.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "size",
+            _( "window size in pixels, as WIDTHxHEIGHT (default 1024x768)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "t",
+            "triangles",
+            _( "approximate number of triangles of each scene (default 100000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "frames",
+            _( "number of frames to trace with each instruction set (default 5)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum RAYPACKET_RET_CODES
+{
+    HITS_MISMATCH = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+/**
+ * A test scene: triangles in the -RANGE_SCALE_3D/2 .. +RANGE_SCALE_3D/2 square, as a board
+ */
+struct SCENE
+{
+    std::string                name;
+    CCONTAINER                 objects;
+    std::unique_ptr<CBVH_PBRT> accelerator;
+};
+
+
+/**
+ * A wavy surface, as the body of a model: coherent rays hitting large triangles
+ */
+static void buildSurface( SCENE& aScene, int aTriangles, const CMATERIAL* aMaterial )
+{
+    const int   n = std::max( 1, (int) std::sqrt( aTriangles / 2.0 ) );
+    const float step = RANGE_SCALE_3D / n;
+
+    auto vertex = [&]( int aX, int aY )
+    {
+        const float x = -RANGE_SCALE_3D / 2.0f + aX * step;
+        const float y = -RANGE_SCALE_3D / 2.0f + aY * step;
+
+        return SFVEC3F( x, y, 0.1f * std::sin( 3.0f * x ) * std::cos( 2.0f * y ) );
+    };
+
+    for( int y = 0; y < n; ++y )
+    {
+        for( int x = 0; x < n; ++x )
+        {
+            CTRIANGLE* a = new CTRIANGLE( vertex( x, y ), vertex( x + 1, y ),
+                                          vertex( x + 1, y + 1 ) );
+            CTRIANGLE* b = new CTRIANGLE( vertex( x, y ), vertex( x + 1, y + 1 ),
+                                          vertex( x, y + 1 ) );
+
+            a->SetMaterial( aMaterial );
+            b->SetMaterial( aMaterial );
+            aScene.objects.Add( a );
+            aScene.objects.Add( b );
+        }
+    }
+}
+
+
+/**
+ * Small triangles in random places and directions, as the parts of many models:
+ * the rays of a packet hit different triangles
+ */
+static void buildSoup( SCENE& aScene, int aTriangles, const CMATERIAL* aMaterial )
+{
+    std::mt19937                          rng( 1 );
+    std::uniform_real_distribution<float> position( -RANGE_SCALE_3D / 2.0f,
+                                                    RANGE_SCALE_3D / 2.0f );
+    std::uniform_real_distribution<float> offset( -0.05f, 0.05f );
+
+    for( int i = 0; i < aTriangles; ++i )
+    {
+        const SFVEC3F center( position( rng ), position( rng ), 0.02f * position( rng ) );
+
+        CTRIANGLE* triangle = new CTRIANGLE(
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ),
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ),
+                center + SFVEC3F( offset( rng ), offset( rng ), offset( rng ) ) );
+
+        triangle->SetMaterial( aMaterial );
+        aScene.objects.Add( triangle );
+    }
+}
+
+
+/**
+ * Trace all the packets of a frame, and keep the hit distances and objects
+ */
+static void traceFrame( const SCENE& aScene, const CCAMERA& aCamera, const wxSize& aSize,
+                        std::vector<float>& aDistances, std::vector<const COBJECT*>& aObjects )
+{
+    aDistances.clear();
+    aObjects.clear();
+
+    for( int y = 0; y < aSize.y; y += RAYPACKET_DIM )
+    {
+        for( int x = 0; x < aSize.x; x += RAYPACKET_DIM )
+        {
+            RAYPACKET      packet( aCamera, SFVEC2I( x, y ) );
+            HITINFO_PACKET hits[RAYPACKET_RAYS_PER_PACKET];
+
+            for( HITINFO_PACKET& hit : hits )
+            {
+                hit.m_hitresult = false;
+                hit.m_HitInfo.m_tHit = std::numeric_limits<float>::infinity();
+                hit.m_HitInfo.m_acc_node_info = 0;
+                hit.m_HitInfo.pHitObject = nullptr;
+            }
+
+            aScene.accelerator->Intersect( packet, hits );
+
+            for( const HITINFO_PACKET& hit : hits )
+            {
+                aDistances.push_back( hit.m_hitresult ? hit.m_HitInfo.m_tHit : 0.0f );
+                aObjects.push_back( hit.m_hitresult ? hit.m_HitInfo.pHitObject : nullptr );
+            }
+        }
+    }
+}
+
+
+int raypacket_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program measures the ray packet traversal of the raytracer, with each "
+               "instruction set supported by the processor, and checks they find the same "
+               "hits." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxString text;
+    long     width = 1024;
+    long     height = 768;
+
+    if( cl_parser.Found( "size", &text )
+            && ( !text.BeforeFirst( 'x' ).ToLong( &width )
+                    || !text.AfterFirst( 'x' ).ToLong( &height ) || width < RAYPACKET_DIM
+                    || height < RAYPACKET_DIM ) )
+    {
+        std::cerr << "Invalid window size: " << text << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long triangles = 100000;
+    cl_parser.Found( "triangles", &triangles );
+
+    long frames = 5;
+    cl_parser.Found( "frames", &frames );
+
+    if( triangles < 1 || frames < 1 )
+    {
+        std::cerr << "The triangle and frame counts must be positive" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    // The window is traced by whole packets
+    const wxSize size( width & RAYPACKET_INVMASK, height & RAYPACKET_INVMASK );
+
+    CTRACK_BALL camera( RANGE_SCALE_3D );
+    camera.SetCurWindowSize( size );
+
+    CBLINN_PHONG_MATERIAL material;
+
+    SCENE scenes[2];
+
+    scenes[0].name = "surface";
+    buildSurface( scenes[0], triangles, &material );
+
+    scenes[1].name = "soup";
+    buildSoup( scenes[1], triangles, &material );
+
+    const RAYPACKET_SIMD_LEVEL supported = RAYPACKET_GetSupportedSimdLevel();
+    const char* levelNames[] = { "scalar", "SSE2", "AVX" };
+
+    bool mismatch = false;
+
+    for( SCENE& scene : scenes )
+    {
+        PROF_COUNTER buildTimer;
+        scene.accelerator.reset( new CBVH_PBRT( scene.objects ) );
+        buildTimer.Stop();
+
+        printf( "Scene %s: %u triangles, BVH build %.2f ms\n", scene.name.c_str(),
+                (unsigned int) scene.objects.GetList().size(), buildTimer.msecs() );
+
+        std::vector<float>          refDistances, distances;
+        std::vector<const COBJECT*> refObjects, objects;
+
+        for( int level = RAYPACKET_SIMD_NONE; level <= supported; ++level )
+        {
+            RAYPACKET_SetSimdLevel( (RAYPACKET_SIMD_LEVEL) level );
+
+            PROF_COUNTER timer;
+
+            for( long ii = 0; ii < frames; ++ii )
+                traceFrame( scene, camera, size, distances, objects );
+
+            timer.Stop();
+
+            const double rays = (double) size.x * size.y * frames;
+            long         hits = 0;
+
+            for( const COBJECT* object : objects )
+                hits += ( object != nullptr );
+
+            printf( "  %-6s: %.3f Mrays/s, %ld of %d rays hit", levelNames[level],
+                    rays / timer.msecs() / 1000.0, hits, size.x * size.y );
+
+            if( level == RAYPACKET_SIMD_NONE )
+            {
+                refDistances = distances;
+                refObjects = objects;
+            }
+            else if( objects != refObjects || distances != refDistances )
+            {
+                printf( ", DIFFERENT from the scalar hits" );
+                mismatch = true;
+            }
+
+            printf( "\n" );
+        }
+    }
+
+    RAYPACKET_SetSimdLevel( supported );
+
+    return mismatch ? RAYPACKET_RET_CODES::HITS_MISMATCH : KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "raypacket",
+        "Measure the ray packet traversal rate of each instruction set", raypacket_main_func } );
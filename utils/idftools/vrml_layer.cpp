@@ -595,6 +595,36 @@ bool VRML_LAYER::AddPolygon( const std::vector< wxRealPoint >& aPolySet, double
 }
 
 
+// copies the contours of another layer, in the same order and with the same windings
+bool VRML_LAYER::AppendLayer( const VRML_LAYER& aLayer )
+{
+    if( fix )
+    {
+        error = "AppendLayer(): no more vertices may be added (Tesselate was previously executed)";
+        return false;
+    }
+
+    if( aLayer.fix )
+    {
+        error = "AppendLayer(): the source layer was already tesselated";
+        return false;
+    }
+
+    for( size_t i = 0; i < aLayer.contours.size(); ++i )
+    {
+        int contour = NewContour( aLayer.pth[i] );
+
+        for( int vidx : *aLayer.contours[i] )
+        {
+            if( !AddVertex( contour, aLayer.vertices[vidx]->x, aLayer.vertices[vidx]->y ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
 // adds an arc to the given center, start point, pen width, and angle (degrees).
 bool VRML_LAYER::AppendArc( double aCenterX, double aCenterY, double aRadius,
                             double aStartAngle, double aAngle, int aContourID )
@@ -324,6 +324,18 @@ public:
     bool AddPolygon( const std::vector< wxRealPoint >& aPolySet,
                                  double aCenterX, double aCenterY, double aAngle );
 
+    /**
+     * Function AppendLayer
+     * copies the contours of another layer into this one; since tesselating renumbers
+     * the vertices of the holes layer, each layer tesselated at the same time as others
+     * needs its own copy of the holes
+     *
+     * @param aLayer is the layer to copy, which must not have been tesselated
+     *
+     * @return bool: true if the operation succeeded
+     */
+    bool AppendLayer( const VRML_LAYER& aLayer );
+
     /**
      * Function Tesselate
      * creates a list of outline vertices as well as the
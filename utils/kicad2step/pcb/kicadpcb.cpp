@@ -83,6 +83,43 @@ static wxString GetKicadConfigPath()
 }
 
 
+/*
+ * The user cache directory, as used by KiCad's 3D model cache:
+ *      Unix: ${XDG_CACHE_HOME}/kicad or ~/.cache/kicad
+ *      Windows: AppData\Local\kicad
+ *      Mac: ~/Library/Caches/kicad
+ */
+static wxString GetKicadCachePath()
+{
+    wxFileName cachepath;
+
+#if defined( __WINDOWS__ )
+    wxStandardPaths::Get().UseAppInfo( wxStandardPaths::AppInfo_None );
+    cachepath.AssignDir( wxStandardPaths::Get().GetUserLocalDataDir() );
+#elif defined( __WXMAC__ )
+    cachepath.AssignDir( wxGetHomeDir() );
+    cachepath.AppendDir( "Library" );
+    cachepath.AppendDir( "Caches" );
+#else
+    wxString envstr;
+
+    if( !wxGetEnv( "XDG_CACHE_HOME", &envstr ) || envstr.IsEmpty() )
+    {
+        cachepath.AssignDir( wxGetHomeDir() );
+        cachepath.AppendDir( ".cache" );
+    }
+    else
+    {
+        cachepath.AssignDir( envstr );
+    }
+#endif
+
+    cachepath.AppendDir( "kicad" );
+
+    return cachepath.GetPath();
+}
+
+
 KICADPCB::KICADPCB()
 {
     wxFileName cfgdir( GetKicadConfigPath(), "" );
@@ -504,9 +541,26 @@ bool KICADPCB::ComposePCB( bool aComposeVirtual )
         m_pcb->AddOutlineSegment( &lcurve );
     }
 
+    // read all the models first; the components then only place them
+    wxFileName cachedir( GetKicadCachePath(), "" );
+    cachedir.AppendDir( "step" );
+
+    if( cachedir.DirExists() || cachedir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        m_pcb->SetModelCacheDir( std::string( cachedir.GetPathWithSep().ToUTF8() ) );
+
+    std::vector< std::string > modelFiles;
+
+    for( auto i : m_modules )
+        i->GetModelFiles( &m_resolver, modelFiles, aComposeVirtual );
+
+    m_pcb->LoadModels( modelFiles );
+
     for( auto i : m_modules )
         i->ComposePCB( m_pcb, &m_resolver, origin, aComposeVirtual );
 
+    // the placed models are copies, the read documents are not needed anymore
+    m_pcb->ReleaseModels();
+
     if( !m_pcb->CreatePCB() )
     {
         std::ostringstream ostr;
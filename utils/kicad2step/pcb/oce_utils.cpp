@@ -22,10 +22,14 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <wx/filefn.h>
 #include <wx/filename.h>
 #include <wx/log.h>
 
@@ -33,6 +37,7 @@
 #include "kicadpad.h"
 #include "streamwrapper.h"
 
+
 #include <IGESCAFControl_Reader.hxx>
 #include <IGESCAFControl_Writer.hxx>
 #include <IGESControl_Controller.hxx>
@@ -42,6 +47,7 @@
 #include <Quantity_Color.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <STEPCAFControl_Writer.hxx>
+#include <STEPControl_Controller.hxx>
 #include <APIHeaderSection_MakeHeader.hxx>
 #include <Standard_Version.hxx>
 #include <TCollection_ExtendedString.hxx>
@@ -76,6 +82,13 @@
 #include <gp_Dir.hxx>
 #include <gp_Pnt.hxx>
 
+// the binary XCAF format can be registered without resource files since OCC 7.2;
+// it keeps the converted models between runs
+#if ( defined OCC_VERSION_HEX ) && ( OCC_VERSION_HEX > 0x070101 )
+#define USE_MODEL_CACHE
+#include <BinXCAFDrivers.hxx>
+#endif
+
 static constexpr double USER_PREC = 1e-4;
 static constexpr double USER_ANGLE_PREC = 1e-6;
 // minimum PCB thickness in mm (2 microns assumes a very thin polyimide film)
@@ -216,9 +229,92 @@ FormatType fileType( const char* aFileName )
 }
 
 
+/* WRL files are preferred for internal rendering,
+ * due to superior material properties, etc.
+ * However they are not suitable for MCAD export.
+ *
+ * Returns the existing replacement files of a .wrl file,
+ * in order of preference.
+ */
+static std::vector< std::string > alternateModels( const std::string& aFileName )
+{
+    wxFileName wrlName( aFileName );
+
+    wxString basePath = wrlName.GetPath();
+    wxString baseName = wrlName.GetName();
+
+    // List of alternate files to look for
+    // Given in order of preference
+    wxArrayString alts;
+
+    // Step files
+    alts.Add( "stp" );
+    alts.Add( "step" );
+    alts.Add( "STP" );
+    alts.Add( "STEP" );
+    alts.Add( "Stp" );
+    alts.Add( "Step" );
+
+    // IGES files
+    alts.Add( "iges" );
+    alts.Add( "IGES" );
+    alts.Add( "igs" );
+    alts.Add( "IGS" );
+
+    //TODO - Other alternative formats?
+
+    std::vector< std::string > altFiles;
+
+    for( const auto& alt : alts )
+    {
+        wxFileName altFile( basePath, baseName + "." + alt );
+
+        if( altFile.IsOk() && altFile.FileExists() )
+            altFiles.push_back( altFile.GetFullPath().ToStdString() );
+    }
+
+    return altFiles;
+}
+
+
+// name of the cache file of a model: a hash of its path, size and modification time,
+// so an edited model is converted again
+static std::string modelCacheName( const std::string& aFileName )
+{
+    wxFileName fname( wxString::FromUTF8Unchecked( aFileName.c_str() ) );
+
+    if( !fname.FileExists() )
+        return std::string();
+
+    std::ostringstream key;
+    key << "kicad2step-1\n" << aFileName << "\n" << fname.GetSize().ToString() << "\n"
+        << fname.GetModificationTime().GetTicks() << "\n" << USER_PREC;
+
+    // 64 bits FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    for( unsigned char c : key.str() )
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    std::ostringstream name;
+    name << std::hex;
+    name.width( 16 );
+    name.fill( '0' );
+    name << hash << ".xbf";
+
+    return name.str();
+}
+
+
 PCBMODEL::PCBMODEL()
 {
     m_app = XCAFApp_Application::GetApplication();
+#ifdef USE_MODEL_CACHE
+    BinXCAFDrivers::DefineFormat( m_app );
+#endif
     m_app->NewDocument( "MDTV-XCAF", m_doc );
     m_assy = XCAFDoc_DocumentTool::ShapeTool ( m_doc->Main() );
     m_assy_label = m_assy->NewShape();
@@ -231,12 +327,25 @@ PCBMODEL::PCBMODEL()
     m_minx = 1.0e10;    // absurdly large number; any valid PCB X value will be smaller
     m_mincurve = m_curves.end();
     BRepBuilderAPI::Precision( 1.0e-6 );
+
+    // The readers share these settings, so they are set once rather than by each
+    // read, which may run in parallel with the others
+    IGESControl_Controller::Init();
+    STEPControl_Controller::Init();
+
+    // Enable user-defined shape precision
+    Interface_Static::SetIVal( "read.precision.mode", 1 );
+
+    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
+    Interface_Static::SetRVal( "read.precision.val", USER_PREC );
+
     return;
 }
 
 
 PCBMODEL::~PCBMODEL()
 {
+    ReleaseModels();
     m_doc->Close();
     return;
 }
@@ -924,93 +1033,43 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
     aLabel.Nullify();
 
     Handle( TDocStd_Document )  doc;
-    m_app->NewDocument( "MDTV-XCAF", doc );
 
     FormatType modelFmt = fileType( aFileName.c_str() );
 
     switch( modelFmt )
     {
         case FMT_IGES:
-            if( !readIGES( doc, aFileName.c_str() ) )
-            {
-                std::ostringstream ostr;
-#ifdef DEBUG
-                ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
-#endif /* DEBUG */
-                ostr << "  * readIGES() failed on filename '" << aFileName << "'\n";
-                wxLogMessage( "%s", ostr.str().c_str() );
-                return false;
-            }
-            break;
-
         case FMT_STEP:
-            if( !readSTEP( doc, aFileName.c_str() ) )
+            if( !getModelDoc( aFileName, doc ) )
             {
                 std::ostringstream ostr;
 #ifdef DEBUG
                 ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
 #endif /* DEBUG */
-                ostr << "  * readSTEP() failed on filename '" << aFileName << "'\n";
+                ostr << "  * " << ( modelFmt == FMT_IGES ? "readIGES()" : "readSTEP()" )
+                     << " failed on filename '" << aFileName << "'\n";
                 wxLogMessage( "%s", ostr.str().c_str() );
                 return false;
             }
             break;
 
         case FMT_WRL:
-            /* WRL files are preferred for internal rendering,
-             * due to superior material properties, etc.
-             * However they are not suitable for MCAD export.
-             *
-             * If a .wrl file is specified, attempt to locate
+            /* If a .wrl file is specified, attempt to locate
              * a replacement file for it.
              *
              * If a valid replacement file is found, the label
              * for THAT file will be associated with the .wrl file
-             *
              */
+            for( const std::string& altFileName : alternateModels( aFileName ) )
             {
-                wxFileName wrlName( aFileName );
-
-                wxString basePath = wrlName.GetPath();
-                wxString baseName = wrlName.GetName();
-
-                // List of alternate files to look for
-                // Given in order of preference
-                // (Break if match is found)
-                wxArrayString alts;
-
-                // Step files
-                alts.Add( "stp" );
-                alts.Add( "step" );
-                alts.Add( "STP" );
-                alts.Add( "STEP" );
-                alts.Add( "Stp" );
-                alts.Add( "Step" );
-
-                // IGES files
-                alts.Add( "iges" );
-                alts.Add( "IGES" );
-                alts.Add( "igs" );
-                alts.Add( "IGS" );
-
-                //TODO - Other alternative formats?
-
-                for( const auto& alt : alts )
+                if( getModelLabel( altFileName, aScale, aLabel ) )
                 {
-                    wxFileName altFile( basePath, baseName + "." + alt );
-
-                    if( altFile.IsOk() && altFile.FileExists() )
-                    {
-                        std::string altFileName = altFile.GetFullPath().ToStdString();
-
-                        if( getModelLabel( altFileName, aScale, aLabel ) )
-                        {
-                            return true;
-                        }
-                    }
+                    return true;
                 }
             }
 
+            // without a replacement the model is exported as an empty part
+            m_app->NewDocument( "MDTV-XCAF", doc );
             break;
 
         // TODO: implement IDF and EMN converters
@@ -1045,6 +1104,172 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_L
 }
 
 
+void PCBMODEL::LoadModels( const std::vector< std::string >& aFileNames )
+{
+    // each STEP or IGES file is read once, whatever the number of its instances;
+    // a .wrl file is replaced by its preferred alternate, as in getModelLabel()
+    std::vector< std::string > toRead;
+    std::set< std::string > seen;
+
+    for( const std::string& fileName : aFileNames )
+    {
+        if( fileName.empty() || !seen.insert( fileName ).second )
+            continue;
+
+        // missing files are reported by AddComponent()
+        if( !wxFileName::FileExists( wxString::FromUTF8Unchecked( fileName.c_str() ) ) )
+            continue;
+
+        std::string modelFile = fileName;
+
+        if( fileType( fileName.c_str() ) == FMT_WRL )
+        {
+            std::vector< std::string > altFiles = alternateModels( fileName );
+
+            if( altFiles.empty() )
+                continue;
+
+            modelFile = altFiles.front();
+
+            if( fileName != modelFile && !seen.insert( modelFile ).second )
+                continue;
+        }
+
+        if( m_sources.find( modelFile ) == m_sources.end() )
+            toRead.push_back( modelFile );
+    }
+
+    // the STEP and IGES readers are not documented as thread safe, so the files are
+    // read one after the other; the time goes in parsing them, which the cache saves
+    auto   start = std::chrono::steady_clock::now();
+    size_t cached = 0;
+
+    for( const std::string& modelFile : toRead )
+    {
+        Handle( TDocStd_Document ) doc;
+        bool fromCache = false;
+
+        if( !readModel( modelFile, doc, fromCache ) )
+            doc.Nullify();
+        else if( fromCache )
+            ++cached;
+
+        // the failed reads are kept too, so they are not tried again for each instance
+        m_sources[ modelFile ] = doc;
+    }
+
+    std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+
+    wxLogMessage( "Read %lu model files (%lu from the cache) in %.1f s\n",
+                  (unsigned long) toRead.size(), (unsigned long) cached, elapsed.count() );
+}
+
+
+void PCBMODEL::ReleaseModels()
+{
+    for( auto& source : m_sources )
+    {
+        if( !source.second.IsNull() )
+            source.second->Close();
+    }
+
+    m_sources.clear();
+}
+
+
+bool PCBMODEL::getModelDoc( const std::string& aFileName, Handle( TDocStd_Document )& aDoc )
+{
+    SOURCE_MAP::const_iterator source = m_sources.find( aFileName );
+
+    if( source != m_sources.end() )
+    {
+        aDoc = source->second;
+        return !aDoc.IsNull();
+    }
+
+    bool fromCache;
+
+    if( !readModel( aFileName, aDoc, fromCache ) )
+        aDoc.Nullify();
+
+    m_sources[ aFileName ] = aDoc;
+    return !aDoc.IsNull();
+}
+
+
+bool PCBMODEL::readModel( const std::string& aFileName, Handle( TDocStd_Document )& aDoc,
+                          bool& aFromCache )
+{
+    std::string cacheFile;
+
+    aFromCache = false;
+
+#ifdef USE_MODEL_CACHE
+    if( !m_cacheDir.empty() )
+    {
+        std::string cacheName = modelCacheName( aFileName );
+
+        if( !cacheName.empty() )
+            cacheFile = m_cacheDir + cacheName;
+    }
+
+    if( !cacheFile.empty() && wxFileName::FileExists( wxString::FromUTF8( cacheFile.c_str() ) ) )
+    {
+        if( m_app->Open( TCollection_ExtendedString( cacheFile.c_str(), Standard_True ),
+                         aDoc ) == PCDM_RS_OK )
+        {
+            aFromCache = true;
+            return true;
+        }
+
+        // an unreadable cache file is replaced below
+        aDoc.Nullify();
+    }
+
+    const char* docFormat = "BinXCAF";
+#else
+    const char* docFormat = "MDTV-XCAF";
+#endif
+
+    m_app->NewDocument( docFormat, aDoc );
+
+    switch( fileType( aFileName.c_str() ) )
+    {
+        case FMT_IGES:
+            if( !readIGES( aDoc, aFileName.c_str() ) )
+                return false;
+            break;
+
+        case FMT_STEP:
+            if( !readSTEP( aDoc, aFileName.c_str() ) )
+                return false;
+            break;
+
+        default:
+            return false;
+    }
+
+    if( !cacheFile.empty() )
+    {
+        // written under another name first, so no other run reads a partial file
+        wxString cacheName = wxString::FromUTF8( cacheFile.c_str() );
+        wxString tmpName = cacheName + ".tmp";
+
+        if( m_app->SaveAs( aDoc, TCollection_ExtendedString( tmpName.ToUTF8(), Standard_True ) )
+                == PCDM_SS_OK )
+        {
+            wxRenameFile( tmpName, cacheName, true );
+        }
+        else
+        {
+            wxRemoveFile( tmpName );
+        }
+    }
+
+    return true;
+}
+
+
 bool PCBMODEL::getModelLocation( bool aBottom, DOUBLET aPosition, double aRotation,
     TRIPLET aOffset, TRIPLET aOrientation, TopLoc_Location& aLocation )
 {
@@ -1101,23 +1326,15 @@ bool PCBMODEL::getModelLocation( bool aBottom, DOUBLET aPosition, double aRotati
 }
 
 
+// the precision of the readers is set in the constructor
 bool PCBMODEL::readIGES( Handle( TDocStd_Document )& doc, const char* fname )
 {
-    IGESControl_Controller::Init();
     IGESCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use IGES label names
@@ -1148,14 +1365,6 @@ bool PCBMODEL::readSTEP( Handle(TDocStd_Document)& doc, const char* fname )
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use label names
@@ -43,6 +43,7 @@
 
 typedef std::pair< std::string, TDF_Label > MODEL_DATUM;
 typedef std::map< std::string, TDF_Label > MODEL_MAP;
+typedef std::map< std::string, Handle( TDocStd_Document ) > SOURCE_MAP;
 
 class KICADPAD;
 
@@ -88,6 +89,8 @@ class PCBMODEL
     bool                            m_hasPCB;       // set true if CreatePCB() has been invoked
     TDF_Label                       m_pcb_label;    // label for the PCB model
     MODEL_MAP                       m_models;       // map of file names to model labels
+    SOURCE_MAP                      m_sources;      // map of file names to read model documents
+    std::string                     m_cacheDir;     // directory of the converted models cache
     int                             m_components;   // number of successfully loaded components;
     double                          m_precision;    // model (length unit) numeric precision
     double                          m_angleprec;    // angle numeric precision
@@ -101,6 +104,13 @@ class PCBMODEL
 
     bool getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_Label& aLabel );
 
+    // get the document of a STEP or IGES file, read once for all its scales
+    bool getModelDoc( const std::string& aFileName, Handle( TDocStd_Document )& aDoc );
+
+    // read a STEP or IGES file, or its converted copy from the cache
+    bool readModel( const std::string& aFileName, Handle( TDocStd_Document )& aDoc,
+        bool& aFromCache );
+
     bool getModelLocation( bool aBottom, DOUBLET aPosition, double aRotation,
         TRIPLET aOffset, TRIPLET aOrientation, TopLoc_Location& aLocation );
 
@@ -120,6 +130,19 @@ public:
     // add a pad hole or slot (must be in final position)
     bool AddPadHole( KICADPAD* aPad );
 
+    // set the directory where converted models are kept between runs; empty to disable
+    void SetModelCacheDir( const std::string& aDirectory )
+    {
+        m_cacheDir = aDirectory;
+    }
+
+    // read the given model files ahead of the AddComponent() calls, each file once
+    void LoadModels( const std::vector< std::string >& aFileNames );
+
+    // close the read model documents once all the components are added; they are
+    // all kept open until then, since any component may use any of them
+    void ReleaseModels();
+
     // add a component at the given position and orientation
     bool AddComponent( const std::string& aFileName, const std::string& aRefDes,
         bool aBottom, DOUBLET aPosition, double aRotation,